@@ -0,0 +1,87 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <ranges>
+#include <type_traits>
+
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/layout_descriptor.hpp>
+
+namespace dplx::dp
+{
+
+enum class column_encoding
+{
+    // each column is an array of CBOR items
+    array,
+    // columns of integers and floating point numbers are encoded as typed
+    // arrays (RFC 8746) in host byte order, all other columns as arrays
+    typed_array,
+};
+
+template <typename T>
+concept columnar_record = packable_tuple<T> || packable_object<T>;
+
+// encodes a range of records described by a tuple_def or object_def with one
+// array per property instead of one array/map per record:
+//     [version?, [r0.p0, r1.p0, ...], [r0.p1, r1.p1, ...], ...]
+// The properties are encoded in declaration order, i.e. neither per record
+// heads nor property ids are written. The decoder accepts both column
+// encodings.
+template <std::ranges::range Container,
+          column_encoding Encoding = column_encoding::array>
+    requires columnar_record<std::ranges::range_value_t<Container>>
+struct columnar final
+{
+    using container_type = Container;
+    using record_type = std::ranges::range_value_t<Container>;
+    static constexpr column_encoding encoding = Encoding;
+
+    container_type records;
+};
+
+namespace detail
+{
+
+template <typename T>
+concept typed_array_element = integer<T> || iec559_floating_point<T>;
+
+// the typed array tag layout is 0b010'fsell with f(loat), s(igned),
+// e(ndianness, 1 = little) and ll = log2(size) (or log2(size) - 1 for floats)
+template <typed_array_element T>
+constexpr auto typed_array_tag(std::endian const order) noexcept
+        -> std::uint64_t
+{
+    constexpr unsigned log2Size = std::bit_width(sizeof(T)) - 1u;
+
+    std::uint64_t tag = 0b010'00000u;
+    if constexpr (iec559_floating_point<T>)
+    {
+        tag |= 0b1'0000u | (log2Size - 1u);
+    }
+    else
+    {
+        tag |= (std::is_signed_v<T> ? 0b1000u : 0u) | log2Size;
+    }
+    // the endianness bit of single byte integers denotes clamped uint8
+    if (sizeof(T) > 1u && order == std::endian::little)
+    {
+        tag |= 0b100u;
+    }
+    return tag;
+}
+
+inline constexpr std::size_t typed_array_chunk_size = 256u;
+
+} // namespace detail
+
+} // namespace dplx::dp
@@ -0,0 +1,104 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+#include <concepts>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <dplx/dp/customization.hpp>
+#include <dplx/dp/detail/mp_for_dots.hpp>
+#include <dplx/dp/disappointment.hpp>
+
+namespace dplx::dp
+{
+
+// a struct of arrays representation of an array of tuples, i.e. the I-th
+// element of each tuple is stored in the I-th column. It is encoded as an
+// array of arrays with one array per row ([[c0[0], c1[0]], [c0[1], c1[1]]])
+// and decoding scatters the tuple elements directly into the columns.
+//
+// The columns are either owned, e.g. columns<std::vector<int>, ...>, or
+// referenced, see as_columns().
+template <typename... Columns>
+    requires(sizeof...(Columns) > 0u)
+class columns
+{
+    std::tuple<Columns...> mColumns;
+
+public:
+    static constexpr std::size_t num_columns = sizeof...(Columns);
+
+    template <std::size_t I>
+    using column_type = std::remove_reference_t<
+            std::tuple_element_t<I, std::tuple<Columns...>>>;
+
+    columns() requires(std::default_initializable<Columns> &&...)
+    = default;
+    explicit constexpr columns(Columns... cs)
+        : mColumns(static_cast<Columns &&>(cs)...)
+    {
+    }
+
+    template <std::size_t I>
+    [[nodiscard]] constexpr auto column() noexcept -> column_type<I> &
+    {
+        return std::get<I>(mColumns);
+    }
+    template <std::size_t I>
+    [[nodiscard]] constexpr auto column() const noexcept
+            -> column_type<I> const &
+    {
+        return std::get<I>(mColumns);
+    }
+
+    // the number of rows, i.e. the size of the first column
+    [[nodiscard]] constexpr auto size() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(
+                std::ranges::size(std::get<0>(mColumns)));
+    }
+
+    void clear() noexcept
+    {
+        std::apply([](auto &...cs) { (cs.clear(), ...); }, mColumns);
+    }
+
+    // reserves all columns at once, e.g. from the length of a decoded array
+    friend inline auto tag_invoke(container_reserve_fn,
+                                  columns &self,
+                                  std::size_t const numRows) noexcept
+            -> result<void>
+    {
+        return detail::mp_for_dots<num_columns>(
+                [&self, numRows](auto const i) -> result<void> {
+                    auto &column = self.template column<decltype(i)::value>();
+                    if constexpr (nothrow_tag_invocable<container_reserve_fn,
+                                                        decltype(column),
+                                                        std::size_t const>)
+                    {
+                        return dp::container_reserve(column, numRows);
+                    }
+                    else
+                    {
+                        return oc::success();
+                    }
+                });
+    }
+};
+
+template <typename... Columns>
+constexpr auto as_columns(Columns &...cs) noexcept -> columns<Columns &...>
+{
+    return columns<Columns &...>(cs...);
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,265 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/disappointment.hpp>
+
+namespace dplx::dp
+{
+
+// the compressed sequences are encoded as a tagged byte string:
+//     tag(bstr(varint(count), payload...))
+// The tag numbers lie in the first come first served range, but haven't
+// been registered with IANA.
+inline constexpr std::uint64_t delta_sequence_tag = 0x6470'0001u;
+inline constexpr std::uint64_t delta_of_delta_sequence_tag = 0x6470'0002u;
+inline constexpr std::uint64_t xor_sequence_tag = 0x6470'0003u;
+
+// each element is encoded as the zigzag varint of its difference to the
+// previous element, i.e. monotonic sequences like ids need 1-2 bytes per
+// element.
+template <std::ranges::random_access_range Container>
+    requires integer<std::ranges::range_value_t<Container>>
+struct delta_encoded final
+{
+    using container_type = Container;
+    static constexpr std::uint64_t tag = delta_sequence_tag;
+
+    container_type values;
+};
+
+template <typename Container>
+delta_encoded(Container) -> delta_encoded<Container>;
+
+// each element is encoded as the zigzag varint of the difference between its
+// delta and the previous delta, i.e. regular time stamps need 1 byte per
+// element.
+template <std::ranges::random_access_range Container>
+    requires integer<std::ranges::range_value_t<Container>>
+struct delta_of_delta_encoded final
+{
+    using container_type = Container;
+    static constexpr std::uint64_t tag = delta_of_delta_sequence_tag;
+
+    container_type values;
+};
+
+template <typename Container>
+delta_of_delta_encoded(Container) -> delta_of_delta_encoded<Container>;
+
+// Gorilla style compression of floating point series: each element is xor'd
+// with its predecessor and only the meaningful bits of the result are
+// written into an MSB first bit stream.
+template <std::ranges::random_access_range Container>
+    requires iec559_floating_point<std::ranges::range_value_t<Container>>
+struct xor_encoded final
+{
+    using container_type = Container;
+    static constexpr std::uint64_t tag = xor_sequence_tag;
+
+    container_type values;
+};
+
+template <typename Container>
+xor_encoded(Container) -> xor_encoded<Container>;
+
+namespace detail
+{
+
+inline constexpr std::size_t max_varint_size = 10u;
+
+constexpr auto varint_size(std::uint64_t const value) noexcept -> std::size_t
+{
+    return (static_cast<std::size_t>(std::bit_width(value | 1u)) + 6u) / 7u;
+}
+
+// the deltas are computed modulo 2^64 and interpreted as two's complement
+constexpr auto zigzag_encode(std::uint64_t const value) noexcept
+        -> std::uint64_t
+{
+    return (value << 1) ^ (std::uint64_t{} - (value >> 63));
+}
+constexpr auto zigzag_decode(std::uint64_t const value) noexcept
+        -> std::uint64_t
+{
+    return (value >> 1) ^ (std::uint64_t{} - (value & 1u));
+}
+
+template <integer T>
+constexpr auto sequence_bits(T const value) noexcept -> std::uint64_t
+{
+    // sign extends negative values
+    return static_cast<std::uint64_t>(value);
+}
+template <integer T>
+constexpr auto sequence_value(std::uint64_t const bits) noexcept -> result<T>
+{
+    if constexpr (std::is_signed_v<T>)
+    {
+        auto const value = static_cast<std::int64_t>(bits);
+        if (!std::in_range<T>(value))
+        {
+            return errc::item_value_out_of_range;
+        }
+        return static_cast<T>(value);
+    }
+    else
+    {
+        if (!std::in_range<T>(bits))
+        {
+            return errc::item_value_out_of_range;
+        }
+        return static_cast<T>(bits);
+    }
+}
+
+// invokes fn with the zigzag encoded differences of the given order
+template <unsigned Order, typename Range, typename Fn>
+constexpr auto for_each_delta(Range const &values, Fn &&fn) -> result<void>
+{
+    static_assert(Order == 1u || Order == 2u);
+
+    std::uint64_t previous = 0u;
+    std::uint64_t previousDelta = 0u;
+    for (auto const value : values)
+    {
+        auto const bits = detail::sequence_bits(value);
+        auto const delta = bits - previous;
+        previous = bits;
+
+        if constexpr (Order == 1u)
+        {
+            DPLX_TRY(fn(detail::zigzag_encode(delta)));
+        }
+        else
+        {
+            DPLX_TRY(fn(detail::zigzag_encode(delta - previousDelta)));
+            previousDelta = delta;
+        }
+    }
+    return oc::success();
+}
+
+template <typename T>
+using xor_bits_t = std::conditional_t<sizeof(T) == sizeof(std::uint32_t),
+                                      std::uint32_t,
+                                      std::uint64_t>;
+
+inline constexpr unsigned xor_leading_zeros_width = 5u;
+inline constexpr unsigned xor_meaningful_width = 6u;
+
+// invokes fn(bits, numBits) for each bit field of the xor encoding:
+// - the first value is stored verbatim
+// - '0' if the value equals its predecessor
+// - '10' followed by the meaningful bits if they fit into the window of the
+//   previous xor value
+// - '11' followed by the number of leading zeros (5 bits), the number of
+//   meaningful bits minus one (6 bits) and the meaningful bits
+template <typename Range, typename Fn>
+constexpr auto for_each_xor_field(Range const &values, Fn &&fn) -> result<void>
+{
+    using value_type = std::ranges::range_value_t<Range>;
+    using bits_type = xor_bits_t<value_type>;
+    constexpr unsigned width = std::numeric_limits<bits_type>::digits;
+    constexpr unsigned maxLeadingZeros
+            = (1u << xor_leading_zeros_width) - 1u;
+
+    bool first = true;
+    bits_type previous = 0u;
+    unsigned windowLeading = width;
+    unsigned windowTrailing = 0u;
+    for (auto const value : values)
+    {
+        auto const bits = std::bit_cast<bits_type>(value);
+        if (first)
+        {
+            first = false;
+            previous = bits;
+            DPLX_TRY(fn(bits, width));
+            continue;
+        }
+
+        auto const diff = static_cast<bits_type>(bits ^ previous);
+        previous = bits;
+        if (diff == 0u)
+        {
+            DPLX_TRY(fn(0u, 1u));
+            continue;
+        }
+
+        auto const leading = std::min(
+                static_cast<unsigned>(std::countl_zero(diff)),
+                maxLeadingZeros);
+        auto const trailing = static_cast<unsigned>(std::countr_zero(diff));
+        auto const meaningful = width - leading - trailing;
+        auto const windowSize = width - windowLeading - windowTrailing;
+        // a new window is started if the previous one is too wide, i.e. an
+        // outlier doesn't inflate the encoding of the following values
+        if (windowLeading < width && leading >= windowLeading
+            && trailing >= windowTrailing
+            && windowSize <= meaningful + xor_leading_zeros_width
+                                     + xor_meaningful_width)
+        {
+            DPLX_TRY(fn(0b10u, 2u));
+            DPLX_TRY(fn(diff >> windowTrailing, windowSize));
+        }
+        else
+        {
+            DPLX_TRY(fn(0b11u, 2u));
+            DPLX_TRY(fn(leading, xor_leading_zeros_width));
+            DPLX_TRY(fn(meaningful - 1u, xor_meaningful_width));
+            DPLX_TRY(fn(diff >> trailing, meaningful));
+
+            windowLeading = leading;
+            windowTrailing = trailing;
+        }
+    }
+    return oc::success();
+}
+
+// the number of payload bytes following the element count
+template <typename T>
+constexpr auto compressed_payload_size(T const &value) -> std::uint64_t
+{
+    std::uint64_t size = 0u;
+    if constexpr (T::tag == xor_sequence_tag)
+    {
+        (void)detail::for_each_xor_field(
+                value.values,
+                [&size](std::uint64_t, unsigned const numBits)
+                        -> result<void> {
+                    size += numBits;
+                    return oc::success();
+                });
+        size = (size + 7u) / 8u;
+    }
+    else
+    {
+        constexpr unsigned order = T::tag == delta_sequence_tag ? 1u : 2u;
+        (void)detail::for_each_delta<order>(
+                value.values, [&size](std::uint64_t const v) -> result<void> {
+                    size += detail::varint_size(v);
+                    return oc::success();
+                });
+    }
+    return size;
+}
+
+} // namespace detail
+
+} // namespace dplx::dp
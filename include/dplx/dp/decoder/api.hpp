@@ -8,6 +8,7 @@
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 #include <dplx/dp/concepts.hpp>
 #include <dplx/dp/disappointment.hpp>
@@ -41,4 +42,29 @@ inline constexpr struct decode_fn final
 
 } decode{};
 
+// decodes the value like decode() but rewinds the stream to where it was
+// before if the decoder fails, i.e. another type or schema version can be
+// tried without buffering the item. dest may still have been modified; values
+// it refers to which have been allocated from a stream state (e.g. a
+// value_arena) are invalidated by rewinding.
+inline constexpr struct try_decode_fn final
+{
+    template <typename T, rewindable_input_stream Stream>
+        requires decodable<T, Stream>
+    inline auto operator()(Stream &inStream, T &dest) const -> result<void>
+    {
+        DPLX_TRY(checkpoint_t<Stream> const cp, dp::checkpoint(inStream));
+        auto decodeRx = basic_decoder<T, Stream>()(inStream, dest);
+        if (decodeRx.has_failure())
+        {
+            // the decoding failure is reported even if the stream couldn't
+            // be rewound in which case its read position is unspecified
+            (void)dp::rewind(inStream, cp);
+            return oc::try_operation_return_as(std::move(decodeRx));
+        }
+        return success();
+    }
+
+} try_decode{};
+
 } // namespace dplx::dp
@@ -0,0 +1,214 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <ranges>
+
+#include <boost/endian/conversion.hpp>
+
+#include <dplx/dp/columnar.hpp>
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/customization.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/layout_descriptor.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp
+{
+
+// the first column determines the number of records, i.e. the container is
+// resized once and the remaining columns must have the same length. Typed
+// arrays are accepted in either byte order regardless of Encoding.
+template <typename Container, column_encoding Encoding, input_stream Stream>
+    requires(std::ranges::forward_range<Container> && tag_invocable<
+                     container_resize_fn, Container &, std::size_t const>)
+class basic_decoder<columnar<Container, Encoding>, Stream>
+{
+    using record_type = std::ranges::range_value_t<Container>;
+
+    static constexpr auto const &descriptor
+            = layout_descriptor_for_v<record_type>;
+    static constexpr bool isVersioned = descriptor.version != null_def_version;
+
+public:
+    using value_type = columnar<Container, Encoding>;
+
+    auto operator()(Stream &inStream, value_type &value) const -> result<void>
+    {
+        DPLX_TRY(auto const headInfo,
+                 dp::parse_tuple_head(inStream,
+                                      std::bool_constant<isVersioned>{}));
+        if constexpr (isVersioned)
+        {
+            if (headInfo.version != descriptor.version)
+            {
+                return errc::item_version_mismatch;
+            }
+        }
+        if (headInfo.num_properties != descriptor.num_properties)
+        {
+            return errc::tuple_size_mismatch;
+        }
+
+        bool sized = false;
+        return descriptor.mp_for_dots(
+                [&inStream, &value, &sized](auto const &propertyDef) {
+                    return decode_column(inStream, value.records, sized,
+                                         propertyDef);
+                });
+    }
+
+private:
+    template <typename PropDefType>
+    static auto decode_column(Stream &inStream,
+                              Container &records,
+                              bool &sized,
+                              PropDefType const &propertyDef) -> result<void>
+    {
+        using property_type = typename PropDefType::value_type;
+
+        DPLX_TRY(dp::item_info const item, detail::parse_item(inStream));
+        if constexpr (detail::typed_array_element<property_type>)
+        {
+            if (item.type == type_code::tag)
+            {
+                return decode_typed_array(inStream, records, sized, item,
+                                          propertyDef);
+            }
+        }
+
+        if (item.type != type_code::array)
+        {
+            return errc::item_type_mismatch;
+        }
+        if (item.indefinite())
+        {
+            return errc::indefinite_item;
+        }
+        // each element occupies at least one byte
+        DPLX_TRY(size_records(inStream, records, sized, item.value,
+                              item.value));
+
+        using property_decoder = basic_decoder<property_type, Stream>;
+        for (auto &record : records)
+        {
+            DPLX_TRY(property_decoder()(inStream, propertyDef.access(record)));
+        }
+        return oc::success();
+    }
+
+    template <typename PropDefType>
+    static auto decode_typed_array(Stream &inStream,
+                                   Container &records,
+                                   bool &sized,
+                                   dp::item_info const &tagItem,
+                                   PropDefType const &propertyDef)
+            -> result<void>
+    {
+        using property_type = typename PropDefType::value_type;
+        constexpr std::size_t elementSize = sizeof(property_type);
+
+        bool littleEndian;
+        if (tagItem.value
+            == detail::typed_array_tag<property_type>(std::endian::little))
+        {
+            littleEndian = true;
+        }
+        else if (tagItem.value
+                 == detail::typed_array_tag<property_type>(std::endian::big))
+        {
+            littleEndian = false;
+        }
+        else
+        {
+            return errc::item_type_mismatch;
+        }
+
+        DPLX_TRY(dp::item_info const bytes, detail::parse_item(inStream));
+        if (bytes.type != type_code::binary || bytes.indefinite())
+        {
+            return errc::item_type_mismatch;
+        }
+        if (bytes.value % elementSize != 0u)
+        {
+            return errc::item_value_out_of_range;
+        }
+        DPLX_TRY(size_records(inStream, records, sized,
+                              bytes.value / elementSize, bytes.value));
+
+        constexpr std::size_t chunkSize
+                = detail::typed_array_chunk_size / elementSize * elementSize;
+        std::byte chunk[chunkSize];
+
+        auto it = std::ranges::begin(records);
+        auto remaining = static_cast<std::size_t>(bytes.value);
+        while (remaining > 0u)
+        {
+            auto const readSize = std::min(remaining, chunkSize);
+            DPLX_TRY(dp::read(inStream, chunk, readSize));
+            remaining -= readSize;
+
+            auto const *const src
+                    = reinterpret_cast<unsigned char const *>(chunk);
+            for (std::size_t offset = 0u; offset < readSize;
+                 offset += elementSize, ++it)
+            {
+                propertyDef.access(*it)
+                        = littleEndian
+                                ? boost::endian::endian_load<
+                                        property_type, elementSize,
+                                        boost::endian::order::little>(
+                                        src + offset)
+                                : boost::endian::endian_load<
+                                        property_type, elementSize,
+                                        boost::endian::order::big>(src
+                                                                   + offset);
+            }
+        }
+        return oc::success();
+    }
+
+    static auto size_records(Stream &inStream,
+                             Container &records,
+                             bool &sized,
+                             std::uint64_t const numRecords,
+                             std::uint64_t const minEncodedSize)
+            -> result<void>
+    {
+        if (sized)
+        {
+            if (static_cast<std::uint64_t>(std::ranges::distance(records))
+                != numRecords)
+            {
+                return errc::tuple_size_mismatch;
+            }
+            return oc::success();
+        }
+
+        DPLX_TRY(auto const availableBytes, dp::available_input_size(inStream));
+        if (availableBytes < minEncodedSize)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::missing_data;
+            }
+        DPLX_TRY(dp::container_resize(records,
+                                      static_cast<std::size_t>(numRecords)));
+        sized = true;
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
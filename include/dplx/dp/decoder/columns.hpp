@@ -0,0 +1,80 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+#include <type_traits>
+#include <utility>
+
+#include <dplx/dp/columns.hpp>
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/detail/mp_for_dots.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_parser.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+// the columns are cleared beforehand and reserved once with the number of
+// rows if the array is definite. On failure the columns are cleared again,
+// i.e. they never end up with different sizes.
+template <typename... Columns, input_stream Stream>
+    requires(
+            (back_insertion_sequence_container<std::remove_cvref_t<Columns>>
+             && ...)
+            && (decodable<typename std::remove_cvref_t<Columns>::value_type,
+                          Stream> && ...))
+class basic_decoder<columns<Columns...>, Stream>
+{
+    using parse = item_parser<Stream>;
+
+public:
+    using value_type = columns<Columns...>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        dest.clear();
+        if (auto decodeRx = parse::array(inStream, dest, decode_row);
+            decodeRx.has_failure())
+            DPLX_ATTR_UNLIKELY
+            {
+                dest.clear();
+                return std::move(decodeRx).as_failure();
+            }
+        return oc::success();
+    }
+
+private:
+    static auto decode_row(Stream &inStream,
+                           value_type &dest,
+                           std::size_t const) -> result<void>
+    {
+        DPLX_TRY(auto const headInfo, dp::parse_tuple_head(inStream));
+        if (headInfo.num_properties != value_type::num_columns)
+        {
+            return errc::tuple_size_mismatch;
+        }
+
+        return detail::mp_for_dots<value_type::num_columns>(
+                [&inStream, &dest](auto const i) -> result<void> {
+                    auto &column = dest.template column<decltype(i)::value>();
+                    using element_type = typename std::remove_cvref_t<
+                            decltype(column)>::value_type;
+
+                    column.emplace_back();
+                    return basic_decoder<element_type, Stream>()(
+                            inStream, column.back());
+                });
+    }
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,322 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+#include <ranges>
+
+#include <dplx/dp/compressed_sequence.hpp>
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/customization.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// reads the varints and bit fields of a compressed sequence payload in
+// chunks. Reading past the end of the payload is reported as
+// item_value_out_of_range.
+template <input_stream Stream>
+class compressed_payload_reader
+{
+    static constexpr std::size_t chunk_size = 256u;
+
+    Stream &mStream;
+    std::uint64_t mRemaining;
+    std::size_t mPos;
+    std::size_t mEnd;
+    std::uint64_t mBits;
+    unsigned mNumBits;
+    std::byte mChunk[chunk_size];
+
+public:
+    compressed_payload_reader(Stream &inStream,
+                              std::uint64_t const payloadSize) noexcept
+        : mStream(inStream)
+        , mRemaining(payloadSize)
+        , mPos(0u)
+        , mEnd(0u)
+        , mBits(0u)
+        , mNumBits(0u)
+    {
+    }
+
+    // the number of payload bytes which haven't been consumed yet
+    [[nodiscard]] auto remaining_size() const noexcept -> std::uint64_t
+    {
+        return mRemaining + (mEnd - mPos);
+    }
+
+    auto get_varint() -> result<std::uint64_t>
+    {
+        std::uint64_t value = 0u;
+        for (unsigned shift = 0u;; shift += 7u)
+        {
+            DPLX_TRY(std::uint8_t const byte, next_byte());
+            if (shift == 63u && byte > 1u)
+                DPLX_ATTR_UNLIKELY
+                {
+                    return errc::item_value_out_of_range;
+                }
+            value |= static_cast<std::uint64_t>(byte & 0x7fu) << shift;
+            if ((byte & 0x80u) == 0u)
+            {
+                return value;
+            }
+        }
+    }
+
+    // reads numBits MSB first
+    auto get_bits(unsigned const numBits) -> result<std::uint64_t>
+    {
+        if (numBits > 32u)
+        {
+            DPLX_TRY(std::uint64_t const high, get_bits(numBits - 32u));
+            DPLX_TRY(std::uint64_t const low, get_bits(32u));
+            return (high << 32) | low;
+        }
+        while (mNumBits < numBits)
+        {
+            DPLX_TRY(std::uint8_t const byte, next_byte());
+            mBits = (mBits << 8) | byte;
+            mNumBits += 8u;
+        }
+        mNumBits -= numBits;
+        return (mBits >> mNumBits) & ((std::uint64_t{1} << numBits) - 1u);
+    }
+
+private:
+    auto next_byte() -> result<std::uint8_t>
+    {
+        if (mPos == mEnd)
+        {
+            if (mRemaining == 0u)
+                DPLX_ATTR_UNLIKELY
+                {
+                    return errc::item_value_out_of_range;
+                }
+            auto const readSize = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(mRemaining, chunk_size));
+            DPLX_TRY(dp::read(mStream, mChunk, readSize));
+            mRemaining -= readSize;
+            mPos = 0u;
+            mEnd = readSize;
+        }
+        return static_cast<std::uint8_t>(mChunk[mPos++]);
+    }
+};
+
+// The varints are decoded block wise into a scratch buffer and the values
+// are reconstructed by a separate prefix sum pass over the block, i.e. the
+// data dependent varint parsing doesn't stall the arithmetic.
+template <typename T, input_stream Stream>
+class compressed_sequence_decoder
+{
+    using container_type = typename T::container_type;
+    using element_type = std::ranges::range_value_t<container_type>;
+
+    static constexpr std::size_t block_size = 64u;
+
+public:
+    using value_type = T;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        DPLX_TRY(dp::item_info const tagItem, detail::parse_item(inStream));
+        if (tagItem.type != type_code::tag || tagItem.value != value_type::tag)
+        {
+            return errc::item_type_mismatch;
+        }
+        DPLX_TRY(dp::item_info const bytes, detail::parse_item(inStream));
+        if (bytes.type != type_code::binary || bytes.indefinite())
+        {
+            return errc::item_type_mismatch;
+        }
+        DPLX_TRY(auto const availableBytes, dp::available_input_size(inStream));
+        if (availableBytes < bytes.value)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::missing_data;
+            }
+
+        compressed_payload_reader<Stream> reader(inStream, bytes.value);
+        DPLX_TRY(std::uint64_t const numElements, reader.get_varint());
+
+        // each element occupies at least one byte or one bit respectively
+        auto const maxElements = value_type::tag == xor_sequence_tag
+                                       ? reader.remaining_size() * 8u
+                                       : reader.remaining_size();
+        if (numElements > maxElements)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_value_out_of_range;
+            }
+        DPLX_TRY(dp::container_resize(dest.values,
+                                      static_cast<std::size_t>(numElements)));
+
+        if constexpr (value_type::tag == xor_sequence_tag)
+        {
+            DPLX_TRY(decode_xor(reader, dest.values,
+                                static_cast<std::size_t>(numElements)));
+        }
+        else
+        {
+            DPLX_TRY(decode_deltas(reader, dest.values,
+                                   static_cast<std::size_t>(numElements)));
+        }
+
+        // only the padding bits of the last byte may remain
+        if (reader.remaining_size() != 0u)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_value_out_of_range;
+            }
+        return oc::success();
+    }
+
+private:
+    static auto decode_deltas(compressed_payload_reader<Stream> &reader,
+                              container_type &values,
+                              std::size_t const numElements) -> result<void>
+    {
+        std::uint64_t block[block_size];
+        std::uint64_t previous = 0u;
+        std::uint64_t previousDelta = 0u;
+
+        auto it = std::ranges::begin(values);
+        for (std::size_t offset = 0u; offset < numElements;)
+        {
+            auto const blockSize = std::min(block_size, numElements - offset);
+            for (std::size_t i = 0u; i < blockSize; ++i)
+            {
+                DPLX_TRY(std::uint64_t const encoded, reader.get_varint());
+                block[i] = detail::zigzag_decode(encoded);
+            }
+
+            if constexpr (value_type::tag == delta_of_delta_sequence_tag)
+            {
+                for (std::size_t i = 0u; i < blockSize; ++i)
+                {
+                    previousDelta += block[i];
+                    block[i] = previousDelta;
+                }
+            }
+            for (std::size_t i = 0u; i < blockSize; ++i)
+            {
+                previous += block[i];
+                block[i] = previous;
+            }
+
+            for (std::size_t i = 0u; i < blockSize; ++i, ++it)
+            {
+                DPLX_TRY(*it, detail::sequence_value<element_type>(block[i]));
+            }
+            offset += blockSize;
+        }
+        return oc::success();
+    }
+
+    static auto decode_xor(compressed_payload_reader<Stream> &reader,
+                           container_type &values,
+                           std::size_t const numElements) -> result<void>
+    {
+        using bits_type = xor_bits_t<element_type>;
+        constexpr unsigned width = std::numeric_limits<bits_type>::digits;
+
+        if (numElements == 0u)
+        {
+            return oc::success();
+        }
+
+        auto it = std::ranges::begin(values);
+        DPLX_TRY(std::uint64_t const first, reader.get_bits(width));
+        auto previous = static_cast<bits_type>(first);
+        *it = std::bit_cast<element_type>(previous);
+        ++it;
+
+        unsigned windowLeading = width;
+        unsigned windowTrailing = 0u;
+        for (std::size_t i = 1u; i < numElements; ++i, ++it)
+        {
+            DPLX_TRY(std::uint64_t const changed, reader.get_bits(1u));
+            if (changed != 0u)
+            {
+                DPLX_TRY(std::uint64_t const newWindow, reader.get_bits(1u));
+                if (newWindow != 0u)
+                {
+                    DPLX_TRY(std::uint64_t const leading,
+                             reader.get_bits(xor_leading_zeros_width));
+                    DPLX_TRY(std::uint64_t const meaningful,
+                             reader.get_bits(xor_meaningful_width));
+                    if (leading + meaningful + 1u > width)
+                        DPLX_ATTR_UNLIKELY
+                        {
+                            return errc::item_value_out_of_range;
+                        }
+                    windowLeading = static_cast<unsigned>(leading);
+                    windowTrailing = width - windowLeading
+                                   - static_cast<unsigned>(meaningful) - 1u;
+                }
+                else if (windowLeading == width)
+                    DPLX_ATTR_UNLIKELY
+                    {
+                        // there is no previous window to refer to
+                        return errc::item_value_out_of_range;
+                    }
+
+                DPLX_TRY(std::uint64_t const diff,
+                         reader.get_bits(width - windowLeading
+                                         - windowTrailing));
+                previous ^= static_cast<bits_type>(diff << windowTrailing);
+            }
+            *it = std::bit_cast<element_type>(previous);
+        }
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// sequences are decoded into resizable containers, e.g. std::vector
+template <typename Container, input_stream Stream>
+    requires tag_invocable<container_resize_fn, Container &, std::size_t const>
+class basic_decoder<delta_encoded<Container>, Stream>
+    : public detail::compressed_sequence_decoder<delta_encoded<Container>,
+                                                 Stream>
+{
+};
+
+template <typename Container, input_stream Stream>
+    requires tag_invocable<container_resize_fn, Container &, std::size_t const>
+class basic_decoder<delta_of_delta_encoded<Container>, Stream>
+    : public detail::compressed_sequence_decoder<
+              delta_of_delta_encoded<Container>,
+              Stream>
+{
+};
+
+template <typename Container, input_stream Stream>
+    requires tag_invocable<container_resize_fn, Container &, std::size_t const>
+class basic_decoder<xor_encoded<Container>, Stream>
+    : public detail::compressed_sequence_decoder<xor_encoded<Container>,
+                                                 Stream>
+{
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,79 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/embedded_cbor.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_parser.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/value_sharing.hpp>
+
+namespace dplx::dp
+{
+
+template <typename T, input_stream Stream>
+    requires decodable<T, Stream>
+class basic_decoder<embedded_cbor<T>, Stream>
+{
+    using parse = item_parser<Stream>;
+
+public:
+    using value_type = embedded_cbor<T>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        DPLX_TRY(parse::expect(inStream, type_code::tag, embedded_cbor_tag));
+
+        DPLX_TRY(item_info const byteStringInfo, parse::generic(inStream));
+        if (byteStringInfo.type != type_code::binary)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_type_mismatch;
+            }
+        if (byteStringInfo.indefinite())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::indefinite_item;
+            }
+
+        DPLX_TRY(std::size_t const remainingBefore,
+                 dp::available_input_size(inStream));
+        if (remainingBefore < byteStringInfo.value)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::end_of_stream;
+            }
+
+        // the embedded item is a self-contained document
+        DPLX_TRY((dp::with_stream_states_detached<sharing_table,
+                                                  stringref_dictionary>(
+                inStream, [&dest]<typename EmbeddedStream>(
+                        EmbeddedStream &embeddedStream) -> result<void> {
+                    return basic_decoder<T, EmbeddedStream>()(embeddedStream,
+                                                              dest.value);
+                })));
+
+        DPLX_TRY(std::size_t const remainingAfter,
+                 dp::available_input_size(inStream));
+        // the embedded item must fill the byte string exactly
+        if (remainingBefore - remainingAfter != byteStringInfo.value)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_value_out_of_range;
+            }
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,548 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <concepts>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/detail/pre_encoded.hpp>
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/detail/utils.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/layout_descriptor.hpp>
+#include <dplx/dp/object_def.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// the maximum number of input bytes a fixed-shape T can occupy including
+// lenient i.e. non-canonical item heads. Every item head is assumed to
+// occupy var_uint_max_size bytes which additionally guarantees that the
+// speculative item head parser never reads past the bound.
+template <typename T>
+struct fixed_shape_input_bound
+{
+};
+
+// clang-format off
+template <typename T>
+concept fixed_shape_decodable
+    = requires
+    {
+        { fixed_shape_input_bound<T>::value }
+            -> std::convertible_to<std::size_t>;
+    };
+// clang-format on
+
+template <fixed_shape_decodable T>
+inline constexpr std::size_t fixed_shape_input_bound_v
+        = fixed_shape_input_bound<T>::value;
+
+inline constexpr std::size_t fixed_shape_head_bound
+        = static_cast<std::size_t>(var_uint_max_size);
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto
+fixed_shape_tuple_layout_impl(std::index_sequence<Is...>) noexcept -> bool
+{
+    return (... && fixed_shape_decodable<typename remove_cref_t<decltype(
+                           descriptor.template property<Is>())>::value_type>);
+}
+
+template <auto const &descriptor>
+concept fixed_shape_tuple_layout = fixed_shape_tuple_layout_impl<descriptor>(
+        std::make_index_sequence<descriptor.num_properties>());
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto
+fixed_shape_object_layout_impl(std::index_sequence<Is...>) noexcept -> bool
+{
+    return (... && pre_encodable_property_id<typename remove_cref_t<decltype(
+                           descriptor.template property<Is>())>::id_type>);
+}
+
+template <auto const &descriptor>
+concept fixed_shape_object_layout
+        = descriptor.encoding == object_encoding::map
+       && fixed_shape_tuple_layout<descriptor>
+       && fixed_shape_object_layout_impl<descriptor>(
+               std::make_index_sequence<descriptor.num_properties>());
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto
+fixed_shape_tuple_input_bound(std::index_sequence<Is...>) noexcept
+        -> std::size_t
+{
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    return ((fixed_shape_head_bound * (1u + hasVersion)) + ...
+            + fixed_shape_input_bound_v<typename remove_cref_t<decltype(
+                    descriptor.template property<Is>())>::value_type>);
+}
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto
+fixed_shape_object_input_bound(std::index_sequence<Is...>) noexcept
+        -> std::size_t
+{
+    // the version property id is always encoded as a single byte
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    return ((fixed_shape_head_bound * (1u + hasVersion) + hasVersion) + ...
+            + (encoded_property_key<
+                       descriptor,
+                       remove_cref_t<decltype(
+                               descriptor.template property<Is>())>>
+                       .size()
+               + fixed_shape_input_bound_v<typename remove_cref_t<decltype(
+                       descriptor.template property<Is>())>::value_type>));
+}
+
+template <>
+struct fixed_shape_input_bound<bool> : std::integral_constant<std::size_t, 1u>
+{
+};
+
+template <integer T>
+struct fixed_shape_input_bound<T>
+    : std::integral_constant<std::size_t, fixed_shape_head_bound>
+{
+};
+
+template <iec559_floating_point T>
+struct fixed_shape_input_bound<T>
+    : std::integral_constant<std::size_t, fixed_shape_head_bound>
+{
+};
+
+template <codable_enum T>
+struct fixed_shape_input_bound<T>
+    : std::integral_constant<std::size_t, fixed_shape_head_bound>
+{
+};
+
+template <std::size_t N>
+struct fixed_shape_input_bound<fixed_u8string<N>>
+    : std::integral_constant<std::size_t, fixed_shape_head_bound + N>
+{
+};
+
+template <fixed_shape_decodable T, std::size_t N>
+struct fixed_shape_input_bound<std::array<T, N>>
+    : std::integral_constant<std::size_t,
+                             fixed_shape_head_bound
+                                     + N * fixed_shape_input_bound_v<T>>
+{
+};
+template <std::size_t N>
+struct fixed_shape_input_bound<std::array<std::byte, N>>
+    : std::integral_constant<std::size_t, fixed_shape_head_bound + N>
+{
+};
+
+template <packable_tuple T>
+    requires fixed_shape_tuple_layout<layout_descriptor_for_v<T>>
+struct fixed_shape_input_bound<T>
+    : std::integral_constant<
+              std::size_t,
+              detail::fixed_shape_tuple_input_bound<layout_descriptor_for_v<T>>(
+                      std::make_index_sequence<
+                              layout_descriptor_for_v<T>.num_properties>())>
+{
+};
+
+template <packable_object T>
+    requires fixed_shape_object_layout<layout_descriptor_for_v<T>>
+struct fixed_shape_input_bound<T>
+    : std::integral_constant<
+              std::size_t,
+              detail::fixed_shape_object_input_bound<
+                      layout_descriptor_for_v<T>>(std::make_index_sequence<
+                      layout_descriptor_for_v<T>.num_properties>())>
+{
+};
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// fixed-shape records whose input bound doesn't exceed this limit are decoded
+// from a single read proxy if the stream can provide that many contiguous
+// bytes. The default is the number of contiguous bytes every stream
+// guarantees, e.g. chunked_input_stream merges its chunks in order to provide
+// them, i.e. the fast path is only bypassed near the end of the input. As the
+// input bound reserves fixed_shape_head_bound bytes per item head this admits
+// records of about four scalar members. The limit may be specialized for
+// wider records which are mostly decoded from contiguous memory; the record
+// is decoded item by item whenever the stream can't provide the input bound.
+template <typename T>
+inline constexpr std::size_t single_pass_decoding_limit
+        = minimum_guaranteed_read_size;
+
+// clang-format off
+template <typename T>
+concept single_pass_decodable
+    = (packable_tuple<T> || packable_object<T>)
+    && detail::fixed_shape_decodable<T>
+    && detail::fixed_shape_input_bound_v<T> <= single_pass_decoding_limit<T>;
+
+// the fast path loads strings without registering them with the stringref
+// namespace of the stream
+template <typename T, typename Stream>
+concept single_pass_decodable_from
+    = single_pass_decodable<T>
+    && !has_stream_state<Stream, stringref_dictionary>;
+// clang-format on
+
+} // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+// decodes a fixed-shape value without any bounds checks; src must point to
+// at least fixed_shape_input_bound_v<T> bytes and is advanced past the
+// decoded item. Returns false on anything unusual e.g. a type mismatch or an
+// indefinite item, in which case the caller must retry with the checked
+// decoding path which reports the exact error.
+template <fixed_shape_decodable T>
+inline auto load_fixed_shape(std::byte const *&src, T &dest) noexcept -> bool;
+
+inline auto load_fixed_shape_head(std::byte const *&src,
+                                  type_code const expectedType) noexcept
+        -> std::uint64_t
+{
+    auto parseRx = detail::parse_item_speculative(src);
+    if (parseRx.has_error())
+        DPLX_ATTR_UNLIKELY
+        {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+    auto const &item = parseRx.assume_value();
+    if (item.type != expectedType || item.indefinite())
+        DPLX_ATTR_UNLIKELY
+        {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+    src += item.encoded_length;
+    return item.value;
+}
+
+template <integer T>
+inline auto load_fixed_shape_integer(std::byte const *&src, T &dest) noexcept
+        -> bool
+{
+    auto parseRx = detail::parse_item_speculative(src);
+    if (parseRx.has_error())
+        DPLX_ATTR_UNLIKELY
+        {
+            return false;
+        }
+    auto const &item = parseRx.assume_value();
+
+    if constexpr (std::is_unsigned_v<T>)
+    {
+        if (item.type != type_code::posint
+            || item.value > std::numeric_limits<T>::max())
+            DPLX_ATTR_UNLIKELY
+            {
+                return false;
+            }
+        dest = static_cast<T>(item.value);
+    }
+    else
+    {
+        if ((item.type != type_code::posint && item.type != type_code::negint)
+            || item.value > static_cast<std::make_unsigned_t<T>>(
+                       std::numeric_limits<T>::max()))
+            DPLX_ATTR_UNLIKELY
+            {
+                return false;
+            }
+
+        // see item_parser::integer()
+        std::uint64_t const signBit = static_cast<std::uint64_t>(item.type)
+                                   << 58;
+        std::int64_t const signExtended
+                = static_cast<std::int64_t>(signBit) >> 63;
+        std::uint64_t const xorpad = static_cast<std::uint64_t>(signExtended);
+
+        dest = static_cast<T>(item.value ^ xorpad);
+    }
+    src += item.encoded_length;
+    return true;
+}
+
+template <iec559_floating_point T>
+inline auto load_fixed_shape_float(std::byte const *&src, T &dest) noexcept
+        -> bool
+{
+    auto parseRx = detail::parse_item_speculative(src);
+    if (parseRx.has_error())
+        DPLX_ATTR_UNLIKELY
+        {
+            return false;
+        }
+    auto const &item = parseRx.assume_value();
+
+    if (item.type != type_code::special || item.indefinite()
+        || item.encoded_length < 3u)
+        DPLX_ATTR_UNLIKELY
+        {
+            return false;
+        }
+
+    if (item.encoded_length == 9u)
+    {
+        if constexpr (sizeof(T) == 4)
+        {
+            return false;
+        }
+        else
+        {
+            std::memcpy(&dest, &item.value, sizeof(dest)); // #bit_cast
+        }
+    }
+    else if (item.encoded_length == 5u)
+    {
+        float value;
+        std::memcpy(&value, &item.value, sizeof(value)); // #bit_cast
+        dest = value;
+    }
+    else // if (item.encoded_length == 3u)
+    {
+        dest = static_cast<T>(detail::load_iec559_half(
+                static_cast<std::uint16_t>(item.value)));
+    }
+    src += item.encoded_length;
+    return true;
+}
+
+template <auto const &descriptor, typename T, std::size_t... Is>
+inline auto load_fixed_shape_tuple(std::byte const *&src,
+                                   T &dest,
+                                   std::index_sequence<Is...>) noexcept -> bool
+{
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    if (detail::load_fixed_shape_head(src, type_code::array)
+        != descriptor.num_properties + hasVersion)
+    {
+        return false;
+    }
+    if constexpr (hasVersion)
+    {
+        if (detail::load_fixed_shape_head(src, type_code::posint)
+            != descriptor.version)
+        {
+            return false;
+        }
+    }
+
+    return (... && detail::load_fixed_shape(
+                           src, remove_cref_t<decltype(descriptor.template
+                                                       property<Is>())>::
+                                        access(dest)));
+}
+
+template <auto const &descriptor, typename PropDefType, typename T>
+inline auto load_fixed_shape_property(std::byte const *&src, T &dest) noexcept
+        -> bool
+{
+    // properties are expected in the order and form our encoder emits them
+    constexpr auto const &encodedId
+            = encoded_property_key<descriptor, PropDefType>;
+    if (std::memcmp(src, encodedId.data(), encodedId.size()) != 0)
+    {
+        return false;
+    }
+    src += encodedId.size();
+    return detail::load_fixed_shape(src, PropDefType::access(dest));
+}
+
+template <auto const &descriptor, typename T, std::size_t... Is>
+inline auto load_fixed_shape_object(std::byte const *&src,
+                                    T &dest,
+                                    std::index_sequence<Is...>) noexcept
+        -> bool
+{
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    if (detail::load_fixed_shape_head(src, type_code::map)
+        != descriptor.num_properties + hasVersion)
+    {
+        return false;
+    }
+    if constexpr (hasVersion)
+    {
+        if (*src != std::byte{}
+            || detail::load_fixed_shape_head(++src, type_code::posint)
+                       != descriptor.version)
+        {
+            return false;
+        }
+    }
+
+    return (... && detail::load_fixed_shape_property<
+                           descriptor,
+                           remove_cref_t<decltype(
+                                   descriptor.template property<Is>())>>(
+                           src, dest));
+}
+
+template <fixed_shape_decodable T>
+inline auto load_fixed_shape(std::byte const *&src, T &dest) noexcept -> bool
+{
+    if constexpr (std::same_as<T, bool>)
+    {
+        // see item_parser::boolean()
+        unsigned const rolled
+                = static_cast<unsigned>(*src)
+                - static_cast<unsigned>(type_code::bool_false);
+        if (rolled > 1u)
+        {
+            return false;
+        }
+        dest = static_cast<bool>(rolled);
+        src += 1;
+        return true;
+    }
+    else if constexpr (integer<T>)
+    {
+        return detail::load_fixed_shape_integer(src, dest);
+    }
+    else if constexpr (iec559_floating_point<T>)
+    {
+        return detail::load_fixed_shape_float(src, dest);
+    }
+    else if constexpr (codable_enum<T>)
+    {
+        std::underlying_type_t<T> bitRepresentation;
+        if (!detail::load_fixed_shape_integer(src, bitRepresentation))
+        {
+            return false;
+        }
+        dest = static_cast<T>(bitRepresentation);
+        return true;
+    }
+    else if constexpr (is_fixed_u8string_v<T>)
+    {
+        auto const size = detail::load_fixed_shape_head(src, type_code::text);
+        if (size > dest.max_size())
+        {
+            return false;
+        }
+        std::memcpy(dest.data(), src, static_cast<std::size_t>(size));
+        dest.mNumCodeUnits = static_cast<unsigned int>(size);
+        src += size;
+        return true;
+    }
+    else if constexpr (is_std_array_v<T>)
+    {
+        constexpr auto size = std::tuple_size_v<T>;
+        if constexpr (std::same_as<typename T::value_type, std::byte>)
+        {
+            if (detail::load_fixed_shape_head(src, type_code::binary) != size)
+            {
+                return false;
+            }
+            std::memcpy(dest.data(), src, size);
+            src += size;
+            return true;
+        }
+        else
+        {
+            if (detail::load_fixed_shape_head(src, type_code::array) != size)
+            {
+                return false;
+            }
+            for (auto &element : dest)
+            {
+                if (!detail::load_fixed_shape(src, element))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+    else if constexpr (packable_tuple<T>)
+    {
+        constexpr auto const &descriptor = layout_descriptor_for_v<T>;
+        return detail::load_fixed_shape_tuple<descriptor>(
+                src, dest,
+                std::make_index_sequence<descriptor.num_properties>());
+    }
+    else if constexpr (packable_object<T>)
+    {
+        constexpr auto const &descriptor = layout_descriptor_for_v<T>;
+        return detail::load_fixed_shape_object<descriptor>(
+                src, dest,
+                std::make_index_sequence<descriptor.num_properties>());
+    }
+}
+
+// decodes the value from a single read proxy of fixed_shape_input_bound_v<T>
+// bytes. Returns false without having consumed anything if the stream can't
+// provide that many contiguous bytes or the input doesn't have the expected
+// shape. dest may have been partially overwritten in the latter case.
+template <single_pass_decodable T, input_stream Stream>
+inline auto try_decode_single_pass(Stream &inStream, T &dest) -> result<bool>
+{
+    constexpr std::size_t inputBound = fixed_shape_input_bound_v<T>;
+
+    auto maybeReadProxy = read(inStream, inputBound);
+    if (oc::try_operation_has_value(maybeReadProxy))
+        DPLX_ATTR_LIKELY
+        {
+            auto &&readProxy = oc::try_operation_extract_value(
+                    std::move(maybeReadProxy));
+
+            if (std::ranges::size(readProxy) < inputBound)
+                DPLX_ATTR_UNLIKELY
+                {
+                    DPLX_TRY(consume(inStream, readProxy, 0u));
+                    return false;
+                }
+
+            std::byte const *const begin = std::ranges::data(readProxy);
+            std::byte const *src = begin;
+            if (!detail::load_fixed_shape(src, dest))
+                DPLX_ATTR_UNLIKELY
+                {
+                    DPLX_TRY(consume(inStream, readProxy, 0u));
+                    return false;
+                }
+
+            DPLX_TRY(consume(inStream, readProxy,
+                             static_cast<std::size_t>(src - begin)));
+            return true;
+        }
+    else
+    {
+        if (result<void> failure
+            = oc::try_operation_return_as(std::move(maybeReadProxy));
+            failure.assume_error() != errc::end_of_stream)
+        {
+            return failure.as_failure();
+        }
+        // the record may still be shorter than its input bound
+        return false;
+    }
+}
+
+} // namespace dplx::dp::detail
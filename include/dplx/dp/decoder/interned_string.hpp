@@ -0,0 +1,43 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/interned_string.hpp>
+#include <dplx/dp/item_parser.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+
+namespace dplx::dp
+{
+
+// the text is assembled in the buffer of the u8string_pool attached to the
+// stream and then interned, i.e. decoding a known string doesn't allocate.
+template <input_stream Stream>
+    requires has_stream_state<Stream, u8string_pool>
+class basic_decoder<interned_u8string, Stream>
+{
+    using parse = item_parser<Stream>;
+
+public:
+    using value_type = interned_u8string;
+
+    auto operator()(Stream &inStream, interned_u8string &value) const
+            -> result<void>
+    {
+        auto &pool = get_stream_state<u8string_pool>(inStream);
+        auto &buffer = pool.buffer();
+
+        DPLX_TRY(parse::u8string(inStream, buffer));
+        DPLX_TRY(value, pool.intern(buffer));
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,44 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/detail/capture_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/lazy.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+// only determines the extent of the item and captures it, the item is
+// decoded by lazy<T>::get(). Within a stringref namespace the strings of the
+// item are registered and references are resolved before capturing it.
+// Shareable items and shared references are rejected within a value sharing
+// namespace.
+template <typename T, input_stream Stream>
+class basic_decoder<lazy<T>, Stream>
+{
+public:
+    using value_type = lazy<T>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        std::vector<std::byte> encoded;
+        DPLX_TRY(detail::capture_item(inStream, encoded));
+
+        dest.assign_encoded(std::move(encoded));
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
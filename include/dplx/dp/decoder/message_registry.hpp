@@ -0,0 +1,110 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <concepts>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <boost/mp11/algorithm.hpp>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/decoder/object_utils.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_parser.hpp>
+#include <dplx/dp/message_registry.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// maps a message id to its position within Registry::ids
+template <typename Registry>
+inline constexpr property_id_lookup_fn<std::uint64_t,
+                                       Registry::num_messages,
+                                       true>
+        message_id_lookup{Registry::ids};
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// decodes an envelope [type_id, payload] into the registered message type
+// with the given id and invokes the handler with it. The handler may return
+// a result<void> which is forwarded.
+inline constexpr struct decode_message_fn final
+{
+    template <input_stream Stream, typename... Ts, typename Handler>
+        requires((decodable<Ts, Stream> && std::default_initializable<Ts>
+                  && std::invocable<Handler &, Ts &>)&&...)
+    inline auto operator()(Stream &inStream,
+                           message_registry<Ts...> const &,
+                           Handler &&handler) const -> result<void>
+    {
+        using registry = message_registry<Ts...>;
+        using parse = item_parser<Stream>;
+
+        DPLX_TRY(dp::item_info const envelopeInfo,
+                 detail::parse_item(inStream));
+        if (envelopeInfo.type != type_code::array)
+        {
+            return errc::item_type_mismatch;
+        }
+        if (envelopeInfo.indefinite() || envelopeInfo.value != 2u)
+        {
+            return errc::tuple_size_mismatch;
+        }
+
+        DPLX_TRY(std::uint64_t const id,
+                 parse::template integer<std::uint64_t>(inStream));
+        std::size_t const pos = detail::message_id_lookup<registry>(id);
+        if (pos == detail::unknown_property_id)
+        {
+            return errc::unknown_message_type;
+        }
+
+        return boost::mp11::mp_with_index<registry::num_messages>(
+                pos, [&](auto const i) -> result<void> {
+                    using decoded_type = boost::mp11::mp_at_c<
+                            typename registry::types,
+                            registry::type_indices[i]>;
+
+                    return decode_into<decoded_type>(inStream, handler);
+                });
+    }
+
+private:
+    template <typename T, typename Stream, typename Handler>
+    static auto decode_into(Stream &inStream, Handler &handler)
+            -> result<void>
+    {
+        T message{};
+        DPLX_TRY((basic_decoder<T, Stream>()(inStream, message)));
+
+        using handler_result = std::invoke_result_t<Handler &, T &>;
+        if constexpr (std::is_void_v<handler_result>)
+        {
+            handler(message);
+            return success();
+        }
+        else
+        {
+            return handler(message);
+        }
+    }
+
+} decode_message{};
+
+} // namespace dplx::dp
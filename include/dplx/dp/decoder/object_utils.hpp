@@ -7,26 +7,33 @@
 
 #pragma once
 
+#include <bit>
 #include <cstdint>
 
 #include <algorithm>
 #include <array>
 #include <compare>
+#include <ranges>
 #include <type_traits>
 #include <utility>
 
 #include <boost/mp11/algorithm.hpp>
 
 #include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/fixed_shape.hpp>
+#include <dplx/dp/decoder/reuse.hpp>
 #include <dplx/dp/decoder/std_string.hpp>
 #include <dplx/dp/decoder/utils.hpp>
 #include <dplx/dp/detail/hash.hpp>
+#include <dplx/dp/detail/mp_for_dots.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
 #include <dplx/dp/detail/perfect_hash.hpp>
 #include <dplx/dp/detail/type_utils.hpp>
 #include <dplx/dp/fwd.hpp>
 #include <dplx/dp/layout_descriptor.hpp>
 #include <dplx/dp/object_def.hpp>
 #include <dplx/dp/tag_invoke.hpp>
+#include <dplx/dp/type_code.hpp>
 
 namespace dplx::dp
 {
@@ -51,11 +58,13 @@ inline constexpr struct property_id_hash_fn
         return cpo::tag_invoke(*this, value, seed);
     }
 
+    // ids are often assigned in strides, i.e. they need to be mixed in order
+    // to be distributed evenly over the perfect_hasher buckets
     template <integer T>
     friend constexpr auto tag_invoke(property_id_hash_fn, T value) noexcept
             -> std::uint64_t
     {
-        return static_cast<std::uint64_t>(value);
+        return detail::xxhash3(value, 0u);
     }
     template <integer T>
     friend constexpr auto
@@ -94,13 +103,13 @@ public:
 namespace dplx::dp::detail
 {
 
-template <std::size_t NumBits>
+template <std::size_t NumBits, typename Word = std::size_t>
 constexpr auto compress_bitset(std::initializer_list<bool> vs) noexcept
 {
-    constexpr auto digits = static_cast<std::size_t>(digits_v<std::size_t>);
+    constexpr auto digits = static_cast<std::size_t>(digits_v<Word>);
 
     constexpr auto numBuckets = detail::div_ceil(NumBits, digits);
-    std::array<std::size_t, numBuckets> buckets{};
+    std::array<Word, numBuckets> buckets{};
 
     auto const *it = vs.begin();
     auto const *const end = vs.end();
@@ -112,16 +121,19 @@ constexpr auto compress_bitset(std::initializer_list<bool> vs) noexcept
             offset += 1;
         }
 
-        buckets[offset] |= static_cast<std::size_t>(*it) << shift;
+        buckets[offset] |= static_cast<Word>(*it) << shift;
     }
     return buckets;
 }
 
-template <template <auto...> typename ObjectDefLike, auto... Properties>
+template <typename Word = std::size_t,
+          template <auto...>
+          typename ObjectDefLike,
+          auto... Properties>
 constexpr auto
 compress_optional_props(ObjectDefLike<Properties...> const &) noexcept
 {
-    return detail::compress_bitset<sizeof...(Properties)>(
+    return detail::compress_bitset<sizeof...(Properties), Word>(
             {Properties.required...});
 }
 
@@ -129,6 +141,11 @@ template <auto const &descriptor>
 inline constexpr auto required_prop_mask_for
         = detail::compress_optional_props(descriptor);
 
+// the required properties in the layout of an encoded presence bitmap
+template <auto const &descriptor>
+inline constexpr auto required_presence_bitmap_for
+        = detail::compress_optional_props<std::uint64_t>(descriptor);
+
 inline constexpr std::size_t unknown_property_id = ~static_cast<std::size_t>(0);
 
 template <typename IdType, std::size_t NumIds, bool use_perfect_hash>
@@ -202,61 +219,14 @@ public:
     }
 };
 
-template <auto const &Descriptor, typename T, input_stream Stream>
-class decode_object_property_fn
+// an integer map key and the position of the property it refers to
+template <typename IdType>
+struct integer_property_key
 {
-    static constexpr auto const &descriptor = Descriptor;
-    static constexpr auto ids = descriptor.ids;
-    static constexpr std::size_t const num_prop_ids = descriptor.ids.size();
-
-#if DPLX_DP_WORKAROUND(BOOST_COMP_GNUC, <=, 10, 1, 0)
-    // fixed_u8string id comparison operator is borked
-#else
-    static_assert(std::is_sorted(descriptor.ids.begin(), descriptor.ids.end()));
-#endif
-
-    using odef_type = detail::remove_cref_t<decltype(descriptor)>;
-    using id_type = typename odef_type::id_type;
-    using id_runtime_type = typename odef_type::id_runtime_type;
-
-    static constexpr property_id_lookup_fn<id_type,
-                                           descriptor.ids.size(),
-                                           false>
-            lookup{descriptor.ids};
-
-    using decode_value_fn = mp_decode_value_fn<T, Stream>;
-
-    struct decode_prop_fn : public decode_value_fn
-    {
-        template <std::size_t I>
-        auto operator()(boost::mp11::mp_size_t<I>) -> result<std::size_t>
-        {
-            constexpr auto &propertyDef = descriptor.template property<I>();
-            DPLX_TRY(decode_value_fn::operator()(propertyDef));
-            return I;
-        }
-    };
-
-public:
-    auto operator()(Stream &inStream, T &dest) const -> result<std::size_t>
-    {
-        DPLX_TRY(auto &&id, decode(as_value<id_runtime_type>, inStream));
-
-        auto const idx = lookup(id);
-        if (idx == unknown_property_id)
-        {
-            return errc::unknown_property;
-        }
-
-        return boost::mp11::mp_with_index<num_prop_ids>(
-                idx, decode_prop_fn{{inStream, dest}});
-    }
+    IdType id;
+    std::size_t position;
 };
 
-template <auto const &Descriptor, typename T, input_stream Stream>
-inline constexpr decode_object_property_fn<Descriptor, T, Stream>
-        decode_object_property{};
-
 template <typename T>
 constexpr auto index_of_limit(T const *elems,
                               std::size_t const num,
@@ -272,38 +242,47 @@ constexpr auto index_of_limit(T const *elems,
     return num;
 }
 
-template <auto const &descriptor, typename T, input_stream Stream>
-    requires dp::unsigned_integer<
-            typename detail::remove_cref_t<decltype(descriptor)>::id_type>
-class decode_object_property_fn<descriptor, T, Stream>
+// decodes the value of the property with the given integer key. The keys
+// must be sorted by their ids. Small ids are dispatched through a jump table
+// and the remaining ones are looked up.
+template <auto const &descriptor,
+          auto const &keys,
+          typename T,
+          input_stream Stream>
+class decode_integer_keyed_property_fn
 {
-    using parse = item_parser<Stream>;
-    using descriptor_type = detail::remove_cref_t<decltype(descriptor)>;
-    using id_type = typename descriptor_type::id_type;
+    using key_type = typename remove_cref_t<decltype(keys)>::value_type;
+    using id_type = decltype(key_type::id);
 
-#if DPLX_DP_WORKAROUND(BOOST_COMP_GNUC, <=, 10, 1, 0)
-    // fixed_u8string id comparison operator is borked
-#else
-    static_assert(std::is_sorted(descriptor.ids.begin(), descriptor.ids.end()));
-#endif
-    static_assert(detail::digits_v<id_type> <= detail::digits_v<std::uint64_t>);
+    static constexpr std::size_t num_keys = keys.size();
+
+    static constexpr auto copy_ids() noexcept -> std::array<id_type, num_keys>
+    {
+        std::array<id_type, num_keys> ids{};
+        for (std::size_t i = 0; i < num_keys; ++i)
+        {
+            ids[i] = keys[i].id;
+        }
+        return ids;
+    }
+    static constexpr auto ids = copy_ids();
+    static_assert(std::is_sorted(ids.begin(), ids.end()));
 
     static constexpr id_type small_id_limit = detail::inline_value_max + 1;
-    static constexpr auto small_ids_end = detail::index_of_limit(
-            descriptor.ids.data(), descriptor.ids.size(), small_id_limit);
+    static constexpr auto small_ids_end
+            = detail::index_of_limit(ids.data(), num_keys, small_id_limit);
 
-    static constexpr std::size_t id_map_size
-            = descriptor.ids.size() - small_ids_end;
+    static constexpr std::size_t id_map_size = num_keys - small_ids_end;
 
     static constexpr auto copy_large_ids() noexcept
             -> std::array<id_type, id_map_size>
     {
-        std::array<id_type, id_map_size> ids{};
+        std::array<id_type, id_map_size> largeIds{};
         for (std::size_t i = 0; i < id_map_size; ++i)
         {
-            ids[i] = descriptor.ids[i + small_ids_end];
+            largeIds[i] = ids[i + small_ids_end];
         }
-        return ids;
+        return largeIds;
     }
     static constexpr auto large_ids = copy_large_ids();
     static constexpr property_id_lookup_fn<id_type, id_map_size, false> lookup{
@@ -316,18 +295,18 @@ class decode_object_property_fn<descriptor, T, Stream>
         template <std::size_t I>
         auto operator()(boost::mp11::mp_size_t<I>) -> result<std::size_t>
         {
-            constexpr auto propPos = static_cast<std::size_t>(
-                    std::find(descriptor.ids.data(),
-                              descriptor.ids.data() + small_ids_end,
+            constexpr auto keyPos = static_cast<std::size_t>(
+                    std::find(ids.data(), ids.data() + small_ids_end,
                               static_cast<id_type>(I))
-                    - descriptor.ids.data());
+                    - ids.data());
 
-            if constexpr (propPos == small_ids_end)
+            if constexpr (keyPos == small_ids_end)
             {
                 return errc::unknown_property;
             }
             else
             {
+                constexpr auto propPos = keys[keyPos].position;
                 constexpr auto &propertyDef
                         = descriptor.template property<propPos>();
                 DPLX_TRY(decode_value_fn::operator()(propertyDef));
@@ -341,18 +320,18 @@ class decode_object_property_fn<descriptor, T, Stream>
         template <std::size_t I>
         auto operator()(boost::mp11::mp_size_t<I>) -> result<std::size_t>
         {
+            constexpr auto propPos = keys[I + small_ids_end].position;
             constexpr auto &propertyDef
-                    = descriptor.template property<I + small_ids_end>();
+                    = descriptor.template property<propPos>();
             DPLX_TRY(decode_value_fn::operator()(propertyDef));
-            return I + small_ids_end;
+            return propPos;
         }
     };
 
 public:
-    auto operator()(Stream &inStream, T &dest) const -> result<std::size_t>
+    auto operator()(Stream &inStream, T &dest, id_type const id) const
+            -> result<std::size_t>
     {
-        DPLX_TRY(auto id, parse::template integer<id_type>(inStream));
-
         if (id < small_id_limit)
         {
             if constexpr (small_ids_end == 0)
@@ -368,13 +347,13 @@ public:
         }
         else
         {
-            if constexpr (small_ids_end == descriptor.ids.size())
+            if constexpr (small_ids_end == num_keys)
             {
                 return errc::unknown_property;
             }
             else
             {
-                auto const idx = lookup(static_cast<id_type>(id));
+                auto const idx = lookup(id);
                 if (idx == unknown_property_id)
                 {
                     return errc::unknown_property;
@@ -387,6 +366,211 @@ public:
     }
 };
 
+template <auto const &Descriptor, typename T, input_stream Stream>
+class decode_object_property_fn
+{
+    static constexpr auto const &descriptor = Descriptor;
+    static constexpr auto ids = descriptor.ids;
+    static constexpr std::size_t const num_prop_ids = descriptor.ids.size();
+
+#if DPLX_DP_WORKAROUND(BOOST_COMP_GNUC, <=, 10, 1, 0)
+    // fixed_u8string id comparison operator is borked
+#else
+    static_assert(std::is_sorted(descriptor.ids.begin(), descriptor.ids.end()));
+#endif
+
+    using parse = item_parser<Stream>;
+    using odef_type = detail::remove_cref_t<decltype(descriptor)>;
+    using id_type = typename odef_type::id_type;
+    using id_runtime_type = typename odef_type::id_runtime_type;
+    using alias_key = integer_property_key<std::uint32_t>;
+
+    static constexpr std::size_t num_aliases
+            = odef_type::mp_map_fold_left([]<typename PropDefType>(
+                                                  PropDefType const &) {
+                  return static_cast<std::size_t>(
+                          aliased_property<PropDefType>);
+              });
+
+    static constexpr auto collect_alias_keys() noexcept
+            -> std::array<alias_key, num_aliases>
+    {
+        std::array<alias_key, num_aliases> keys{};
+        std::size_t pos = 0;
+        std::size_t numKeys = 0;
+        odef_type::mp_for_each([&]<typename PropDefType>(PropDefType const &) {
+            if constexpr (aliased_property<PropDefType>)
+            {
+                keys[numKeys++] = alias_key{PropDefType::alias, pos};
+            }
+            ++pos;
+        });
+        std::sort(keys.begin(), keys.end(),
+                  [](alias_key const &lhs, alias_key const &rhs) {
+                      return lhs.id < rhs.id;
+                  });
+        return keys;
+    }
+    static constexpr auto alias_keys = collect_alias_keys();
+
+    static constexpr property_id_lookup_fn<id_type,
+                                           descriptor.ids.size(),
+                                           false>
+            lookup{descriptor.ids};
+
+    using decode_value_fn = mp_decode_value_fn<T, Stream>;
+
+    struct decode_prop_fn : public decode_value_fn
+    {
+        template <std::size_t I>
+        auto operator()(boost::mp11::mp_size_t<I>) -> result<std::size_t>
+        {
+            constexpr auto &propertyDef = descriptor.template property<I>();
+            DPLX_TRY(decode_value_fn::operator()(propertyDef));
+            return I;
+        }
+    };
+
+public:
+    auto operator()(Stream &inStream, T &dest) const -> result<std::size_t>
+    {
+        if constexpr (num_aliases > 0u)
+        {
+            // aliased properties may be keyed by their alias or their name
+            DPLX_TRY(std::byte const initialByte,
+                     detail::peek_initial_byte(inStream));
+            if ((initialByte & std::byte{0b111'00000})
+                == to_byte(type_code::posint))
+            {
+                DPLX_TRY(auto alias,
+                         parse::template integer<std::uint32_t>(inStream));
+                return decode_integer_keyed_property_fn<descriptor,
+                                                        alias_keys, T,
+                                                        Stream>{}(
+                        inStream, dest, alias);
+            }
+        }
+
+        DPLX_TRY(auto &&id, decode(as_value<id_runtime_type>, inStream));
+
+        auto const idx = lookup(id);
+        if (idx == unknown_property_id)
+        {
+            return errc::unknown_property;
+        }
+
+        return boost::mp11::mp_with_index<num_prop_ids>(
+                idx, decode_prop_fn{{inStream, dest}});
+    }
+};
+
+template <auto const &Descriptor, typename T, input_stream Stream>
+inline constexpr decode_object_property_fn<Descriptor, T, Stream>
+        decode_object_property{};
+
+// reused destinations clear containers (and reset optionals) in place,
+// i.e. their memory is retained
+template <typename Stream, typename V>
+inline void reset_property_value(V &value)
+{
+    if constexpr (reuses_destination<Stream> && std::ranges::range<V>
+                  && requires { value.clear(); })
+    {
+        value.clear();
+    }
+    else if constexpr (reuses_destination<Stream>
+                       && requires { value.reset(); })
+    {
+        value.reset();
+    }
+    else
+    {
+        value = V{};
+    }
+}
+
+// assigns a value initialized value to every property which isn't marked in
+// the given bitset, i.e. the destination doesn't retain the values of a
+// previously decoded object
+template <auto const &descriptor,
+          typename Stream,
+          typename T,
+          typename Word,
+          std::size_t N>
+inline void reset_absent_properties(T &dest,
+                                    std::array<Word, N> const &present)
+{
+    constexpr auto digits = static_cast<std::size_t>(digits_v<Word>);
+
+    std::size_t i = 0u;
+    descriptor.mp_for_each([&]<typename PropDefType>(PropDefType const &) {
+        if ((present[i / digits] >> (i % digits) & 1u) == 0u)
+        {
+            detail::reset_property_value<Stream>(PropDefType::access(dest));
+        }
+        ++i;
+    });
+}
+
+template <auto const &descriptor, typename T, input_stream Stream>
+struct decode_present_property_fn : mp_decode_value_fn<T, Stream>
+{
+    std::array<std::uint64_t, presence_bitmap_size<descriptor>> const
+            &presence;
+
+    template <std::size_t I>
+    auto operator()(mp_size_t<I>) -> result<void>
+    {
+        if ((presence[I / presence_word_bits] >> (I % presence_word_bits)
+             & 1u)
+            == 0u)
+        {
+            return oc::success();
+        }
+        return mp_decode_value_fn<T, Stream>::operator()(
+                descriptor.template property<I>());
+    }
+};
+
+template <auto const &descriptor, typename T, input_stream Stream>
+    requires dp::unsigned_integer<
+            typename detail::remove_cref_t<decltype(descriptor)>::id_type>
+class decode_object_property_fn<descriptor, T, Stream>
+{
+    using parse = item_parser<Stream>;
+    using descriptor_type = detail::remove_cref_t<decltype(descriptor)>;
+    using id_type = typename descriptor_type::id_type;
+
+#if DPLX_DP_WORKAROUND(BOOST_COMP_GNUC, <=, 10, 1, 0)
+    // fixed_u8string id comparison operator is borked
+#else
+    static_assert(std::is_sorted(descriptor.ids.begin(), descriptor.ids.end()));
+#endif
+    static_assert(detail::digits_v<id_type> <= detail::digits_v<std::uint64_t>);
+
+    static constexpr auto make_keys() noexcept
+            -> std::array<integer_property_key<id_type>, descriptor.ids.size()>
+    {
+        std::array<integer_property_key<id_type>, descriptor.ids.size()>
+                keys{};
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            keys[i] = {descriptor.ids[i], i};
+        }
+        return keys;
+    }
+    static constexpr auto keys = make_keys();
+
+public:
+    auto operator()(Stream &inStream, T &dest) const -> result<std::size_t>
+    {
+        DPLX_TRY(auto id, parse::template integer<id_type>(inStream));
+
+        return decode_integer_keyed_property_fn<descriptor, keys, T, Stream>{}(
+                inStream, dest, id);
+    }
+};
+
 } // namespace dplx::dp::detail
 
 namespace dplx::dp
@@ -467,6 +651,9 @@ inline auto decode_object_properties(Stream &stream,
                                      T &dest,
                                      std::int32_t numProperties) -> result<void>
 {
+    static_assert(descriptor.version == null_def_version
+                          || !descriptor.claims_version_key,
+                  "versioned objects must not use posint 0 as property key");
     constexpr auto &decode_object_property
             = detail::decode_object_property<descriptor, T, Stream>;
 
@@ -498,6 +685,16 @@ inline auto decode_object_properties(Stream &stream,
         {
             return errc::required_object_property_missing;
         }
+
+        // sparse encodings omit properties with a value initialized value,
+        // i.e. their absence implies that value. Reused destinations mustn't
+        // retain the values of the previous message either.
+        if constexpr (descriptor.encoding != object_encoding::map
+                      || reuses_destination<Stream>)
+        {
+            detail::reset_absent_properties<descriptor, Stream>(dest,
+                                                             foundProps);
+        }
     }
     else
     {
@@ -514,6 +711,73 @@ inline auto decode_object_properties(Stream &stream,
     return success();
 }
 
+// decodes an object encoded with object_encoding::presence_bitmap; absent
+// properties are assigned a value initialized value
+template <auto const &descriptor, typename T, input_stream Stream>
+inline auto decode_presence_bitmap_object(Stream &inStream, T &dest)
+        -> result<void>
+{
+    using parse = item_parser<Stream>;
+    using decode_property_fn
+            = detail::decode_present_property_fn<descriptor, T, Stream>;
+
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    constexpr auto const &requiredProps
+            = detail::required_presence_bitmap_for<descriptor>;
+    constexpr std::size_t numWords = requiredProps.size();
+    constexpr std::size_t numUnusedBits
+            = numWords * detail::presence_word_bits - descriptor.num_properties;
+
+    DPLX_TRY(auto &&arrayInfo, parse::generic(inStream));
+    if (arrayInfo.type != type_code::array || arrayInfo.indefinite())
+    {
+        return errc::item_type_mismatch;
+    }
+    if (arrayInfo.value < hasVersion + numWords)
+    {
+        return errc::tuple_size_mismatch;
+    }
+    if constexpr (hasVersion)
+    {
+        DPLX_TRY(auto version, parse::template integer<std::uint32_t>(
+                                       inStream, 0xffff'fffeU));
+        if (version != descriptor.version)
+        {
+            return errc::item_version_mismatch;
+        }
+    }
+
+    std::array<std::uint64_t, numWords> presence{};
+    std::uint64_t numPresent = 0u;
+    for (std::size_t i = 0; i < numWords; ++i)
+    {
+        DPLX_TRY(presence[i], parse::template integer<std::uint64_t>(inStream));
+        if ((presence[i] & requiredProps[i]) != requiredProps[i])
+        {
+            return errc::required_object_property_missing;
+        }
+        numPresent += static_cast<std::uint64_t>(std::popcount(presence[i]));
+    }
+    if constexpr (numUnusedBits > 0u)
+    {
+        if ((presence.back() >> (detail::presence_word_bits - numUnusedBits))
+            != 0u)
+        {
+            return errc::unknown_property;
+        }
+    }
+    if (arrayInfo.value != hasVersion + numWords + numPresent)
+    {
+        return errc::tuple_size_mismatch;
+    }
+
+    DPLX_TRY(detail::mp_for_dots<descriptor.num_properties>(
+            decode_property_fn{{inStream, dest}, presence}));
+
+    detail::reset_absent_properties<descriptor, Stream>(dest, presence);
+    return oc::success();
+}
+
 template <packable_object T, input_stream Stream>
     requires(detail::versioned_decoder_enabled(layout_descriptor_for_v<T>))
 class basic_decoder<T, Stream>
@@ -521,6 +785,22 @@ class basic_decoder<T, Stream>
 public:
     auto operator()(Stream &inStream, T &dest) const -> result<void>
     {
+        if constexpr (layout_descriptor_for_v<T>.encoding
+                      == object_encoding::presence_bitmap)
+        {
+            return dp::decode_presence_bitmap_object<
+                    layout_descriptor_for_v<T>, T, Stream>(inStream, dest);
+        }
+        if constexpr (single_pass_decodable_from<T, Stream>)
+        {
+            DPLX_TRY(auto decoded,
+                     detail::try_decode_single_pass(inStream, dest));
+            if (decoded)
+            {
+                return oc::success();
+            }
+        }
+
         DPLX_TRY(
                 auto &&headInfo,
                 dp::parse_object_head<Stream, layout_descriptor_for_v<T>.version
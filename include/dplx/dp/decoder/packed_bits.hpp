@@ -0,0 +1,252 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#if __has_include(<boost/dynamic_bitset/dynamic_bitset.hpp>)
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#endif
+
+#include <dplx/dp/customization.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/packed_bits.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// reads the packed bits in chunks
+template <input_stream Stream>
+class packed_bits_reader
+{
+    static constexpr std::size_t chunk_size = 256u;
+
+    Stream &mStream;
+    std::uint64_t mRemaining;
+    std::size_t mPos;
+    std::size_t mEnd;
+    std::byte mChunk[chunk_size];
+
+public:
+    explicit packed_bits_reader(Stream &inStream) noexcept
+        : mStream(inStream)
+        , mRemaining(0u)
+        , mPos(0u)
+        , mEnd(0u)
+    {
+    }
+
+    // parses the tag and the byte string head and returns the number of bits
+    auto start() -> result<std::uint64_t>
+    {
+        DPLX_TRY(dp::item_info const tagItem, detail::parse_item(mStream));
+        if (tagItem.type != type_code::tag || tagItem.value != packed_bits_tag)
+        {
+            return errc::item_type_mismatch;
+        }
+        DPLX_TRY(dp::item_info const bytes, detail::parse_item(mStream));
+        if (bytes.type != type_code::binary || bytes.indefinite())
+        {
+            return errc::item_type_mismatch;
+        }
+        if (bytes.value == 0u)
+        {
+            return errc::item_value_out_of_range;
+        }
+        DPLX_TRY(auto const availableBytes, dp::available_input_size(mStream));
+        if (availableBytes < bytes.value)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::missing_data;
+            }
+
+        std::byte padding;
+        DPLX_TRY(dp::read(mStream, &padding, 1u));
+        auto const numPaddingBits = static_cast<std::uint64_t>(padding);
+        if (numPaddingBits > 7u || (bytes.value == 1u && numPaddingBits != 0u))
+        {
+            return errc::item_value_out_of_range;
+        }
+        mRemaining = bytes.value - 1u;
+        return mRemaining * 8u - numPaddingBits;
+    }
+
+    // reads numBits <= 64 bits stored in little endian byte order. The
+    // padding bits of the last word must be zero.
+    auto get(std::size_t const numBits) -> result<std::uint64_t>
+    {
+        auto const numBytes = (numBits + 7u) / 8u;
+        if (mEnd - mPos < numBytes)
+        {
+            DPLX_TRY(refill());
+        }
+
+        auto const *const src
+                = reinterpret_cast<unsigned char const *>(mChunk + mPos);
+        mPos += numBytes;
+        if (numBits == packed_bits_word_size)
+        {
+            return boost::endian::endian_load<std::uint64_t,
+                                              sizeof(std::uint64_t),
+                                              boost::endian::order::little>(
+                    src);
+        }
+
+        std::uint64_t word = 0u;
+        for (std::size_t i = 0u; i < numBytes; ++i)
+        {
+            word |= static_cast<std::uint64_t>(src[i]) << (8u * i);
+        }
+        if ((word >> numBits) != 0u)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_value_out_of_range;
+            }
+        return word;
+    }
+
+private:
+    auto refill() -> result<void>
+    {
+        auto const numLeft = mEnd - mPos;
+        std::memmove(mChunk, mChunk + mPos, numLeft);
+        auto const readSize = static_cast<std::size_t>(
+                std::min<std::uint64_t>(mRemaining, chunk_size - numLeft));
+        DPLX_TRY(dp::read(mStream, mChunk + numLeft, readSize));
+        mRemaining -= readSize;
+        mPos = 0u;
+        mEnd = numLeft + readSize;
+        return oc::success();
+    }
+};
+
+// scatters packed_bits_word_size bits at a time with setBit(i, bit)
+template <input_stream Stream, typename SetBitFn>
+inline auto decode_packed_bits(packed_bits_reader<Stream> &reader,
+                               std::size_t const numBits,
+                               SetBitFn &&setBit) -> result<void>
+{
+    for (std::size_t offset = 0u; offset < numBits;
+         offset += packed_bits_word_size)
+    {
+        auto const wordSize = std::min(packed_bits_word_size, numBits - offset);
+        DPLX_TRY(std::uint64_t const word, reader.get(wordSize));
+        for (std::size_t i = 0u; i < wordSize; ++i)
+        {
+            setBit(offset + i, ((word >> i) & 1u) != 0u);
+        }
+    }
+    return oc::success();
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+template <typename Allocator, input_stream Stream>
+class basic_decoder<std::vector<bool, Allocator>, Stream>
+{
+public:
+    using value_type = std::vector<bool, Allocator>;
+
+    auto operator()(Stream &inStream, value_type &value) const -> result<void>
+    {
+        detail::packed_bits_reader<Stream> reader(inStream);
+        DPLX_TRY(std::uint64_t const numBits, reader.start());
+        DPLX_TRY(dp::container_resize(value,
+                                      static_cast<std::size_t>(numBits)));
+
+        return detail::decode_packed_bits(
+                reader, value.size(),
+                [&value](std::size_t const i, bool const bit) {
+                    value[i] = bit;
+                });
+    }
+};
+
+// the number of bits must match N
+template <std::size_t N, input_stream Stream>
+class basic_decoder<std::bitset<N>, Stream>
+{
+public:
+    using value_type = std::bitset<N>;
+
+    auto operator()(Stream &inStream, value_type &value) const -> result<void>
+    {
+        detail::packed_bits_reader<Stream> reader(inStream);
+        DPLX_TRY(std::uint64_t const numBits, reader.start());
+        if (numBits != N)
+        {
+            return errc::tuple_size_mismatch;
+        }
+
+        return detail::decode_packed_bits(
+                reader, N, [&value](std::size_t const i, bool const bit) {
+                    value.set(i, bit);
+                });
+    }
+};
+
+// boost::dynamic_bitset is only supported if its header is available
+#if __has_include(<boost/dynamic_bitset/dynamic_bitset.hpp>)
+
+// the blocks are appended as they are, i.e. without scattering single bits
+template <typename Block, typename Allocator, input_stream Stream>
+    requires(std::numeric_limits<Block>::digits
+             <= detail::packed_bits_word_size)
+class basic_decoder<boost::dynamic_bitset<Block, Allocator>, Stream>
+{
+public:
+    using value_type = boost::dynamic_bitset<Block, Allocator>;
+
+    auto operator()(Stream &inStream, value_type &value) const -> result<void>
+    {
+        constexpr std::size_t blockSize = value_type::bits_per_block;
+
+        detail::packed_bits_reader<Stream> reader(inStream);
+        DPLX_TRY(std::uint64_t const numBits, reader.start());
+
+        value.clear();
+        try
+        {
+            for (std::uint64_t offset = 0u; offset < numBits;
+                 offset += blockSize)
+            {
+                auto const numBlockBits = static_cast<std::size_t>(
+                        std::min<std::uint64_t>(blockSize, numBits - offset));
+                DPLX_TRY(std::uint64_t const block, reader.get(numBlockBits));
+                value.append(static_cast<Block>(block));
+            }
+            // drops the zero padding bits of the last block
+            value.resize(static_cast<std::size_t>(numBits));
+        }
+        catch (std::bad_alloc const &)
+        {
+            value.clear();
+            return errc::not_enough_memory;
+        }
+        return oc::success();
+    }
+};
+
+#endif
+
+} // namespace dplx::dp
@@ -0,0 +1,31 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/patchable.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+template <typename T, input_stream Stream>
+class basic_decoder<patchable<T>, Stream>
+{
+public:
+    using value_type = patchable<T>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        return basic_decoder<T, Stream>()(inStream, dest.value);
+    }
+};
+
+} // namespace dplx::dp
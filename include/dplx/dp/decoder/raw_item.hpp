@@ -0,0 +1,59 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <dplx/dp/detail/capture_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/raw_item.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+template <input_stream Stream>
+class basic_decoder<raw_item, Stream>
+{
+public:
+    using value_type = raw_item;
+
+    auto operator()(Stream &inStream, raw_item &dest) const -> result<void>
+    {
+        // reuses the capacity of the previous item
+        auto &storage = dest.storage();
+        storage.clear();
+        if (auto captureRx = detail::capture_item(inStream, storage);
+            captureRx.has_failure())
+            DPLX_ATTR_UNLIKELY
+            {
+                storage.clear();
+                return captureRx;
+            }
+        return oc::success();
+    }
+};
+
+// clang-format off
+template <input_stream Stream>
+    requires detail::is_memory_buffer_v<Stream>
+class basic_decoder<raw_item_view, Stream>
+// clang-format on
+{
+public:
+    using value_type = raw_item_view;
+
+    auto operator()(Stream &inStream, raw_item_view &dest) const
+            -> result<void>
+    {
+        DPLX_TRY(auto const encoded, detail::capture_item_view(inStream));
+
+        dest = raw_item_view(encoded);
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,60 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+
+namespace dplx::dp
+{
+
+// attaching this state to a stream (see stateful_stream) switches the
+// container decoders into reuse mode: the existing elements of the
+// destination are decoded into in place, surplus elements are destroyed and
+// map/set nodes are recycled. Therefore a destination object which is reused
+// across messages doesn't allocate anymore once its capacity suffices.
+//
+// Objects assign a value initialized value to their absent optional
+// properties in reuse mode, i.e. the destination doesn't retain any property
+// values of the previously decoded message.
+struct reuse_destination
+{
+};
+
+template <typename Stream>
+concept reuses_destination = has_stream_state<Stream, reuse_destination>;
+
+// decodes with reuse_destination attached to the stream
+inline constexpr struct decode_reuse_fn final
+{
+    template <typename T, input_stream Stream>
+        requires reuses_destination<Stream> && decodable<T, Stream>
+    inline auto operator()(Stream &inStream, T &dest) const -> result<void>
+    {
+        DPLX_TRY((basic_decoder<T, Stream>()(inStream, dest)));
+        return success();
+    }
+
+    template <typename T, input_stream Stream>
+        requires(!reuses_destination<Stream>
+                 && decodable<T, stateful_stream<Stream, reuse_destination>>)
+    inline auto operator()(Stream &inStream, T &dest) const -> result<void>
+    {
+        using reuse_stream = stateful_stream<Stream, reuse_destination>;
+
+        reuse_destination state;
+        reuse_stream reuseStream(inStream, state);
+        DPLX_TRY((basic_decoder<T, reuse_stream>()(reuseStream, dest)));
+        return success();
+    }
+
+} decode_reuse{};
+
+} // namespace dplx::dp
@@ -7,14 +7,21 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <concepts>
+#include <iterator>
+#include <memory>
 #include <ranges>
 #include <span>
+#include <utility>
+
+#include <boost/container/container_fwd.hpp>
 
 #include <dplx/dp/concepts.hpp>
 #include <dplx/dp/decoder/api.hpp>
 #include <dplx/dp/decoder/array_utils.hpp>
+#include <dplx/dp/decoder/reuse.hpp>
 #include <dplx/dp/customization.std.hpp>
 #include <dplx/dp/disappointment.hpp>
 #include <dplx/dp/fwd.hpp>
@@ -70,11 +77,54 @@ class basic_decoder<T, Stream>
 public:
     auto operator()(Stream &stream, T &value) const -> result<void>
     {
-        DPLX_TRY(parse::array(stream, value, decode_element));
-        return oc::success();
+        if constexpr (reuses_destination<Stream>)
+        {
+            return decode_reusing(stream, value);
+        }
+        else
+        {
+            DPLX_TRY(parse::array(stream, value, decode_element));
+            return oc::success();
+        }
     }
 
 private:
+    // the retained elements are overwritten in place (which recursively
+    // retains their capacity) and only the surplus ones are erased.
+    static auto decode_reusing(Stream &stream, T &value) -> result<void>
+    {
+        auto const numRetained
+                = static_cast<std::size_t>(std::ranges::distance(value));
+
+        // the cursor is initialized with the first element, i.e. after the
+        // parser reserved memory which may invalidate iterators.
+        // Appending elements is only done after the cursor has been
+        // exhausted.
+        std::ranges::iterator_t<T> cursor{};
+        auto decodeRetained
+                = [numRetained, &cursor](Stream &inStream, T &dest,
+                                         std::size_t const i) -> result<void> {
+            if (i >= numRetained)
+            {
+                return decode_element(inStream, dest, i);
+            }
+            cursor = i == 0u ? std::ranges::begin(dest) : std::next(cursor);
+            return element_decoder()(inStream, *cursor);
+        };
+
+        DPLX_TRY(auto const numElements,
+                 parse::array(stream, value, decodeRetained));
+        if (numElements < numRetained)
+        {
+            using difference_type = std::ranges::range_difference_t<T>;
+            value.erase(std::ranges::next(
+                                std::ranges::begin(value),
+                                static_cast<difference_type>(numElements)),
+                        std::ranges::end(value));
+        }
+        return oc::success();
+    }
+
     static auto decode_element(Stream &stream, T &value, std::size_t const)
             -> result<void>
     {
@@ -101,6 +151,27 @@ private:
 namespace dplx::dp
 {
 
+namespace detail
+{
+
+// constructs a temporary element with the allocator of the container (if
+// any) so that e.g. the nested strings of std::pmr containers don't allocate
+// from the default resource before being moved into the container.
+template <typename T, typename Container>
+inline auto make_element_for(Container const &container) -> T
+{
+    if constexpr (requires { container.get_allocator(); })
+    {
+        return std::make_obj_using_allocator<T>(container.get_allocator());
+    }
+    else
+    {
+        return T{};
+    }
+}
+
+} // namespace detail
+
 template <typename T>
 inline constexpr bool disable_associative_container = false;
 
@@ -115,6 +186,60 @@ concept associative_container_emplacement_result
         std::same_as<typename std::tuple_element<1, T>::type, bool>;
 // clang-format on
 
+// clang-format off
+template <typename X>
+concept node_based_container
+    = requires(X &&t, typename X::node_type &&node)
+        {
+            typename X::node_type;
+            { t.extract(t.begin()) } -> std::same_as<typename X::node_type>;
+            { t.insert(t.end(), static_cast<typename X::node_type &&>(node)) };
+        };
+// clang-format on
+
+// deterministically encoded maps arrive sorted, therefore the elements are
+// inserted with an end() hint which makes the insertion amortized O(1) for
+// the ordered containers.
+template <typename T, typename... Args>
+inline auto emplace_unique(T &container, Args &&...args) -> result<void>
+{
+    if constexpr (requires {
+                      container.emplace_hint(container.end(),
+                                             static_cast<Args &&>(args)...);
+                  })
+    {
+        auto const size = container.size();
+        container.emplace_hint(container.end(), static_cast<Args &&>(args)...);
+        if (container.size() == size)
+        {
+            return errc::duplicate_key;
+        }
+    }
+    else
+    {
+        if (auto &&[it, inserted]
+            = container.emplace(static_cast<Args &&>(args)...);
+            !inserted)
+        {
+            return errc::duplicate_key;
+        }
+    }
+    return oc::success();
+}
+
+template <typename T>
+inline auto insert_node(T &container, typename T::node_type &&node)
+        -> result<void>
+{
+    auto const size = container.size();
+    container.insert(container.end(), std::move(node));
+    if (container.size() == size)
+    {
+        return errc::duplicate_key;
+    }
+    return oc::success();
+}
+
 } // namespace detail
 
 // clang-format off
@@ -162,23 +287,41 @@ class basic_decoder<T, Stream>
 public:
     auto operator()(Stream &stream, T &value) const -> result<void>
     {
-        return parse::array(stream, value, decode_element);
+        if constexpr (reuses_destination<Stream>
+                      && detail::node_based_container<T>)
+        {
+            // the nodes of the previous content are recycled
+            T retained(static_cast<T &&>(value));
+            value.clear();
+            DPLX_TRY(parse::array(
+                    stream, value,
+                    [&retained](Stream &inStream, T &dest,
+                                std::size_t const i) -> result<void> {
+                        if (retained.empty())
+                        {
+                            return decode_element(inStream, dest, i);
+                        }
+                        auto node = retained.extract(retained.begin());
+                        DPLX_TRY(element_decoder()(inStream, node.value()));
+                        return detail::insert_node(dest, std::move(node));
+                    }));
+            return oc::success();
+        }
+        else
+        {
+            DPLX_TRY(parse::array(stream, value, decode_element));
+            return oc::success();
+        }
     }
 
 private:
     static auto decode_element(Stream &stream, T &value, std::size_t const)
             -> result<void>
     {
-        element_type e{};
+        auto e = detail::make_element_for<element_type>(value);
         DPLX_TRY(element_decoder()(stream, e));
 
-        if (auto &&[it, inserted]
-            = value.emplace(static_cast<element_type &&>(e));
-            !inserted)
-        {
-            return errc::duplicate_key;
-        }
-        return oc::success();
+        return detail::emplace_unique(value, static_cast<element_type &&>(e));
     }
 };
 
@@ -196,26 +339,159 @@ class basic_decoder<T, Stream>
 public:
     auto operator()(Stream &stream, T &value) const -> result<void>
     {
-        return parse::map(stream, value, decode_element);
+        if constexpr (reuses_destination<Stream>
+                      && detail::node_based_container<T>)
+        {
+            // the nodes of the previous content are recycled
+            T retained(static_cast<T &&>(value));
+            value.clear();
+            DPLX_TRY(parse::map(
+                    stream, value,
+                    [&retained](Stream &inStream, T &dest,
+                                std::size_t const i) -> result<void> {
+                        if (retained.empty())
+                        {
+                            return decode_element(inStream, dest, i);
+                        }
+                        auto node = retained.extract(retained.begin());
+                        DPLX_TRY(key_decoder()(inStream, node.key()));
+                        DPLX_TRY(mapped_decoder()(inStream, node.mapped()));
+                        return detail::insert_node(dest, std::move(node));
+                    }));
+            return oc::success();
+        }
+        else
+        {
+            DPLX_TRY(parse::map(stream, value, decode_element));
+            return oc::success();
+        }
     }
 
 private:
-    static auto decode_element(Stream &stream, T &value) -> result<void>
+    static auto decode_element(Stream &stream, T &value, std::size_t const)
+            -> result<void>
     {
-        key_type k{};
+        auto k = detail::make_element_for<key_type>(value);
         DPLX_TRY(key_decoder()(stream, k));
 
-        mapped_type m{};
+        auto m = detail::make_element_for<mapped_type>(value);
         DPLX_TRY(mapped_decoder()(stream, m));
 
-        if (auto &&[it, inserted]
-            = value.emplace(static_cast<key_type &&>(k),
-                            static_cast<mapped_type &&>(m));
-            !inserted)
+        return detail::emplace_unique(value, static_cast<key_type &&>(k),
+                                      static_cast<mapped_type &&>(m));
+    }
+};
+
+// sorted vector containers like boost::container::flat_map
+namespace detail
+{
+
+// verifies that the sequence is strictly ascending which is the case for
+// deterministically encoded input. Otherwise the sequence is sorted once
+// instead of doing an O(n) insertion per element.
+template <typename T>
+inline auto adopt_sorted_sequence(T &container,
+                                  typename T::sequence_type &&sequence)
+        -> result<void>
+{
+    auto const compare = container.value_comp();
+    auto const notAscending
+            = [&compare](auto const &lhs, auto const &rhs) {
+                  return !compare(lhs, rhs);
+              };
+
+    if (std::adjacent_find(sequence.begin(), sequence.end(), notAscending)
+        != sequence.end())
+    {
+        std::sort(sequence.begin(), sequence.end(), compare);
+        if (std::adjacent_find(sequence.begin(), sequence.end(), notAscending)
+            != sequence.end())
         {
             return errc::duplicate_key;
         }
-        return oc::success();
+    }
+    container.adopt_sequence(boost::container::ordered_unique_range,
+                             std::move(sequence));
+    return oc::success();
+}
+
+} // namespace detail
+
+// clang-format off
+template <typename X>
+concept sorted_vector_container
+    = associative_container<X> &&
+      requires(X &&t, typename X::sequence_type &&seq)
+        {
+            typename X::sequence_type;
+            { t.extract_sequence() }
+                -> std::same_as<typename X::sequence_type>;
+            t.adopt_sequence(boost::container::ordered_unique_range,
+                    static_cast<typename X::sequence_type &&>(seq));
+            t.value_comp();
+        };
+// clang-format on
+
+// the elements are appended to the underlying sequence (whose capacity is
+// retained) which is then adopted by the container
+template <sorted_vector_container T, input_stream Stream>
+    requires decodable<typename T::value_type, Stream>
+class basic_decoder<T, Stream>
+{
+    using parse = item_parser<Stream>;
+    using sequence_type = typename T::sequence_type;
+    using element_type = typename T::value_type;
+    using element_decoder = basic_decoder<element_type, Stream>;
+
+public:
+    auto operator()(Stream &stream, T &value) const -> result<void>
+    {
+        auto sequence = value.extract_sequence();
+        sequence.clear();
+
+        DPLX_TRY(parse::array(stream, sequence, decode_element));
+        return detail::adopt_sorted_sequence(value, std::move(sequence));
+    }
+
+private:
+    static auto decode_element(Stream &stream,
+                               sequence_type &sequence,
+                               std::size_t const) -> result<void>
+    {
+        sequence.emplace_back();
+        return element_decoder()(stream, sequence.back());
+    }
+};
+
+template <typename T, input_stream Stream>
+    requires(map_like_associative_container<T> &&sorted_vector_container<T>
+                     &&decodable<typename T::key_type, Stream>
+                             &&decodable<typename T::mapped_type, Stream>)
+class basic_decoder<T, Stream>
+{
+    using parse = item_parser<Stream>;
+    using sequence_type = typename T::sequence_type;
+    using key_decoder = basic_decoder<typename T::key_type, Stream>;
+    using mapped_decoder = basic_decoder<typename T::mapped_type, Stream>;
+
+public:
+    auto operator()(Stream &stream, T &value) const -> result<void>
+    {
+        auto sequence = value.extract_sequence();
+        sequence.clear();
+
+        DPLX_TRY(parse::map(stream, sequence, decode_element));
+        return detail::adopt_sorted_sequence(value, std::move(sequence));
+    }
+
+private:
+    static auto decode_element(Stream &stream,
+                               sequence_type &sequence,
+                               std::size_t const) -> result<void>
+    {
+        auto &entry = sequence.emplace_back();
+        DPLX_TRY(key_decoder()(stream, entry.first));
+        return mapped_decoder()(stream, entry.second);
     }
 };
 
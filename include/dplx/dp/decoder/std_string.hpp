@@ -16,14 +16,16 @@
 namespace dplx::dp
 {
 
-template <input_stream Stream>
-class basic_decoder<std::u8string, Stream>
+// covers std::pmr::u8string, too. The string keeps its allocator.
+template <typename Traits, typename Allocator, input_stream Stream>
+class basic_decoder<std::basic_string<char8_t, Traits, Allocator>, Stream>
 {
     using parse = item_parser<Stream>;
 
 public:
-    auto operator()(Stream &inStream, std::u8string &value) const
-            -> result<void>
+    using value_type = std::basic_string<char8_t, Traits, Allocator>;
+
+    auto operator()(Stream &inStream, value_type &value) const -> result<void>
     {
         DPLX_TRY(parse::u8string(inStream, value));
         return oc::success();
@@ -0,0 +1,59 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp
+{
+
+// decodes a value enclosed in a stringref namespace. The strings are
+// resolved by the item_parser, i.e. every decoder based on it (e.g. the
+// std::u8string and the interned_u8string decoders) supports references.
+// A stringref_dictionary which is already attached to the stream is cleared
+// and reused. Nested namespaces aren't supported.
+inline constexpr struct decode_stringref_fn final
+{
+    template <typename T, input_stream Stream>
+        requires(has_stream_state<Stream, stringref_dictionary>
+                 && decodable<T, Stream>)
+    inline auto operator()(Stream &inStream, T &dest) const -> result<void>
+    {
+        DPLX_TRY(dp::item_info const item, detail::parse_item(inStream));
+        if (item.type != type_code::tag
+            || item.value != stringref_namespace_tag)
+        {
+            return errc::item_type_mismatch;
+        }
+
+        dp::get_stream_state<stringref_dictionary>(inStream).clear();
+        DPLX_TRY((basic_decoder<T, Stream>()(inStream, dest)));
+        return success();
+    }
+
+    template <typename T, input_stream Stream>
+        requires(!has_stream_state<Stream, stringref_dictionary>
+                 && decodable<T, stateful_stream<Stream, stringref_dictionary>>)
+    inline auto operator()(Stream &inStream, T &dest) const -> result<void>
+    {
+        using stringref_stream = stateful_stream<Stream, stringref_dictionary>;
+
+        stringref_dictionary dictionary;
+        stringref_stream stringrefStream(inStream, dictionary);
+        return (*this)(stringrefStream, dest);
+    }
+
+} decode_stringref{};
+
+} // namespace dplx::dp
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <dplx/dp/decoder/fixed_shape.hpp>
 #include <dplx/dp/decoder/utils.hpp>
 #include <dplx/dp/fwd.hpp>
 #include <dplx/dp/item_parser.hpp>
@@ -92,6 +93,16 @@ public:
     inline auto operator()(Stream &inStream, value_type &dest) const
             -> result<void>
     {
+        if constexpr (single_pass_decodable_from<T, Stream>)
+        {
+            DPLX_TRY(auto decoded,
+                     detail::try_decode_single_pass(inStream, dest));
+            if (decoded)
+            {
+                return oc::success();
+            }
+        }
+
         DPLX_TRY(auto &&headInfo,
                  dp::parse_tuple_head<Stream, layout_descriptor_for_v<T>.version
                                                       != null_def_version>(
@@ -0,0 +1,419 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/type_code.hpp>
+#include <dplx/dp/value.hpp>
+
+namespace dplx::dp
+{
+
+// the nodes are allocated from the value_arena attached to the stream, see
+// stateful_stream. Definite length arrays and maps are allocated upfront with
+// their final size. Indefinite length items are collected in a temporary
+// buffer and copied into the arena afterwards. Items which are nested deeper
+// than value_arena::max_nesting_depth() are rejected with
+// errc::nesting_depth_exceeded.
+template <input_stream Stream>
+    requires has_stream_state<Stream, value_arena>
+class basic_decoder<value, Stream>
+{
+    using access = detail::value_access;
+
+public:
+    using value_type = value;
+
+    auto operator()(Stream &inStream, value &dest) const -> result<void>
+    {
+        auto &arena = get_stream_state<value_arena>(inStream);
+        DPLX_TRY(item_info const item, detail::parse_item(inStream));
+        return decode_item(inStream, arena, item, 0u, dest);
+    }
+
+private:
+    // depth is the number of arrays, maps and tags enclosing the item
+    static auto decode_item(Stream &inStream,
+                            value_arena &arena,
+                            item_info const &item,
+                            std::size_t const depth,
+                            value &dest) -> result<void>
+    {
+        if ((item.type == type_code::array || item.type == type_code::map
+             || item.type == type_code::tag)
+            && depth >= arena.max_nesting_depth())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::nesting_depth_exceeded;
+            }
+
+        switch (item.type)
+        {
+        case type_code::posint:
+            dest = access::make_integer(item.value, false);
+            return oc::success();
+
+        case type_code::negint:
+            dest = access::make_integer(item.value, true);
+            return oc::success();
+
+        case type_code::binary:
+            return decode_string(inStream, arena, item, value_kind::binary,
+                                 dest);
+        case type_code::text:
+            return decode_string(inStream, arena, item, value_kind::text,
+                                 dest);
+
+        case type_code::array:
+            return item.indefinite()
+                         ? decode_indefinite_array(inStream, arena, depth + 1u,
+                                                   dest)
+                         : decode_array(inStream, arena, item.value, depth + 1u,
+                                        dest);
+        case type_code::map:
+            return item.indefinite()
+                         ? decode_indefinite_map(inStream, arena, depth + 1u,
+                                                 dest)
+                         : decode_map(inStream, arena, item.value, depth + 1u,
+                                      dest);
+
+        case type_code::tag:
+        {
+            DPLX_TRY(value * nodes, arena.allocate_nodes<value>(2u));
+            nodes[0] = access::make_integer(item.value, false);
+            DPLX_TRY(decode_next(inStream, arena, depth + 1u, nodes[1]));
+            dest = access::make_reference(value_kind::tag, nodes, 2u);
+            return oc::success();
+        }
+
+        case type_code::special:
+            return decode_special(item, dest);
+
+        default:
+            return errc::item_type_mismatch;
+        }
+    }
+
+    static auto decode_next(Stream &inStream,
+                            value_arena &arena,
+                            std::size_t const depth,
+                            value &dest) -> result<void>
+    {
+        DPLX_TRY(item_info const item, detail::parse_item(inStream));
+        if (item.is_special_break())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_type_mismatch;
+            }
+        return decode_item(inStream, arena, item, depth, dest);
+    }
+
+    static auto decode_special(item_info const &item, value &dest)
+            -> result<void>
+    {
+        switch (item.encoded_length)
+        {
+        case 1u:
+        {
+            auto const code = static_cast<type_code>(
+                    to_byte(type_code::special)
+                    | static_cast<std::byte>(item.value));
+            switch (code)
+            {
+            case type_code::bool_false:
+                dest = access::make_boolean(false);
+                return oc::success();
+            case type_code::bool_true:
+                dest = access::make_boolean(true);
+                return oc::success();
+            case type_code::null:
+                dest = value();
+                return oc::success();
+            case type_code::undefined:
+                dest = value::undefined();
+                return oc::success();
+            default:
+                // other simple values are not supported
+                return errc::item_type_mismatch;
+            }
+        }
+
+        case 3u:
+            // half precision floats are re-encoded with single precision
+            // which is lossless
+            dest = access::make_float(detail::load_iec559_half(
+                                              static_cast<std::uint16_t>(
+                                                      item.value)),
+                                      sizeof(float));
+            return oc::success();
+
+        case 5u:
+        {
+            float number;
+            std::memcpy(&number, &item.value, sizeof(number)); // #bit_cast
+            dest = access::make_float(number, sizeof(float));
+            return oc::success();
+        }
+        case 9u:
+        {
+            double number;
+            std::memcpy(&number, &item.value, sizeof(number)); // #bit_cast
+            dest = access::make_float(number, sizeof(double));
+            return oc::success();
+        }
+
+        default:
+            return errc::item_type_mismatch;
+        }
+    }
+
+    static auto decode_string(Stream &inStream,
+                              value_arena &arena,
+                              item_info const &item,
+                              value_kind const kind,
+                              value &dest) -> result<void>
+    {
+        if (item.indefinite())
+        {
+            return decode_indefinite_string(inStream, arena, item.type, kind,
+                                            dest);
+        }
+
+        DPLX_TRY(auto const availableBytes, dp::available_input_size(inStream));
+        if (availableBytes < item.value)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::missing_data;
+            }
+        DPLX_TRY(auto const size, value_arena::checked_size(item.value));
+
+        if (size <= access::inline_capacity)
+        {
+            std::byte buffer[access::inline_capacity];
+            if (size > 0u)
+            {
+                DPLX_TRY(dp::read(inStream, buffer, size));
+            }
+            dest = access::make_string(kind, buffer, size);
+            return oc::success();
+        }
+
+        DPLX_TRY(std::byte * memory, arena.allocate(size, 1u));
+        DPLX_TRY(dp::read(inStream, memory, size));
+        dest = access::make_string(kind, memory, size);
+        return oc::success();
+    }
+
+    static auto decode_indefinite_string(Stream &inStream,
+                                         value_arena &arena,
+                                         type_code const type,
+                                         value_kind const kind,
+                                         value &dest) -> result<void>
+    {
+        std::vector<std::byte> content;
+        for (;;)
+        {
+            DPLX_TRY(item_info const chunk, detail::parse_item(inStream));
+            if (chunk.is_special_break())
+            {
+                break;
+            }
+            if (chunk.type != type || chunk.indefinite())
+                DPLX_ATTR_UNLIKELY
+                {
+                    return errc::invalid_indefinite_subitem;
+                }
+
+            DPLX_TRY(auto const availableBytes,
+                     dp::available_input_size(inStream));
+            if (availableBytes < chunk.value)
+                DPLX_ATTR_UNLIKELY
+                {
+                    return errc::missing_data;
+                }
+
+            auto const offset = content.size();
+            try
+            {
+                content.resize(offset + static_cast<std::size_t>(chunk.value));
+            }
+            catch (std::bad_alloc const &)
+            {
+                return errc::not_enough_memory;
+            }
+            if (chunk.value > 0u)
+            {
+                DPLX_TRY(dp::read(inStream, content.data() + offset,
+                                  static_cast<std::size_t>(chunk.value)));
+            }
+        }
+
+        DPLX_TRY(dest, kind == value_kind::text
+                               ? arena.make_text(std::u8string_view(
+                                       reinterpret_cast<char8_t const *>(
+                                               content.data()),
+                                       content.size()))
+                               : arena.make_binary(content));
+        return oc::success();
+    }
+
+    static auto decode_array(Stream &inStream,
+                             value_arena &arena,
+                             std::uint64_t const numElements,
+                             std::size_t const depth,
+                             value &dest) -> result<void>
+    {
+        // each element occupies at least one byte
+        DPLX_TRY(auto const availableBytes, dp::available_input_size(inStream));
+        if (availableBytes < numElements)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::missing_data;
+            }
+        DPLX_TRY(auto const size, value_arena::checked_size(numElements));
+
+        DPLX_TRY(value * nodes, arena.allocate_nodes<value>(size));
+        for (std::uint32_t i = 0u; i < size; ++i)
+        {
+            DPLX_TRY(decode_next(inStream, arena, depth, nodes[i]));
+        }
+        dest = access::make_reference(value_kind::array, nodes, size);
+        return oc::success();
+    }
+
+    static auto decode_map(Stream &inStream,
+                           value_arena &arena,
+                           std::uint64_t const numEntries,
+                           std::size_t const depth,
+                           value &dest) -> result<void>
+    {
+        // each entry occupies at least two bytes
+        DPLX_TRY(auto const availableBytes, dp::available_input_size(inStream));
+        if (availableBytes / 2u < numEntries)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::missing_data;
+            }
+        DPLX_TRY(auto const size, value_arena::checked_size(numEntries));
+
+        DPLX_TRY(value_map_entry * entries,
+                 arena.allocate_nodes<value_map_entry>(size));
+        for (std::uint32_t i = 0u; i < size; ++i)
+        {
+            DPLX_TRY(decode_next(inStream, arena, depth, entries[i].key));
+            DPLX_TRY(decode_next(inStream, arena, depth, entries[i].mapped));
+        }
+        dest = access::make_reference(value_kind::map, entries, size);
+        return oc::success();
+    }
+
+    static auto decode_indefinite_array(Stream &inStream,
+                                        value_arena &arena,
+                                        std::size_t const depth,
+                                        value &dest) -> result<void>
+    {
+        std::vector<value> elements;
+        for (;;)
+        {
+            DPLX_TRY(item_info const item, detail::parse_item(inStream));
+            if (item.is_special_break())
+            {
+                break;
+            }
+
+            value element;
+            DPLX_TRY(decode_item(inStream, arena, item, depth, element));
+            try
+            {
+                elements.push_back(element);
+            }
+            catch (std::bad_alloc const &)
+            {
+                return errc::not_enough_memory;
+            }
+        }
+
+        DPLX_TRY(dest, arena.make_array(elements));
+        return oc::success();
+    }
+
+    static auto decode_indefinite_map(Stream &inStream,
+                                      value_arena &arena,
+                                      std::size_t const depth,
+                                      value &dest) -> result<void>
+    {
+        std::vector<value_map_entry> entries;
+        for (;;)
+        {
+            DPLX_TRY(item_info const item, detail::parse_item(inStream));
+            if (item.is_special_break())
+            {
+                break;
+            }
+
+            value_map_entry entry;
+            DPLX_TRY(decode_item(inStream, arena, item, depth, entry.key));
+            DPLX_TRY(decode_next(inStream, arena, depth, entry.mapped));
+            try
+            {
+                entries.push_back(entry);
+            }
+            catch (std::bad_alloc const &)
+            {
+                return errc::not_enough_memory;
+            }
+        }
+
+        DPLX_TRY(dest, arena.make_map(entries));
+        return oc::success();
+    }
+};
+
+// decodes the item into the document arena which is cleared beforehand, i.e.
+// its memory is reused
+template <input_stream Stream>
+class basic_decoder<document, Stream>
+{
+    using value_stream = stateful_stream<Stream, value_arena>;
+
+public:
+    using value_type = document;
+
+    auto operator()(Stream &inStream, document &dest) const -> result<void>
+    {
+        dest.clear();
+
+        value_stream valueStream(inStream, dest.arena());
+        value root;
+        if (auto decodeRx
+            = basic_decoder<value, value_stream>()(valueStream, root);
+            decodeRx.has_failure())
+            DPLX_ATTR_UNLIKELY
+            {
+                dest.clear();
+                return std::move(decodeRx).as_failure();
+            }
+
+        dest.assign_root(root);
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,169 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <concepts>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/type_code.hpp>
+#include <dplx/dp/value_sharing.hpp>
+
+namespace dplx::dp::detail
+{
+
+// returns the number of the tag at the stream position if it is encoded
+// with a one byte argument (24-255) and zero otherwise. Nothing is consumed.
+template <input_stream Stream>
+inline auto peek_small_tag(Stream &inStream) -> result<std::uint64_t>
+{
+    constexpr auto smallTagByte = to_byte(type_code::tag) | std::byte{24};
+
+    DPLX_TRY(std::byte const initialByte, detail::peek_initial_byte(inStream));
+    if (initialByte != smallTagByte)
+    {
+        return 0u;
+    }
+    DPLX_TRY(auto &&readProxy, dp::read(inStream, 2u));
+    auto const number = std::ranges::data(readProxy)[1];
+    DPLX_TRY(dp::consume(inStream, readProxy, 0u));
+    return static_cast<std::uint64_t>(number);
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// null decodes to an empty pointer, otherwise a new object is allocated.
+// References (tag 29) require a sharing_table attached to the stream, see
+// decode_sharing. Shareable tags (tag 28) are ignored without one.
+template <typename T, input_stream Stream>
+    requires(decodable<std::remove_cv_t<T>, Stream>
+             && std::default_initializable<std::remove_cv_t<T>>)
+class basic_decoder<std::shared_ptr<T>, Stream>
+{
+    using element_type = std::remove_cv_t<T>;
+    using element_decoder = basic_decoder<element_type, Stream>;
+
+public:
+    using value_type = std::shared_ptr<T>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        DPLX_TRY(std::byte const initialByte,
+                 detail::peek_initial_byte(inStream));
+        if (initialByte == to_byte(type_code::null))
+        {
+            DPLX_TRY(detail::parse_item(inStream));
+            dest.reset();
+            return oc::success();
+        }
+
+        DPLX_TRY(std::uint64_t const tagNumber,
+                 detail::peek_small_tag(inStream));
+        if (tagNumber == shared_reference_tag)
+        {
+            return decode_reference(inStream, dest);
+        }
+        if (tagNumber == shareable_tag)
+        {
+            DPLX_TRY(detail::parse_item(inStream));
+        }
+
+        std::shared_ptr<element_type> object;
+        try
+        {
+            object = std::make_shared<element_type>();
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        if constexpr (has_stream_state<Stream, sharing_table>)
+        {
+            // registered upfront, i.e. cyclic references resolve
+            if (tagNumber == shareable_tag)
+            {
+                auto &table = dp::get_stream_state<sharing_table>(inStream);
+                DPLX_TRY(table.add(object));
+            }
+        }
+
+        DPLX_TRY(element_decoder()(inStream, *object));
+        dest = std::move(object);
+        return oc::success();
+    }
+
+private:
+    static auto decode_reference(Stream &inStream, value_type &dest)
+            -> result<void>
+    {
+        if constexpr (has_stream_state<Stream, sharing_table>)
+        {
+            DPLX_TRY(detail::parse_item(inStream));
+            DPLX_TRY(dp::item_info const indexItem,
+                     detail::parse_item(inStream));
+            if (indexItem.type != type_code::posint)
+            {
+                return errc::item_type_mismatch;
+            }
+
+            auto const &table = dp::get_stream_state<sharing_table>(inStream);
+            DPLX_TRY(dest, table.template find<element_type>(indexItem.value));
+            return oc::success();
+        }
+        else
+        {
+            (void)inStream;
+            (void)dest;
+            return errc::item_type_mismatch;
+        }
+    }
+};
+
+// decodes the value with a sharing_table attached to the stream. A table
+// which is already attached is cleared and reused.
+inline constexpr struct decode_sharing_fn final
+{
+    template <typename T, input_stream Stream>
+        requires(has_stream_state<Stream, sharing_table>
+                 && decodable<T, Stream>)
+    inline auto operator()(Stream &inStream, T &dest) const -> result<void>
+    {
+        dp::get_stream_state<sharing_table>(inStream).clear();
+        DPLX_TRY((basic_decoder<T, Stream>()(inStream, dest)));
+        return success();
+    }
+
+    template <typename T, input_stream Stream>
+        requires(!has_stream_state<Stream, sharing_table>
+                 && decodable<T, stateful_stream<Stream, sharing_table>>)
+    inline auto operator()(Stream &inStream, T &dest) const -> result<void>
+    {
+        using sharing_stream = stateful_stream<Stream, sharing_table>;
+
+        sharing_table table;
+        sharing_stream sharingStream(inStream, table);
+        return (*this)(sharingStream, dest);
+    }
+
+} decode_sharing{};
+
+} // namespace dplx::dp
@@ -0,0 +1,432 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <variant>
+
+#include <boost/mp11/algorithm.hpp>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_parser.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/type_code.hpp>
+#include <dplx/dp/value_sharing.hpp>
+#include <dplx/dp/variant.hpp>
+
+namespace dplx::dp::detail
+{
+
+// the variant_dispatch_table entries which don't name an alternative
+inline constexpr std::uint8_t no_alternative = 0xffu;
+inline constexpr std::uint8_t tag_dispatch = 0xfeu;
+
+// maps every initial byte to the alternative whose encoding starts with it.
+// Bytes starting a tag which is claimed by tagged alternatives map to
+// tag_dispatch, i.e. the tag number selects the alternative.
+template <typename... Ts>
+constexpr auto make_variant_dispatch_table() noexcept
+        -> std::array<std::uint8_t, 256>
+{
+    std::array<initial_item_set, sizeof...(Ts)> const sets{
+            initial_items_of_v<Ts>...};
+
+    std::array<std::uint8_t, 256> table{};
+    table.fill(no_alternative);
+    for (std::size_t i = 0u; i < sets.size(); ++i)
+    {
+        for (std::size_t initialByte = 0u; initialByte < table.size();
+             ++initialByte)
+        {
+            if (sets[i].contains(initialByte))
+            {
+                table[initialByte] = sets[i].is_tagged
+                                           ? tag_dispatch
+                                           : static_cast<std::uint8_t>(i);
+            }
+        }
+    }
+    return table;
+}
+
+// each initial byte may only start the encoding of one alternative unless
+// all alternatives starting with it are tagged with distinct tag numbers
+template <typename... Ts>
+constexpr auto variant_dispatch_is_unambiguous() noexcept -> bool
+{
+    std::array<initial_item_set, sizeof...(Ts)> const sets{
+            initial_items_of_v<Ts>...};
+
+    for (std::size_t i = 0u; i < sets.size(); ++i)
+    {
+        if (sets[i].empty())
+        {
+            return false;
+        }
+        for (std::size_t j = i + 1u; j < sets.size(); ++j)
+        {
+            if (sets[i].is_tagged && sets[j].is_tagged)
+            {
+                if (sets[i].tag == sets[j].tag)
+                {
+                    return false;
+                }
+                continue;
+            }
+            for (std::size_t k = 0u; k < sets[i].bytes.size(); ++k)
+            {
+                if ((sets[i].bytes[k] & sets[j].bytes[k]) != 0u)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename... Ts>
+inline constexpr std::array<std::uint8_t, 256> variant_dispatch_table
+        = detail::make_variant_dispatch_table<Ts...>();
+
+// returns the number of the tag at the stream position. Nothing is consumed.
+template <input_stream Stream>
+inline auto peek_tag_number(Stream &inStream) -> result<std::uint64_t>
+{
+    DPLX_TRY(std::byte const initialByte, detail::peek_initial_byte(inStream));
+    auto const additionalInfo
+            = std::to_integer<unsigned int>(initialByte) & 0b000'11111u;
+    if (additionalInfo <= detail::inline_value_max)
+    {
+        return static_cast<std::uint64_t>(additionalInfo);
+    }
+    if (additionalInfo > 27u)
+    {
+        return errc::invalid_additional_information;
+    }
+
+    auto const numBytes = std::size_t{1} << (additionalInfo - 24u);
+    DPLX_TRY(auto &&readProxy, dp::read(inStream, 1u + numBytes));
+    auto const *const data = std::ranges::data(readProxy);
+    std::uint64_t number = 0u;
+    for (std::size_t i = 1u; i <= numBytes; ++i)
+    {
+        number = (number << 8) | std::to_integer<std::uint64_t>(data[i]);
+    }
+    DPLX_TRY(dp::consume(inStream, readProxy, 0u));
+    return number;
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+template <typename T, input_stream Stream>
+    requires(decodable<T, Stream> && std::default_initializable<T>)
+class basic_decoder<std::optional<T>, Stream>
+{
+public:
+    using value_type = std::optional<T>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        DPLX_TRY(std::byte const initialByte,
+                 detail::peek_initial_byte(inStream));
+        if (initialByte == to_byte(type_code::null))
+        {
+            DPLX_TRY(detail::parse_item(inStream));
+            dest.reset();
+            return oc::success();
+        }
+
+        if (!dest.has_value())
+        {
+            try
+            {
+                dest.emplace();
+            }
+            catch (std::bad_alloc const &)
+            {
+                return errc::not_enough_memory;
+            }
+        }
+        return basic_decoder<T, Stream>()(inStream, *dest);
+    }
+};
+
+template <std::uint64_t Tag, typename T, input_stream Stream>
+    requires decodable<T, Stream>
+class basic_decoder<tagged<Tag, T>, Stream>
+{
+public:
+    using value_type = tagged<Tag, T>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        DPLX_TRY(dp::item_info const tagItem, detail::parse_item(inStream));
+        if (tagItem.type != type_code::tag || tagItem.value != Tag)
+        {
+            return errc::item_type_mismatch;
+        }
+        return basic_decoder<T, Stream>()(inStream, dest.value);
+    }
+};
+
+// the active alternative is kept if it is selected again, i.e. its state
+// is decoded into like any other value
+template <typename... Ts, input_stream Stream>
+    requires((decodable<Ts, Stream> && std::default_initializable<Ts>)&&...)
+class basic_decoder<std::variant<Ts...>, Stream>
+{
+    using parse = item_parser<Stream>;
+
+    static constexpr std::size_t num_alternatives = sizeof...(Ts);
+    static constexpr bool indexed
+            = variant_encoding_for<std::variant<Ts...>>
+           == variant_encoding::indexed;
+
+    static_assert(num_alternatives < detail::tag_dispatch);
+    static_assert(indexed || detail::variant_dispatch_is_unambiguous<Ts...>(),
+                  "the initial items of the variant alternatives overlap or "
+                  "are unknown; specialize initial_items_of or use the "
+                  "indexed variant_encoding");
+
+public:
+    using value_type = std::variant<Ts...>;
+
+    auto operator()(Stream &inStream, value_type &dest) const -> result<void>
+    {
+        if constexpr (indexed)
+        {
+            DPLX_TRY(dp::item_info const arrayInfo,
+                     detail::parse_item(inStream));
+            if (arrayInfo.type != type_code::array)
+            {
+                return errc::item_type_mismatch;
+            }
+            if (arrayInfo.indefinite() || arrayInfo.value != 2u)
+            {
+                return errc::tuple_size_mismatch;
+            }
+            DPLX_TRY(std::uint64_t const index,
+                     parse::template integer<std::uint64_t>(inStream));
+            if (index >= num_alternatives)
+            {
+                return errc::item_value_out_of_range;
+            }
+            return decode_alternative(inStream, dest,
+                                      static_cast<std::size_t>(index));
+        }
+        else
+        {
+            constexpr auto const &table = detail::variant_dispatch_table<Ts...>;
+
+            DPLX_TRY(std::byte const initialByte,
+                     detail::peek_initial_byte(inStream));
+            if constexpr (looks_through_tags)
+            {
+                if (initialByte == small_tag_byte)
+                {
+                    DPLX_TRY(std::size_t const index,
+                             peek_looked_through(inStream));
+                    return decode_alternative(inStream, dest, index);
+                }
+            }
+            std::size_t index
+                    = table[std::to_integer<std::size_t>(initialByte)];
+            if (index == detail::tag_dispatch)
+            {
+                DPLX_TRY(std::uint64_t const tagNumber,
+                         detail::peek_tag_number(inStream));
+                index = index_of_tag(tagNumber);
+            }
+            if (index == detail::no_alternative)
+            {
+                return errc::item_type_mismatch;
+            }
+            return decode_alternative(inStream, dest, index);
+        }
+    }
+
+private:
+    // the stringref and value sharing tags (all of which have one byte
+    // arguments) are emitted by the codecs of the alternatives if the
+    // corresponding stream states are attached
+    static constexpr bool resolves_stringrefs
+            = has_stream_state<Stream, stringref_dictionary>;
+    static constexpr bool resolves_shared_references
+            = has_stream_state<Stream, sharing_table>;
+    static constexpr bool looks_through_tags
+            = resolves_stringrefs || resolves_shared_references;
+    static constexpr std::byte small_tag_byte
+            = to_byte(type_code::tag) | std::byte{24};
+
+    // shareable tag, stringref tag and the string index
+    static constexpr std::size_t max_lookahead = 2u + 2u + 9u;
+
+    static auto peek_looked_through(Stream &inStream) -> result<std::size_t>
+    {
+        DPLX_TRY(std::size_t const availableBytes,
+                 dp::available_input_size(inStream));
+        DPLX_TRY(auto &&readProxy,
+                 dp::read(inStream, std::min(availableBytes, max_lookahead)));
+        memory_view lookahead(std::span<std::byte const>(
+                std::ranges::data(readProxy), std::ranges::size(readProxy)));
+        auto selected = select_looked_through(inStream, lookahead);
+        DPLX_TRY(dp::consume(inStream, readProxy, 0u));
+        return selected;
+    }
+
+    // selects the alternative by the item a shareable tag is applied to,
+    // the type of the string a stringref refers to or the type of the object
+    // a shared reference refers to
+    static auto select_looked_through(Stream &inStream, memory_view &lookahead)
+            -> result<std::size_t>
+    {
+        constexpr auto const &table = detail::variant_dispatch_table<Ts...>;
+
+        DPLX_TRY(std::byte const initialByte,
+                 detail::peek_initial_byte(lookahead));
+        DPLX_TRY(dp::item_info const item, detail::parse_item(lookahead));
+        std::size_t index = table[std::to_integer<std::size_t>(initialByte)];
+        if (item.type == type_code::tag)
+        {
+            if constexpr (resolves_shared_references)
+            {
+                if (item.value == shareable_tag)
+                {
+                    return select_looked_through(inStream, lookahead);
+                }
+                if (item.value == shared_reference_tag)
+                {
+                    DPLX_TRY(std::uint64_t const objectIndex,
+                             parse_index(lookahead));
+                    index = index_of_reference(
+                            dp::get_stream_state<sharing_table>(inStream),
+                            objectIndex);
+                }
+            }
+            if constexpr (resolves_stringrefs)
+            {
+                if (item.value == stringref_tag)
+                {
+                    DPLX_TRY(std::uint64_t const stringIndex,
+                             parse_index(lookahead));
+                    auto const &dictionary
+                            = dp::get_stream_state<stringref_dictionary>(
+                                    inStream);
+                    DPLX_TRY(auto const str, dictionary.find(stringIndex));
+                    index = table[static_cast<std::size_t>(
+                            str.text ? type_code::text : type_code::binary)];
+                }
+            }
+            if (index == detail::tag_dispatch)
+            {
+                index = index_of_tag(item.value);
+            }
+        }
+        if (index == detail::no_alternative)
+        {
+            return errc::item_type_mismatch;
+        }
+        return index;
+    }
+
+    static auto parse_index(memory_view &lookahead) -> result<std::uint64_t>
+    {
+        DPLX_TRY(dp::item_info const indexItem, detail::parse_item(lookahead));
+        if (indexItem.type != type_code::posint)
+        {
+            return errc::item_type_mismatch;
+        }
+        return indexItem.value;
+    }
+
+    static auto index_of_reference(sharing_table const &table,
+                                   std::uint64_t const objectIndex) noexcept
+            -> std::size_t
+    {
+        std::size_t index = detail::no_alternative;
+        boost::mp11::mp_for_each<boost::mp11::mp_iota_c<num_alternatives>>(
+                [&](auto const i) {
+                    using alternative_type
+                            = std::variant_alternative_t<i, value_type>;
+                    if constexpr (detail::is_std_shared_ptr_v<
+                                          alternative_type>)
+                    {
+                        using element_type = std::remove_cv_t<
+                                typename alternative_type::element_type>;
+                        if (index == detail::no_alternative
+                            && table.template holds<element_type>(
+                                    objectIndex))
+                        {
+                            index = i;
+                        }
+                    }
+                });
+        return index;
+    }
+
+    static constexpr auto index_of_tag(std::uint64_t const tagNumber) noexcept
+            -> std::size_t
+    {
+        constexpr std::array<initial_item_set, num_alternatives> sets{
+                initial_items_of_v<Ts>...};
+
+        for (std::size_t i = 0u; i < sets.size(); ++i)
+        {
+            if (sets[i].is_tagged && sets[i].tag == tagNumber)
+            {
+                return i;
+            }
+        }
+        return detail::no_alternative;
+    }
+
+    static auto decode_alternative(Stream &inStream,
+                                   value_type &dest,
+                                   std::size_t const index) -> result<void>
+    {
+        return boost::mp11::mp_with_index<num_alternatives>(
+                index, [&](auto const i) -> result<void> {
+                    using alternative_type
+                            = std::variant_alternative_t<i, value_type>;
+
+                    if (dest.index() != i)
+                    {
+                        try
+                        {
+                            dest.template emplace<i>();
+                        }
+                        catch (std::bad_alloc const &)
+                        {
+                            return errc::not_enough_memory;
+                        }
+                    }
+                    return basic_decoder<alternative_type, Stream>()(
+                            inStream, *std::get_if<i>(&dest));
+                });
+    }
+};
+
+} // namespace dplx::dp
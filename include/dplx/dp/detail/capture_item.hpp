@@ -0,0 +1,231 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <new>
+#include <span>
+#include <vector>
+
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/skip_item.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/streams/recording_input_stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/type_code.hpp>
+#include <dplx/dp/value_sharing.hpp>
+
+namespace dplx::dp::detail
+{
+
+template <typename T>
+inline constexpr bool is_memory_buffer_v = false;
+template <typename T>
+inline constexpr bool is_memory_buffer_v<basic_memory_buffer<T>> = true;
+
+// skips the next item and returns the memory it occupies within the buffer
+template <typename T>
+inline auto capture_item_view(basic_memory_buffer<T> &inStream)
+        -> result<std::span<std::byte const>>
+{
+    std::byte const *const begin = inStream.remaining_begin();
+    DPLX_TRY(dp::skip_item(inStream));
+
+    return std::span<std::byte const>(begin, inStream.remaining_begin());
+}
+
+// skips the next item and appends its encoded form to the given vector
+template <input_stream Stream>
+inline auto capture_raw_item(Stream &inStream, std::vector<std::byte> &encoded)
+        -> result<void>
+{
+    if constexpr (is_memory_buffer_v<Stream>)
+    {
+        DPLX_TRY(auto const item, detail::capture_item_view(inStream));
+        try
+        {
+            encoded.insert(encoded.end(), item.begin(), item.end());
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        return oc::success();
+    }
+    else
+    {
+        recording_input_stream<Stream> recordingStream(inStream, encoded);
+        return dp::skip_item(recordingStream);
+    }
+}
+
+// whether captured items must be reconciled with the stream states
+template <typename Stream>
+inline constexpr bool captures_stream_state
+        = has_stream_state<Stream, stringref_dictionary>
+       || has_stream_state<Stream, sharing_table>;
+
+// parses the index of a reference from itemStream and appends the
+// referenced string
+template <input_stream Stream>
+    requires has_stream_state<Stream, stringref_dictionary>
+inline auto append_referenced_string(Stream &inStream,
+                                     memory_view &itemStream,
+                                     std::vector<std::byte> &resolved)
+        -> result<void>
+{
+    auto const &dictionary
+            = dp::get_stream_state<stringref_dictionary>(inStream);
+
+    DPLX_TRY(dp::item_info const index, detail::parse_item(itemStream));
+    if (index.type != type_code::posint)
+    {
+        return errc::item_type_mismatch;
+    }
+    DPLX_TRY(auto const str, dictionary.find(index.value));
+
+    std::byte strHead[var_uint_max_size];
+    auto const strHeadSize = detail::store_var_uint(
+            strHead, static_cast<std::uint64_t>(str.content.size()),
+            to_byte(str.text ? type_code::text : type_code::binary));
+    try
+    {
+        resolved.insert(resolved.end(), strHead, strHead + strHeadSize);
+        resolved.insert(resolved.end(), str.content.begin(),
+                        str.content.end());
+    }
+    catch (std::bad_alloc const &)
+    {
+        return errc::not_enough_memory;
+    }
+    return oc::success();
+}
+
+// appends the captured item to resolved while taking part in the stringref
+// namespace of the stream, i.e. its strings are registered with the
+// stringref_dictionary and references are replaced by the referenced
+// strings. Therefore the result can be decoded on its own. Nested
+// namespaces are rejected. So are shareable items and shared references if
+// a sharing_table is attached, because the table can only hold decoded
+// objects.
+template <input_stream Stream>
+    requires captures_stream_state<Stream>
+inline auto resolve_captured_item(Stream &inStream,
+                                  std::span<std::byte const> const item,
+                                  std::vector<std::byte> &resolved)
+        -> result<void>
+{
+    constexpr bool hasStringrefs
+            = has_stream_state<Stream, stringref_dictionary>;
+
+    memory_view itemStream(item);
+    // the chunks of indefinite strings aren't assigned an index
+    bool inChunks = false;
+    while (itemStream.remaining_size() > 0u)
+    {
+        std::byte const *const begin = itemStream.remaining_begin();
+        DPLX_TRY(dp::item_info const head, detail::parse_item(itemStream));
+
+        if constexpr (has_stream_state<Stream, sharing_table>)
+        {
+            if (head.type == type_code::tag
+                && (head.value == shareable_tag
+                    || head.value == shared_reference_tag))
+            {
+                return errc::unsupported_raw_item;
+            }
+        }
+        if constexpr (hasStringrefs)
+        {
+            if (head.type == type_code::tag
+                && head.value == stringref_namespace_tag)
+            {
+                return errc::unsupported_raw_item;
+            }
+            if (head.type == type_code::tag && head.value == stringref_tag)
+            {
+                DPLX_TRY(detail::append_referenced_string(inStream,
+                                                          itemStream,
+                                                          resolved));
+                continue;
+            }
+        }
+
+        if (head.type == type_code::text || head.type == type_code::binary)
+        {
+            if (head.indefinite())
+            {
+                inChunks = true;
+            }
+            else
+            {
+                if (itemStream.remaining_size() < head.value)
+                    DPLX_ATTR_UNLIKELY
+                    {
+                        return errc::missing_data;
+                    }
+                auto const size = static_cast<std::size_t>(head.value);
+                if constexpr (hasStringrefs)
+                {
+                    if (!inChunks)
+                    {
+                        auto &dictionary
+                                = dp::get_stream_state<stringref_dictionary>(
+                                        inStream);
+                        DPLX_TRY(dictionary.add(head.type == type_code::text,
+                                                itemStream.remaining_begin(),
+                                                size));
+                    }
+                }
+                DPLX_TRY(dp::skip_bytes(itemStream, size));
+            }
+        }
+        else if (head.is_special_break())
+        {
+            inChunks = false;
+        }
+
+        try
+        {
+            resolved.insert(resolved.end(), begin,
+                            itemStream.remaining_begin());
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+    }
+    return oc::success();
+}
+
+// skips the next item and appends its encoded form to the given vector. The
+// captured item is reconciled with the stream states, see
+// resolve_captured_item().
+template <input_stream Stream>
+inline auto capture_item(Stream &inStream, std::vector<std::byte> &encoded)
+        -> result<void>
+{
+    if constexpr (captures_stream_state<Stream>)
+    {
+        std::vector<std::byte> item;
+        DPLX_TRY(detail::capture_raw_item(inStream, item));
+        return detail::resolve_captured_item(inStream, item, encoded);
+    }
+    else
+    {
+        return detail::capture_raw_item(inStream, encoded);
+    }
+}
+
+} // namespace dplx::dp::detail
@@ -0,0 +1,73 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <concepts>
+#include <span>
+#include <string_view>
+
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// compares a text string key without materializing it
+inline auto is_text_key(std::span<std::byte const> const encodedKey,
+                        std::u8string_view const key) noexcept -> bool
+{
+    memory_view keyStream{encodedKey};
+    auto const parseRx = detail::parse_item(keyStream);
+    if (!parseRx || parseRx.assume_value().type != type_code::text
+        || parseRx.assume_value().indefinite())
+    {
+        return false;
+    }
+    auto const &info = parseRx.assume_value();
+    return info.value == key.size()
+        && keyStream.remaining_size() == key.size()
+        && (key.empty()
+            || std::memcmp(keyStream.remaining_begin(), key.data(), key.size())
+                       == 0);
+}
+
+inline auto is_integer_key(std::span<std::byte const> const encodedKey,
+                           std::uint64_t const key) noexcept -> bool
+{
+    memory_view keyStream{encodedKey};
+    auto const parseRx = detail::parse_item(keyStream);
+    return parseRx && parseRx.assume_value().type == type_code::posint
+        && parseRx.assume_value().value == key
+        && keyStream.remaining_size() == 0u;
+}
+
+// dispatches on the kind of property id, i.e. text or (positive) integer
+template <typename Id>
+inline auto is_map_key(std::span<std::byte const> const encodedKey,
+                       Id const &key) noexcept -> bool
+{
+    if constexpr (std::convertible_to<Id const &, std::u8string_view>)
+    {
+        return detail::is_text_key(encodedKey, key);
+    }
+    else
+    {
+        static_assert(integer<Id>, "property ids are text or integers");
+        return !(key < Id{})
+            && detail::is_integer_key(encodedKey,
+                                      static_cast<std::uint64_t>(key));
+    }
+}
+
+} // namespace dplx::dp::detail
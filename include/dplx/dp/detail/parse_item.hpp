@@ -225,6 +225,16 @@ inline auto parse_item(Stream &stream) noexcept(
     }
 }
 
+// reads the initial byte of the next item without consuming it
+template <input_stream Stream>
+inline auto peek_initial_byte(Stream &inStream) -> result<std::byte>
+{
+    DPLX_TRY(auto &&readProxy, dp::read(inStream, 1u));
+    auto const initialByte = std::ranges::data(readProxy)[0];
+    DPLX_TRY(dp::consume(inStream, readProxy, 0u));
+    return initialByte;
+}
+
 static inline auto load_iec559_half(std::uint16_t bits) noexcept -> double
 {
     // IEC 60559:2011 half precision
@@ -86,8 +86,10 @@ struct perfect_hasher
 {
     static constexpr KeyHash key_hash{};
     static constexpr std::uint64_t initial_seed = 0x8000'0000'0000'0000;
-    static constexpr std::size_t remap_size = next_prime(N / 5);
-    static_assert(remap_size >= (N / 5));
+    // two keys per bucket on average; larger buckets make the seed search
+    // prohibitively expensive during constant evaluation of large key sets
+    static constexpr std::size_t remap_size = next_prime(N / 2);
+    static_assert(remap_size >= (N / 2));
 
     std::array<std::uint64_t, remap_size> remap;
     std::array<std::size_t, N> values;
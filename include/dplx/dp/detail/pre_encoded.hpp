@@ -0,0 +1,184 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <concepts>
+
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/layout_descriptor.hpp>
+#include <dplx/dp/object_def.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// constant evaluation friendly variant of store_var_uint()
+constexpr auto store_var_uint_static(std::byte *dest,
+                                     std::uint64_t const value,
+                                     std::byte const category) noexcept
+        -> std::size_t
+{
+    auto const size = detail::var_uint_encoded_size_branching(value);
+    if (size == 1u)
+    {
+        dest[0] = category | static_cast<std::byte>(value);
+        return 1u;
+    }
+
+    dest[0] = category
+            | static_cast<std::byte>(size == 2u   ? 24
+                                     : size == 3u ? 25
+                                     : size == 5u ? 26
+                                                  : 27);
+    for (unsigned int i = 1u; i < size; ++i)
+    {
+        dest[i] = static_cast<std::byte>(value >> ((size - 1u - i) * 8u));
+    }
+    return size;
+}
+
+template <typename T>
+inline constexpr bool is_fixed_u8string_v = false;
+template <std::size_t N>
+inline constexpr bool is_fixed_u8string_v<fixed_u8string<N>> = true;
+
+template <typename T>
+inline constexpr bool is_std_array_v = false;
+template <typename T, std::size_t N>
+inline constexpr bool is_std_array_v<std::array<T, N>> = true;
+
+// property ids which can be encoded during constant evaluation
+template <typename IdType>
+concept pre_encodable_property_id
+        = std::unsigned_integral<IdType> || is_fixed_u8string_v<IdType>;
+
+template <pre_encodable_property_id IdType>
+constexpr auto encoded_property_id_size(IdType const &id) noexcept
+        -> std::size_t
+{
+    if constexpr (std::unsigned_integral<IdType>)
+    {
+        return detail::var_uint_encoded_size_branching(id);
+    }
+    else
+    {
+        return detail::var_uint_encoded_size_branching(id.size()) + id.size();
+    }
+}
+
+template <pre_encodable_property_id IdType>
+constexpr void store_property_id(std::byte *dest, IdType const &id) noexcept
+{
+    if constexpr (std::unsigned_integral<IdType>)
+    {
+        detail::store_var_uint_static(dest, id, to_byte(type_code::posint));
+    }
+    else
+    {
+        auto const headSize = detail::store_var_uint_static(
+                dest, id.size(), to_byte(type_code::text));
+        for (std::size_t i = 0; i < id.size(); ++i)
+        {
+            dest[headSize + i] = static_cast<std::byte>(id.data()[i]);
+        }
+    }
+}
+
+// the complete encoded map key of a property
+template <typename PropDefType>
+inline constexpr auto encoded_property_id = []() {
+    std::array<std::byte, detail::encoded_property_id_size(PropDefType::id)>
+            encoded{};
+    detail::store_property_id(encoded.data(), PropDefType::id);
+    return encoded;
+}();
+
+// the encoded map key of a property within an object_def which is its
+// integer alias if the object_def opts into property aliases
+template <auto const &descriptor, typename PropDefType>
+inline constexpr auto encoded_property_key = []() {
+    if constexpr (descriptor.use_property_aliases
+                  && aliased_property<PropDefType>)
+    {
+        std::array<std::byte, detail::encoded_property_id_size(
+                                      PropDefType::alias)>
+                encoded{};
+        detail::store_property_id(encoded.data(), PropDefType::alias);
+        return encoded;
+    }
+    else
+    {
+        return encoded_property_id<PropDefType>;
+    }
+}();
+
+// the map header followed by the version property (if any)
+template <auto const &descriptor>
+inline constexpr auto encoded_object_head = []() {
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    constexpr std::size_t numItems = descriptor.num_properties + hasVersion;
+    constexpr std::size_t headSize
+            = detail::var_uint_encoded_size_branching(numItems)
+            + (hasVersion ? 1u + detail::var_uint_encoded_size_branching(
+                                    descriptor.version)
+                          : 0u);
+
+    std::array<std::byte, headSize> encoded{};
+    auto const mapHeadSize = detail::store_var_uint_static(
+            encoded.data(), numItems, to_byte(type_code::map));
+    if constexpr (hasVersion)
+    {
+        encoded[mapHeadSize] = std::byte{}; // version property id
+        detail::store_var_uint_static(encoded.data() + mapHeadSize + 1,
+                                      descriptor.version,
+                                      to_byte(type_code::posint));
+    }
+    return encoded;
+}();
+
+// the map header followed by the version property id
+template <auto const &descriptor>
+inline constexpr auto encoded_versioned_object_head = []() {
+    constexpr std::size_t numItems = descriptor.num_properties + 1;
+
+    std::array<std::byte,
+               detail::var_uint_encoded_size_branching(numItems) + 1u>
+            encoded{};
+    auto const mapHeadSize = detail::store_var_uint_static(
+            encoded.data(), numItems, to_byte(type_code::map));
+    encoded[mapHeadSize] = std::byte{}; // version property id
+    return encoded;
+}();
+
+// the array header followed by the version (if any)
+template <auto const &descriptor>
+inline constexpr auto encoded_tuple_head = []() {
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    constexpr std::size_t numItems = descriptor.num_properties + hasVersion;
+    constexpr std::size_t headSize
+            = detail::var_uint_encoded_size_branching(numItems)
+            + (hasVersion ? detail::var_uint_encoded_size_branching(
+                       descriptor.version)
+                          : 0u);
+
+    std::array<std::byte, headSize> encoded{};
+    auto const arrayHeadSize = detail::store_var_uint_static(
+            encoded.data(), numItems, to_byte(type_code::array));
+    if constexpr (hasVersion)
+    {
+        detail::store_var_uint_static(encoded.data() + arrayHeadSize,
+                                      descriptor.version,
+                                      to_byte(type_code::posint));
+    }
+    return encoded;
+}();
+
+} // namespace dplx::dp::detail
@@ -0,0 +1,113 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+#include <span>
+
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/type_code.hpp>
+#include <dplx/dp/value_sharing.hpp>
+
+namespace dplx::dp::detail
+{
+
+// whether spliced items must be reconciled with the stream states
+template <typename Stream>
+inline constexpr bool splices_stream_state
+        = has_stream_state<Stream, stringref_table>
+       || has_stream_state<Stream, sharing_index>;
+
+// registers the strings of an item which is written verbatim with the
+// stringref_table of the stream in the same way the decoder does. References
+// and nested namespaces are rejected as they belong to another namespace.
+// So are shareable items and shared references if a sharing_index is
+// attached, because the decoder would assign them indices unknown to it.
+template <output_stream Stream>
+    requires splices_stream_state<Stream>
+inline auto reconcile_spliced_item(Stream &outStream,
+                                   std::span<std::byte const> const item)
+        -> result<void>
+{
+    constexpr bool hasStringrefs = has_stream_state<Stream, stringref_table>;
+
+    memory_view itemStream(item);
+    // the chunks of indefinite strings aren't assigned an index
+    bool inChunks = false;
+    while (itemStream.remaining_size() > 0u)
+    {
+        DPLX_TRY(dp::item_info const head, detail::parse_item(itemStream));
+
+        if constexpr (has_stream_state<Stream, sharing_index>)
+        {
+            if (head.type == type_code::tag
+                && (head.value == shareable_tag
+                    || head.value == shared_reference_tag))
+            {
+                return errc::unsupported_raw_item;
+            }
+        }
+        if (hasStringrefs && head.type == type_code::tag
+            && (head.value == stringref_tag
+                || head.value == stringref_namespace_tag))
+        {
+            return errc::unsupported_raw_item;
+        }
+        if (head.type == type_code::text || head.type == type_code::binary)
+        {
+            if (head.indefinite())
+            {
+                inChunks = true;
+                continue;
+            }
+            if (itemStream.remaining_size() < head.value)
+                DPLX_ATTR_UNLIKELY
+                {
+                    return errc::missing_data;
+                }
+            auto const size = static_cast<std::size_t>(head.value);
+            if constexpr (hasStringrefs)
+            {
+                if (!inChunks)
+                {
+                    auto &table
+                            = dp::get_stream_state<stringref_table>(outStream);
+                    DPLX_TRY(table.insert(head.type == type_code::text,
+                                          itemStream.remaining_begin(), size));
+                }
+            }
+            DPLX_TRY(dp::skip_bytes(itemStream, size));
+        }
+        else if (head.is_special_break())
+        {
+            inChunks = false;
+        }
+    }
+    return oc::success();
+}
+
+// writes the encoded item verbatim. The item is reconciled with the stream
+// states, see reconcile_spliced_item().
+template <output_stream Stream>
+inline auto splice_item(Stream &outStream,
+                        std::span<std::byte const> const item) -> result<void>
+{
+    if constexpr (splices_stream_state<Stream>)
+    {
+        DPLX_TRY(detail::reconcile_spliced_item(outStream, item));
+    }
+    return dp::write(outStream, item.data(), item.size());
+}
+
+} // namespace dplx::dp::detail
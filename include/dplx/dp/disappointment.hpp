@@ -45,6 +45,11 @@ enum class errc
     oversized_additional_information_coding,
     indefinite_item,
     string_exceeds_size_limit,
+    unknown_message_type,
+    checkpoint_expired,
+    invalid_argument,
+    nesting_depth_exceeded,
+    unsupported_raw_item,
 };
 auto error_category() noexcept -> std::error_category const &;
 
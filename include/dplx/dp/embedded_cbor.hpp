@@ -0,0 +1,33 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+namespace dplx::dp
+{
+
+// RFC8949 3.4.5.1 Encoded CBOR Data Item
+inline constexpr std::uint64_t embedded_cbor_tag = 24u;
+
+// wraps a value which is encoded as a CBOR data item embedded in a byte
+// string tagged with embedded_cbor_tag. This allows a receiver to skip or
+// forward the value without parsing it.
+template <typename T>
+struct embedded_cbor final
+{
+    using value_type = T;
+
+    value_type value;
+
+    bool operator==(embedded_cbor const &) const = default;
+};
+
+template <typename T>
+embedded_cbor(T) -> embedded_cbor<T>;
+
+} // namespace dplx::dp
@@ -297,6 +297,31 @@ inline constexpr struct encoded_size_of_fn
     {
         return cpo::tag_invoke(*this, static_cast<T &&>(value));
     }
+
+    // records the sizes of subtrees which are needed again during encoding
+    // within the memo (see encoded_size_memo). Types which don't customize
+    // the memoized size computation are sized without it.
+    template <typename T>
+        requires tag_invocable<encoded_size_of_fn, T &&, encoded_size_memo &>
+    constexpr auto operator()(T &&value, encoded_size_memo &memo) const
+            noexcept(nothrow_tag_invocable<encoded_size_of_fn,
+                                           T &&,
+                                           encoded_size_memo &>)
+                    -> tag_invoke_result_t<encoded_size_of_fn,
+                                           T &&,
+                                           encoded_size_memo &>
+    {
+        return cpo::tag_invoke(*this, static_cast<T &&>(value), memo);
+    }
+    template <typename T>
+        requires(!tag_invocable<encoded_size_of_fn, T &&, encoded_size_memo &>
+                 && tag_invocable<encoded_size_of_fn, T &&>)
+    constexpr auto operator()(T &&value, encoded_size_memo &) const
+            noexcept(nothrow_tag_invocable<encoded_size_of_fn, T &&>)
+                    -> tag_invoke_result_t<encoded_size_of_fn, T &&>
+    {
+        return cpo::tag_invoke(*this, static_cast<T &&>(value));
+    }
 } encoded_size_of{};
 
 } // namespace dplx::dp
@@ -0,0 +1,162 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <ranges>
+
+#include <dplx/dp/columnar.hpp>
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/layout_descriptor.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+template <typename Container, column_encoding Encoding, output_stream Stream>
+class basic_encoder<columnar<Container, Encoding>, Stream>
+{
+    using emit = item_emitter<Stream>;
+    using record_type = std::ranges::range_value_t<Container>;
+
+    static constexpr auto const &descriptor
+            = layout_descriptor_for_v<record_type>;
+    static constexpr bool isVersioned = descriptor.version != null_def_version;
+
+public:
+    using value_type = columnar<Container, Encoding>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        constexpr std::size_t numItems
+                = descriptor.num_properties + (isVersioned ? 1u : 0u);
+        DPLX_TRY(emit::array(outStream, numItems));
+        if constexpr (isVersioned)
+        {
+            DPLX_TRY(emit::integer(outStream, descriptor.version));
+        }
+
+        return descriptor.mp_for_dots(
+                [&outStream, &value](auto const &propertyDef) {
+                    return encode_column(outStream, value.records,
+                                         propertyDef);
+                });
+    }
+
+private:
+    template <typename PropDefType>
+    static auto encode_column(Stream &outStream,
+                              Container const &records,
+                              PropDefType const &propertyDef) -> result<void>
+    {
+        using property_type = typename PropDefType::value_type;
+        auto const numRecords
+                = static_cast<std::uint64_t>(std::ranges::distance(records));
+
+        if constexpr (Encoding == column_encoding::typed_array
+                      && detail::typed_array_element<property_type>)
+        {
+            // the elements are gathered in host byte order
+            constexpr std::size_t elementSize = sizeof(property_type);
+            constexpr std::size_t chunkSize
+                    = detail::typed_array_chunk_size / elementSize
+                    * elementSize;
+
+            DPLX_TRY(emit::tag(outStream,
+                               detail::typed_array_tag<property_type>(
+                                       std::endian::native)));
+            DPLX_TRY(emit::binary(outStream, numRecords * elementSize));
+
+            std::byte chunk[chunkSize];
+            std::size_t fill = 0u;
+            for (auto const &record : records)
+            {
+                std::memcpy(chunk + fill, &propertyDef.access(record),
+                            elementSize);
+                fill += elementSize;
+                if (fill == chunkSize)
+                {
+                    DPLX_TRY(dp::write(outStream, chunk, chunkSize));
+                    fill = 0u;
+                }
+            }
+            if (fill > 0u)
+            {
+                DPLX_TRY(dp::write(outStream, chunk, fill));
+            }
+        }
+        else
+        {
+            using property_encoder = basic_encoder<property_type, Stream>;
+
+            DPLX_TRY(emit::array(outStream, numRecords));
+            for (auto const &record : records)
+            {
+                DPLX_TRY(property_encoder()(outStream,
+                                            propertyDef.access(record)));
+            }
+        }
+        return oc::success();
+    }
+};
+
+template <typename Container, column_encoding Encoding>
+inline auto tag_invoke(encoded_size_of_fn,
+                       columnar<Container, Encoding> const &value) noexcept
+        -> std::uint64_t
+{
+    using record_type = std::ranges::range_value_t<Container>;
+    constexpr auto const &descriptor = layout_descriptor_for_v<record_type>;
+    constexpr bool isVersioned = descriptor.version != null_def_version;
+
+    auto const numRecords = static_cast<std::uint64_t>(
+            std::ranges::distance(value.records));
+
+    std::uint64_t size = detail::var_uint_encoded_size(
+            descriptor.num_properties + (isVersioned ? 1 : 0));
+    if constexpr (isVersioned)
+    {
+        size += detail::var_uint_encoded_size(descriptor.version);
+    }
+
+    descriptor.mp_for_each([&](auto const &propertyDef) {
+        using property_type =
+                typename detail::remove_cref_t<decltype(propertyDef)>::
+                        value_type;
+
+        if constexpr (Encoding == column_encoding::typed_array
+                      && detail::typed_array_element<property_type>)
+        {
+            auto const byteSize = numRecords * sizeof(property_type);
+            size += detail::var_uint_encoded_size(
+                            detail::typed_array_tag<property_type>(
+                                    std::endian::native))
+                  + detail::var_uint_encoded_size(byteSize) + byteSize;
+        }
+        else
+        {
+            size += detail::var_uint_encoded_size(numRecords);
+            for (auto const &record : value.records)
+            {
+                size += dp::encoded_size_of(propertyDef.access(record));
+            }
+        }
+    });
+    return size;
+}
+
+} // namespace dplx::dp
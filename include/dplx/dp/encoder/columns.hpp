@@ -0,0 +1,101 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <ranges>
+#include <type_traits>
+
+#include <dplx/dp/columns.hpp>
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/detail/mp_for_dots.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+// all columns must have the same size, otherwise tuple_size_mismatch is
+// returned before anything is written.
+template <typename... Columns, output_stream Stream>
+    requires(
+            (std::ranges::random_access_range<std::remove_cvref_t<Columns>>
+             && ...)
+            && (encodable<std::ranges::range_value_t<
+                                  std::remove_cvref_t<Columns>>,
+                          Stream> && ...))
+class basic_encoder<columns<Columns...>, Stream>
+{
+    using emit = item_emitter<Stream>;
+
+public:
+    using value_type = columns<Columns...>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        auto const numRows = value.size();
+        DPLX_TRY(detail::mp_for_dots<value_type::num_columns>(
+                [&value, numRows](auto const i) -> result<void> {
+                    if (std::ranges::size(
+                                value.template column<decltype(i)::value>())
+                        != numRows)
+                    {
+                        return errc::tuple_size_mismatch;
+                    }
+                    return oc::success();
+                }));
+
+        DPLX_TRY(emit::array(outStream, numRows));
+        for (std::size_t row = 0u; row < numRows; ++row)
+        {
+            DPLX_TRY(emit::array(outStream, value_type::num_columns));
+            DPLX_TRY(detail::mp_for_dots<value_type::num_columns>(
+                    [&outStream, &value, row](auto const i) -> result<void> {
+                        auto const &column
+                                = value.template column<decltype(i)::value>();
+                        using element_type
+                                = std::ranges::range_value_t<decltype(column)>;
+
+                        return basic_encoder<element_type, Stream>()(
+                                outStream, std::ranges::begin(column)[row]);
+                    }));
+        }
+        return oc::success();
+    }
+};
+
+template <typename... Columns>
+inline auto tag_invoke(encoded_size_of_fn, columns<Columns...> const &value)
+        -> std::uint64_t
+{
+    using value_type = columns<Columns...>;
+
+    auto const numRows = value.size();
+    std::uint64_t size = detail::var_uint_encoded_size(numRows)
+                       + numRows
+                                 * detail::var_uint_encoded_size(
+                                         value_type::num_columns);
+    (void)detail::mp_for_dots<value_type::num_columns>(
+            [&value, &size](auto const i) -> result<void> {
+                for (auto const &element :
+                     value.template column<decltype(i)::value>())
+                {
+                    size += dp::encoded_size_of(element);
+                }
+                return oc::success();
+            });
+    return size;
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,217 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <ranges>
+
+#include <dplx/dp/compressed_sequence.hpp>
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp::detail
+{
+
+// buffers the varints and bit fields of a compressed sequence payload and
+// writes them in chunks
+template <output_stream Stream>
+class compressed_payload_writer
+{
+    static constexpr std::size_t chunk_size = 256u;
+
+    Stream &mStream;
+    std::size_t mFill;
+    std::uint64_t mBits;
+    unsigned mNumBits;
+    std::byte mChunk[chunk_size];
+
+public:
+    explicit compressed_payload_writer(Stream &outStream) noexcept
+        : mStream(outStream)
+        , mFill(0u)
+        , mBits(0u)
+        , mNumBits(0u)
+    {
+    }
+
+    auto put_varint(std::uint64_t value) -> result<void>
+    {
+        if (mFill > chunk_size - max_varint_size)
+        {
+            DPLX_TRY(flush());
+        }
+        while (value >= 0x80u)
+        {
+            mChunk[mFill++] = static_cast<std::byte>(value | 0x80u);
+            value >>= 7;
+        }
+        mChunk[mFill++] = static_cast<std::byte>(value);
+        return oc::success();
+    }
+
+    // appends the numBits low bits of value MSB first
+    auto put_bits(std::uint64_t const value, unsigned const numBits)
+            -> result<void>
+    {
+        if (numBits > 32u)
+        {
+            DPLX_TRY(put_bits(value >> 32, numBits - 32u));
+            return put_bits(value & 0xffff'ffffu, 32u);
+        }
+        // mNumBits < 8 holds between calls, i.e. the accumulator can't
+        // overflow
+        mBits = (mBits << numBits)
+              | (value & ((std::uint64_t{1} << numBits) - 1u));
+        mNumBits += numBits;
+        while (mNumBits >= 8u)
+        {
+            if (mFill == chunk_size)
+            {
+                DPLX_TRY(flush());
+            }
+            mNumBits -= 8u;
+            mChunk[mFill++] = static_cast<std::byte>(mBits >> mNumBits);
+        }
+        return oc::success();
+    }
+
+    // pads the bit stream with zeros to a byte boundary
+    auto finish() -> result<void>
+    {
+        if (mNumBits > 0u)
+        {
+            DPLX_TRY(put_bits(0u, 8u - mNumBits));
+        }
+        return flush();
+    }
+
+private:
+    auto flush() -> result<void>
+    {
+        if (mFill > 0u)
+        {
+            DPLX_TRY(dp::write(mStream, mChunk, mFill));
+            mFill = 0u;
+        }
+        return oc::success();
+    }
+};
+
+template <typename T, output_stream Stream>
+class compressed_sequence_encoder
+{
+    using emit = item_emitter<Stream>;
+
+public:
+    using value_type = T;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        auto const numElements = static_cast<std::uint64_t>(
+                std::ranges::size(value.values));
+
+        DPLX_TRY(emit::tag(outStream, value_type::tag));
+        DPLX_TRY(emit::binary(outStream,
+                              detail::varint_size(numElements)
+                                      + detail::compressed_payload_size(
+                                              value)));
+
+        compressed_payload_writer<Stream> writer(outStream);
+        DPLX_TRY(writer.put_varint(numElements));
+        if constexpr (value_type::tag == xor_sequence_tag)
+        {
+            DPLX_TRY(detail::for_each_xor_field(
+                    value.values,
+                    [&writer](std::uint64_t const bits,
+                              unsigned const numBits) {
+                        return writer.put_bits(bits, numBits);
+                    }));
+        }
+        else
+        {
+            constexpr unsigned order
+                    = value_type::tag == delta_sequence_tag ? 1u : 2u;
+            DPLX_TRY(detail::for_each_delta<order>(
+                    value.values, [&writer](std::uint64_t const delta) {
+                        return writer.put_varint(delta);
+                    }));
+        }
+        return writer.finish();
+    }
+};
+
+template <typename T>
+inline auto compressed_sequence_size_of(T const &value) noexcept
+        -> std::uint64_t
+{
+    auto const numElements
+            = static_cast<std::uint64_t>(std::ranges::size(value.values));
+    auto const payloadSize = detail::varint_size(numElements)
+                           + detail::compressed_payload_size(value);
+
+    return detail::var_uint_encoded_size(T::tag)
+         + detail::var_uint_encoded_size(payloadSize) + payloadSize;
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+template <typename Container, output_stream Stream>
+class basic_encoder<delta_encoded<Container>, Stream>
+    : public detail::compressed_sequence_encoder<delta_encoded<Container>,
+                                                 Stream>
+{
+};
+
+template <typename Container, output_stream Stream>
+class basic_encoder<delta_of_delta_encoded<Container>, Stream>
+    : public detail::compressed_sequence_encoder<
+              delta_of_delta_encoded<Container>,
+              Stream>
+{
+};
+
+template <typename Container, output_stream Stream>
+class basic_encoder<xor_encoded<Container>, Stream>
+    : public detail::compressed_sequence_encoder<xor_encoded<Container>,
+                                                 Stream>
+{
+};
+
+template <typename Container>
+inline auto tag_invoke(encoded_size_of_fn,
+                       delta_encoded<Container> const &value) noexcept
+        -> std::uint64_t
+{
+    return detail::compressed_sequence_size_of(value);
+}
+template <typename Container>
+inline auto tag_invoke(encoded_size_of_fn,
+                       delta_of_delta_encoded<Container> const &value) noexcept
+        -> std::uint64_t
+{
+    return detail::compressed_sequence_size_of(value);
+}
+template <typename Container>
+inline auto tag_invoke(encoded_size_of_fn,
+                       xor_encoded<Container> const &value) noexcept
+        -> std::uint64_t
+{
+    return detail::compressed_sequence_size_of(value);
+}
+
+} // namespace dplx::dp
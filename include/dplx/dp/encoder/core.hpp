@@ -28,6 +28,8 @@
 #include <dplx/dp/fwd.hpp>
 #include <dplx/dp/item_emitter.hpp>
 #include <dplx/dp/map_pair.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
 
 namespace dplx::dp
 {
@@ -48,7 +50,7 @@ public:
     }
 };
 constexpr auto tag_invoke(encoded_size_of_fn, null_type const) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     return 1u;
 }
@@ -94,18 +96,18 @@ public:
     }
 };
 constexpr auto tag_invoke(encoded_size_of_fn, bool const) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     return 1u;
 }
 constexpr auto tag_invoke(encoded_size_of_fn, char8_t const) noexcept
-        -> unsigned int
+        -> std::uint64_t
         = delete;
 constexpr auto tag_invoke(encoded_size_of_fn, char16_t const) noexcept
-        -> unsigned int
+        -> std::uint64_t
         = delete;
 constexpr auto tag_invoke(encoded_size_of_fn, char32_t const) noexcept
-        -> unsigned int
+        -> std::uint64_t
         = delete;
 
 template <integer T, output_stream Stream>
@@ -121,7 +123,7 @@ public:
 };
 template <integer T>
 constexpr auto tag_invoke(encoded_size_of_fn, T const value) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     if constexpr (std::is_signed_v<T>)
     {
@@ -129,7 +131,8 @@ constexpr auto tag_invoke(encoded_size_of_fn, T const value) noexcept
         auto const signmask = static_cast<uvalue_type>(
                 value >> (detail::digits_v<uvalue_type> - 1));
         // complement negatives
-        auto const uvalue = signmask ^ static_cast<uvalue_type>(value);
+        auto const uvalue = static_cast<uvalue_type>(
+                signmask ^ static_cast<uvalue_type>(value));
 
         return detail::var_uint_encoded_size(uvalue);
     }
@@ -160,7 +163,8 @@ public:
     }
 };
 template <iec559_floating_point T>
-constexpr auto tag_invoke(encoded_size_of_fn, T const) noexcept -> unsigned int
+constexpr auto tag_invoke(encoded_size_of_fn, T const) noexcept
+        -> std::uint64_t
 {
     if constexpr (sizeof(T) == 4)
     {
@@ -186,7 +190,8 @@ public:
     }
 };
 template <codable_enum Enum>
-constexpr auto tag_invoke(encoded_size_of_fn, Enum value) noexcept -> int
+constexpr auto tag_invoke(encoded_size_of_fn, Enum value) noexcept
+        -> std::uint64_t
 {
     return encoded_size_of(detail::to_underlying(value));
 }
@@ -252,11 +257,11 @@ template <std::ranges::range T>
     requires tag_invocable<encoded_size_of_fn,
                            std::ranges::range_reference_t<T>>
 constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     if constexpr (enable_indefinite_encoding<T>)
     {
-        unsigned int accumulator = 1u + 1u;
+        std::uint64_t accumulator = 1u + 1u;
         for (auto &&part : value)
         {
             accumulator += encoded_size_of(static_cast<decltype(part)>(part));
@@ -266,7 +271,7 @@ constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
     else if constexpr (std::ranges::sized_range<T>)
     {
         auto const size = std::ranges::size(value);
-        unsigned int accumulator = detail::var_uint_encoded_size(size);
+        std::uint64_t accumulator = detail::var_uint_encoded_size(size);
         for (auto &&part : value)
         {
             accumulator += encoded_size_of(static_cast<decltype(part)>(part));
@@ -279,7 +284,7 @@ constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
         auto const end = std::ranges::end(value);
         auto const size = static_cast<std::size_t>(std::distance(begin, end));
 
-        unsigned int accumulator = detail::var_uint_encoded_size(size);
+        std::uint64_t accumulator = detail::var_uint_encoded_size(size);
         for (; begin != end; ++begin)
         {
             accumulator += encoded_size_of(*begin);
@@ -287,6 +292,31 @@ constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
         return accumulator;
     }
 }
+template <std::ranges::range T>
+    requires tag_invocable<encoded_size_of_fn,
+                           std::ranges::range_reference_t<T>,
+                           encoded_size_memo &>
+constexpr auto
+tag_invoke(encoded_size_of_fn, T const &value, encoded_size_memo &memo)
+        -> std::uint64_t
+{
+    std::uint64_t accumulator = 0u;
+    std::size_t size = 0u;
+    for (auto &&part : value)
+    {
+        accumulator
+                += encoded_size_of(static_cast<decltype(part)>(part), memo);
+        ++size;
+    }
+    if constexpr (enable_indefinite_encoding<T>)
+    {
+        return accumulator + 1u + 1u;
+    }
+    else
+    {
+        return accumulator + detail::var_uint_encoded_size(size);
+    }
+}
 
 // clang-format off
 template <std::ranges::contiguous_range T, output_stream Stream>
@@ -300,23 +330,32 @@ public:
     auto operator()(Stream &outStream, value_type const &value) -> result<void>
     {
         auto const size = std::ranges::size(value);
+        auto const *const data
+                = reinterpret_cast<std::byte const *>(std::ranges::data(value));
+        if constexpr (has_stream_state<Stream, stringref_table>)
+        {
+            DPLX_TRY(bool const referenced,
+                     detail::emit_stringref(outStream, true, data, size));
+            if (referenced)
+            {
+                return success();
+            }
+        }
+
         DPLX_TRY(item_emitter<Stream>::u8string(outStream, size));
 
-        DPLX_TRY(dp::write(
-                outStream,
-                reinterpret_cast<std::byte const *>(std::ranges::data(value)),
-                size));
+        DPLX_TRY(dp::write(outStream, data, size));
         return success();
     }
 };
 template <std::ranges::contiguous_range T>
     requires std::same_as<char8_t, std::ranges::range_value_t<T>>
 constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     auto const size = std::ranges::size(value);
     return detail::var_uint_encoded_size(size)
-         + static_cast<unsigned int>(size);
+         + static_cast<std::uint64_t>(size);
 }
 
 // clang-format off
@@ -331,6 +370,17 @@ public:
     auto operator()(Stream &outStream, value_type const &value) -> result<void>
     {
         auto const size = std::ranges::size(value);
+        if constexpr (has_stream_state<Stream, stringref_table>)
+        {
+            DPLX_TRY(bool const referenced,
+                     detail::emit_stringref(outStream, false,
+                                            std::ranges::data(value), size));
+            if (referenced)
+            {
+                return success();
+            }
+        }
+
         DPLX_TRY(item_emitter<Stream>::binary(outStream, size));
 
         DPLX_TRY(dp::write(outStream, std::ranges::data(value), size));
@@ -340,7 +390,7 @@ public:
 template <std::ranges::contiguous_range T>
     requires std::same_as<std::byte, std::ranges::range_value_t<T>>
 constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     auto const size = std::ranges::size(value);
     return detail::var_uint_encoded_size(size) + size;
@@ -409,7 +459,7 @@ class encoded_size_of_tuple<mp_list<TArgs...>>
 {
 public:
     auto inline operator()(TArgs const &...values) const noexcept
-            -> unsigned int
+            -> std::uint64_t
     {
         return (detail::var_uint_encoded_size(sizeof...(TArgs)) + ...
                 + encoded_size_of(values));
@@ -419,13 +469,46 @@ public:
 
 template <detail::size_ofable_tuple_like T>
 constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     using impl = detail::encoded_size_of_tuple<detail::mp_transform_t<
             detail::remove_cref_t, detail::mp_rename_t<T, detail::mp_list>>>;
     return detail::apply_simply(impl{}, value);
 }
 
+namespace detail
+{
+template <typename T>
+struct is_any_tuple_element_memoized : std::false_type
+{
+};
+template <typename... Ts>
+struct is_any_tuple_element_memoized<mp_list<Ts...>>
+    : std::bool_constant<(tag_invocable<encoded_size_of_fn,
+                                        detail::remove_cref_t<Ts> const &,
+                                        encoded_size_memo &> || ...)>
+{
+};
+} // namespace detail
+
+template <detail::size_ofable_tuple_like T>
+    requires detail::is_any_tuple_element_memoized<
+            detail::tuple_element_list_t<T>>::value
+constexpr auto
+tag_invoke(encoded_size_of_fn, T const &value, encoded_size_memo &memo)
+        -> std::uint64_t
+{
+    return detail::apply_simply(
+            [&memo](auto const &...values) -> std::uint64_t {
+                std::uint64_t accumulator
+                        = detail::var_uint_encoded_size(sizeof...(values));
+                // the comma fold sequences the memo slot reservations
+                (..., (accumulator += encoded_size_of(values, memo)));
+                return accumulator;
+            },
+            value);
+}
+
 // clang-format off
 template <associative_range T, output_stream Stream>
     requires encodable<std::ranges::range_value_t<T>, Stream>
@@ -494,11 +577,11 @@ template <associative_range T>
     requires tag_invocable<encoded_size_of_fn,
                            std::ranges::range_reference_t<T>>
 constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
-        -> unsigned int
+        -> std::uint64_t
 {
     if constexpr (enable_indefinite_encoding<T>)
     {
-        unsigned int accumulator = 1u + 1u;
+        std::uint64_t accumulator = 1u + 1u;
         for (auto &&[k, v] : value)
         {
             accumulator += encoded_size_of(static_cast<decltype(k)>(k));
@@ -509,7 +592,7 @@ constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
     else if constexpr (std::ranges::sized_range<T>)
     {
         auto const size = std::ranges::size(value);
-        unsigned int accumulator = detail::var_uint_encoded_size(size);
+        std::uint64_t accumulator = detail::var_uint_encoded_size(size);
         for (auto &&[k, v] : value)
         {
             accumulator += encoded_size_of(static_cast<decltype(k)>(k));
@@ -523,7 +606,7 @@ constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
         auto const end = std::ranges::end(value);
         auto const size = static_cast<std::size_t>(std::distance(begin, end));
 
-        unsigned int accumulator = detail::var_uint_encoded_size(size);
+        std::uint64_t accumulator = detail::var_uint_encoded_size(size);
         for (; begin != end; ++begin)
         {
             auto &&[k, v] = *begin;
@@ -533,5 +616,30 @@ constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
         return accumulator;
     }
 }
+template <associative_range T>
+    requires tag_invocable<encoded_size_of_fn,
+                           std::ranges::range_reference_t<T>,
+                           encoded_size_memo &>
+constexpr auto
+tag_invoke(encoded_size_of_fn, T const &value, encoded_size_memo &memo)
+        -> std::uint64_t
+{
+    std::uint64_t accumulator = 0u;
+    std::size_t size = 0u;
+    for (auto &&[k, v] : value)
+    {
+        accumulator += encoded_size_of(static_cast<decltype(k)>(k), memo);
+        accumulator += encoded_size_of(static_cast<decltype(v)>(v), memo);
+        ++size;
+    }
+    if constexpr (enable_indefinite_encoding<T>)
+    {
+        return accumulator + 1u + 1u;
+    }
+    else
+    {
+        return accumulator + detail::var_uint_encoded_size(size);
+    }
+}
 
 } // namespace dplx::dp
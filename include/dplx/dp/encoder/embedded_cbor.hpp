@@ -0,0 +1,95 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/embedded_cbor.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/encoded_size_memo.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/value_sharing.hpp>
+
+namespace dplx::dp
+{
+
+// the byte string head needs the size of the embedded item. It is looked up
+// in the encoded_size_memo attached to the stream if there is one, i.e. the
+// memo must have been filled by encoded_size_of(value, memo) with the value
+// being encoded. Otherwise (or if the memo holds no slot for the item) the
+// embedded item is sized on the spot which results in quadratic complexity
+// for nested embedded items.
+template <typename T, output_stream Stream>
+    requires encodable<T, Stream> && tag_invocable<encoded_size_of_fn,
+                                                   T const &>
+class basic_encoder<embedded_cbor<T>, Stream>
+{
+public:
+    using value_type = embedded_cbor<T>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        std::uint64_t embeddedSize = encoded_size_memo::npos;
+        if constexpr (has_stream_state<Stream, encoded_size_memo>)
+        {
+            auto &memo = get_stream_state<encoded_size_memo>(outStream);
+            embeddedSize = memo.next(&value.value);
+        }
+        if (embeddedSize == encoded_size_memo::npos)
+        {
+            embeddedSize = encoded_size_of(value.value);
+        }
+
+        DPLX_TRY(item_emitter<Stream>::tag(outStream, embedded_cbor_tag));
+        DPLX_TRY(item_emitter<Stream>::binary(outStream, embeddedSize));
+        // the embedded item is a self-contained document which therefore
+        // can't refer to the shared values or strings of the outer one
+        return dp::with_stream_states_detached<sharing_index,
+                                               stringref_table>(
+                outStream, [&value]<typename EmbeddedStream>(
+                        EmbeddedStream &embeddedStream) -> result<void> {
+                    return basic_encoder<T, EmbeddedStream>()(embeddedStream,
+                                                              value.value);
+                });
+    }
+};
+
+template <typename T>
+    requires tag_invocable<encoded_size_of_fn, T const &>
+constexpr auto tag_invoke(encoded_size_of_fn,
+                          embedded_cbor<T> const &value) noexcept
+        -> std::uint64_t
+{
+    auto const embeddedSize = encoded_size_of(value.value);
+    return detail::var_uint_encoded_size(embedded_cbor_tag)
+         + detail::var_uint_encoded_size(embeddedSize) + embeddedSize;
+}
+
+template <typename T>
+    requires tag_invocable<encoded_size_of_fn, T const &>
+inline auto tag_invoke(encoded_size_of_fn,
+                       embedded_cbor<T> const &value,
+                       encoded_size_memo &memo) -> std::uint64_t
+{
+    // the slot is reserved before the embedded item is sized in order to
+    // match the order in which the encoders consume them.
+    auto const slot = memo.reserve_slot(&value.value);
+    auto const embeddedSize = encoded_size_of(value.value, memo);
+    memo.assign(slot, embeddedSize);
+
+    return detail::var_uint_encoded_size(embedded_cbor_tag)
+         + detail::var_uint_encoded_size(embeddedSize) + embeddedSize;
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,94 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include <dplx/dp/fwd.hpp>
+
+namespace dplx::dp
+{
+
+// records the encoded sizes of subtrees computed by encoded_size_of(value,
+// memo) in a flat buffer so that the subsequent encoding pass can look them
+// up instead of sizing the subtrees again. Slots are reserved in pre-order
+// (i.e. before the subtree is sized) and are therefore consumed in exactly the
+// order the encoders visit the corresponding items.
+//
+// Only items which need to know their size upfront (e.g. embedded_cbor) use a
+// slot; everything else passes the memo through. Each slot remembers the
+// address of the item it has been reserved for, so that an item which has
+// been sized without the memo (e.g. behind a wrapper which doesn't forward
+// it) doesn't consume the slot of another item.
+class encoded_size_memo
+{
+    struct slot
+    {
+        void const *item;
+        std::uint64_t size;
+    };
+
+    std::vector<slot> mSlots;
+    std::size_t mCursor;
+
+public:
+    static constexpr std::uint64_t npos = ~std::uint64_t{};
+
+    encoded_size_memo() noexcept
+        : mSlots()
+        , mCursor(0u)
+    {
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mSlots.size();
+    }
+
+    // resets the memo for another sizing pass without releasing the memory
+    void clear() noexcept
+    {
+        mSlots.clear();
+        mCursor = 0u;
+    }
+
+    // sizing pass
+    [[nodiscard]] auto reserve_slot(void const *const item) -> std::size_t
+    {
+        auto const index = mSlots.size();
+        mSlots.push_back(slot{item, 0u});
+        return index;
+    }
+    void assign(std::size_t const index, std::uint64_t const size) noexcept
+    {
+        assert(index < mSlots.size());
+        mSlots[index].size = size;
+    }
+
+    // encoding pass; returns npos without consuming anything if the next slot
+    // hasn't been reserved for the given item
+    [[nodiscard]] auto next(void const *const item) noexcept -> std::uint64_t
+    {
+        if (mCursor == mSlots.size() || mSlots[mCursor].item != item)
+        {
+            return npos;
+        }
+        return mSlots[mCursor++].size;
+    }
+    // allows the recorded sizes to be consumed again e.g. in order to encode
+    // the same value twice
+    void rewind() noexcept
+    {
+        mCursor = 0u;
+    }
+};
+
+} // namespace dplx::dp
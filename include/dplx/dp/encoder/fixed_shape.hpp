@@ -0,0 +1,421 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include <array>
+#include <concepts>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/detail/pre_encoded.hpp>
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/detail/utils.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/layout_descriptor.hpp>
+#include <dplx/dp/object_def.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/streams/unchecked_memory_output_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp
+{
+
+// the maximum number of bytes the encoding of a T can occupy.
+// Only defined for types whose encoded size is bounded at compile time.
+template <typename T>
+struct max_encoded_size_of
+{
+};
+
+// clang-format off
+template <typename T>
+concept bounded_encoded_size
+    = requires
+    {
+        { max_encoded_size_of<T>::value }
+            -> std::convertible_to<std::size_t>;
+    };
+// clang-format on
+
+template <bounded_encoded_size T>
+inline constexpr std::size_t max_encoded_size_of_v
+        = max_encoded_size_of<T>::value;
+
+// fixed-shape types with a maximum encoded size not exceeding this limit are
+// encoded through a single write reservation instead of one per item.
+// Note that unchecked_memory_buffer only tolerates over-reservations of up to
+// unchecked_output_padding bytes, i.e. types exceeding that size are encoded
+// item by item into it regardless of this limit.
+template <typename T>
+inline constexpr std::size_t single_reservation_encoding_limit
+        = minimum_guaranteed_write_size;
+
+} // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto bounded_layout_impl(std::index_sequence<Is...>) noexcept
+        -> bool
+{
+    return (... && bounded_encoded_size<typename remove_cref_t<decltype(
+                           descriptor.template property<Is>())>::value_type>);
+}
+
+template <auto const &descriptor>
+concept bounded_tuple_layout = bounded_layout_impl<descriptor>(
+        std::make_index_sequence<descriptor.num_properties>());
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto pre_encodable_ids_impl(std::index_sequence<Is...>) noexcept
+        -> bool
+{
+    return (... && pre_encodable_property_id<typename remove_cref_t<decltype(
+                           descriptor.template property<Is>())>::id_type>);
+}
+
+// the sparse object encodings have a value dependent shape
+template <auto const &descriptor>
+concept bounded_object_layout
+        = descriptor.encoding == object_encoding::map
+       && bounded_tuple_layout<descriptor>
+       && pre_encodable_ids_impl<descriptor>(
+               std::make_index_sequence<descriptor.num_properties>());
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto max_encoded_size_of_tuple(std::index_sequence<Is...>) noexcept
+        -> std::size_t
+{
+    return (encoded_tuple_head<descriptor>.size() + ...
+            + max_encoded_size_of_v<typename remove_cref_t<decltype(
+                    descriptor.template property<Is>())>::value_type>);
+}
+
+template <auto const &descriptor, std::size_t... Is>
+constexpr auto max_encoded_size_of_object(std::index_sequence<Is...>) noexcept
+        -> std::size_t
+{
+    return (encoded_object_head<descriptor>.size() + ...
+            + (encoded_property_key<
+                       descriptor,
+                       remove_cref_t<decltype(
+                               descriptor.template property<Is>())>>
+                       .size()
+               + max_encoded_size_of_v<typename remove_cref_t<decltype(
+                       descriptor.template property<Is>())>::value_type>));
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+template <>
+struct max_encoded_size_of<bool> : std::integral_constant<std::size_t, 1u>
+{
+};
+
+template <integer T>
+struct max_encoded_size_of<T>
+    : std::integral_constant<std::size_t, 1u + sizeof(T)>
+{
+};
+
+template <iec559_floating_point T>
+struct max_encoded_size_of<T>
+    : std::integral_constant<std::size_t, 1u + sizeof(T)>
+{
+};
+
+template <codable_enum T>
+struct max_encoded_size_of<T>
+    : max_encoded_size_of<std::underlying_type_t<T>>
+{
+};
+
+template <std::size_t N>
+struct max_encoded_size_of<fixed_u8string<N>>
+    : std::integral_constant<std::size_t,
+                             detail::var_uint_encoded_size_branching(N) + N>
+{
+};
+
+template <bounded_encoded_size T, std::size_t N>
+struct max_encoded_size_of<std::array<T, N>>
+    : std::integral_constant<std::size_t,
+                             detail::var_uint_encoded_size_branching(N)
+                                     + N * max_encoded_size_of_v<T>>
+{
+};
+template <std::size_t N>
+struct max_encoded_size_of<std::array<std::byte, N>>
+    : std::integral_constant<std::size_t,
+                             detail::var_uint_encoded_size_branching(N) + N>
+{
+};
+template <std::size_t N>
+struct max_encoded_size_of<std::array<char8_t, N>>
+    : std::integral_constant<std::size_t,
+                             detail::var_uint_encoded_size_branching(N) + N>
+{
+};
+
+template <packable_tuple T>
+    requires detail::bounded_tuple_layout<layout_descriptor_for_v<T>>
+struct max_encoded_size_of<T>
+    : std::integral_constant<
+              std::size_t,
+              detail::max_encoded_size_of_tuple<layout_descriptor_for_v<T>>(
+                      std::make_index_sequence<
+                              layout_descriptor_for_v<T>.num_properties>())>
+{
+};
+
+template <packable_object T>
+    requires detail::bounded_object_layout<layout_descriptor_for_v<T>>
+struct max_encoded_size_of<T>
+    : std::integral_constant<
+              std::size_t,
+              detail::max_encoded_size_of_object<layout_descriptor_for_v<T>>(
+                      std::make_index_sequence<
+                              layout_descriptor_for_v<T>.num_properties>())>
+{
+};
+
+// clang-format off
+template <typename T>
+concept single_reservation_encodable
+    = bounded_encoded_size<T>
+    && max_encoded_size_of_v<T> <= single_reservation_encoding_limit<T>;
+
+// the fast path stores strings verbatim and therefore must not be taken if
+// the strings need to be registered with a stringref namespace
+template <typename T, typename Stream>
+concept single_reservation_encodable_to
+    = single_reservation_encodable<T>
+    && max_encoded_size_of_v<T> <= detail::over_reservation_limit<Stream>
+    && !has_stream_state<Stream, stringref_table>;
+// clang-format on
+
+} // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+// stores the encoding of a fixed-shape value without any bounds checks;
+// dest must point to at least max_encoded_size_of_v<T> bytes.
+template <bounded_encoded_size T>
+inline auto store_fixed_shape(std::byte *dest, T const &value) noexcept
+        -> std::byte *;
+
+template <typename T>
+inline auto store_fixed_shape_integer(std::byte *dest, T const value) noexcept
+        -> std::byte *
+{
+    using uvalue_type = std::make_unsigned_t<T>;
+    uvalue_type uvalue = static_cast<uvalue_type>(value);
+    std::byte category = to_byte(type_code::posint);
+    if constexpr (std::is_signed_v<T>)
+    {
+        auto const signmask = static_cast<uvalue_type>(
+                value >> (detail::digits_v<uvalue_type> - 1));
+        // complement negatives
+        uvalue = signmask ^ uvalue;
+        category = static_cast<std::byte>(signmask) & std::byte{0b001'00000};
+    }
+
+    if constexpr (sizeof(T) >= 4)
+    {
+        // store_var_uint() may write sizeof(T) + 1 bytes which is still
+        // covered by max_encoded_size_of<T>
+        return dest + detail::store_var_uint(dest, uvalue, category);
+    }
+    else
+    {
+        return dest
+             + detail::store_var_uint_branching(
+                     dest, static_cast<unsigned int>(uvalue), category);
+    }
+}
+
+template <auto const &descriptor, typename T, std::size_t... Is>
+inline auto store_fixed_shape_tuple(std::byte *dest,
+                                    T const &value,
+                                    std::index_sequence<Is...>) noexcept
+        -> std::byte *
+{
+    constexpr auto const &encodedHead = encoded_tuple_head<descriptor>;
+    std::memcpy(dest, encodedHead.data(), encodedHead.size());
+    dest += encodedHead.size();
+
+    ((dest = detail::store_fixed_shape(
+              dest, remove_cref_t<decltype(descriptor.template property<Is>())>::
+                            access(value))),
+     ...);
+    return dest;
+}
+
+template <auto const &descriptor, typename PropDefType, typename T>
+inline auto store_fixed_shape_property(std::byte *dest, T const &value) noexcept
+        -> std::byte *
+{
+    constexpr auto const &encodedId
+            = encoded_property_key<descriptor, PropDefType>;
+    std::memcpy(dest, encodedId.data(), encodedId.size());
+    return detail::store_fixed_shape(dest + encodedId.size(),
+                                     PropDefType::access(value));
+}
+
+template <auto const &descriptor, typename T, std::size_t... Is>
+inline auto store_fixed_shape_object(std::byte *dest,
+                                     T const &value,
+                                     std::index_sequence<Is...>) noexcept
+        -> std::byte *
+{
+    constexpr auto const &encodedHead = encoded_object_head<descriptor>;
+    std::memcpy(dest, encodedHead.data(), encodedHead.size());
+    dest += encodedHead.size();
+
+    ((dest = detail::store_fixed_shape_property<
+              descriptor,
+              remove_cref_t<decltype(descriptor.template property<Is>())>>(
+              dest, value)),
+     ...);
+    return dest;
+}
+
+template <bounded_encoded_size T>
+inline auto store_fixed_shape(std::byte *dest, T const &value) noexcept
+        -> std::byte *
+{
+    if constexpr (std::same_as<T, bool>)
+    {
+        *dest = to_byte(type_code::bool_false)
+              | std::byte{static_cast<std::uint8_t>(value)};
+        return dest + 1;
+    }
+    else if constexpr (integer<T>)
+    {
+        return detail::store_fixed_shape_integer(dest, value);
+    }
+    else if constexpr (iec559_floating_point<T>)
+    {
+        *dest = sizeof(T) == 4 ? to_byte(type_code::float_single)
+                               : to_byte(type_code::float_double);
+        detail::store(dest + 1, value);
+        return dest + 1 + sizeof(T);
+    }
+    else if constexpr (codable_enum<T>)
+    {
+        return detail::store_fixed_shape_integer(dest,
+                                                 detail::to_underlying(value));
+    }
+    else if constexpr (is_fixed_u8string_v<T>)
+    {
+        // the header must not be stored with the wide store_var_uint()
+        // variant as it would overshoot the reservation for small strings
+        auto const size = static_cast<unsigned int>(value.size());
+        dest += detail::store_var_uint_branching(dest, size,
+                                                 to_byte(type_code::text));
+        std::memcpy(dest, value.data(), size);
+        return dest + size;
+    }
+    else if constexpr (is_std_array_v<T>)
+    {
+        using element_type = typename T::value_type;
+        constexpr auto size = std::tuple_size_v<T>;
+        if constexpr (std::same_as<element_type, std::byte>
+                      || std::same_as<element_type, char8_t>)
+        {
+            constexpr auto category = std::same_as<element_type, std::byte>
+                                            ? to_byte(type_code::binary)
+                                            : to_byte(type_code::text);
+            dest += detail::store_var_uint_static(dest, size, category);
+            std::memcpy(dest, value.data(), size);
+            return dest + size;
+        }
+        else
+        {
+            dest += detail::store_var_uint_static(dest, size,
+                                                  to_byte(type_code::array));
+            for (auto const &element : value)
+            {
+                dest = detail::store_fixed_shape(dest, element);
+            }
+            return dest;
+        }
+    }
+    else if constexpr (packable_tuple<T>)
+    {
+        constexpr auto const &descriptor = layout_descriptor_for_v<T>;
+        return detail::store_fixed_shape_tuple<descriptor>(
+                dest, value,
+                std::make_index_sequence<descriptor.num_properties>());
+    }
+    else if constexpr (packable_object<T>)
+    {
+        constexpr auto const &descriptor = layout_descriptor_for_v<T>;
+        return detail::store_fixed_shape_object<descriptor>(
+                dest, value,
+                std::make_index_sequence<descriptor.num_properties>());
+    }
+}
+
+// encodes the value with a single write reservation of
+// max_encoded_size_of_v<T> bytes. Returns false without having written
+// anything if the stream can't provide a write proxy of that size.
+template <single_reservation_encodable T, output_stream Stream>
+inline auto try_encode_single_reservation(Stream &outStream, T const &value)
+        -> result<bool>
+{
+    constexpr std::size_t maxSize = max_encoded_size_of_v<T>;
+
+    auto maybeWriteLease = write(outStream, maxSize);
+    if (oc::try_operation_has_value(maybeWriteLease))
+        DPLX_ATTR_LIKELY
+        {
+            auto &&writeLease
+                    = oc::try_operation_extract_value(std::move(maybeWriteLease));
+
+            if (std::ranges::size(writeLease) < maxSize)
+                DPLX_ATTR_UNLIKELY
+                {
+                    DPLX_TRY(commit(outStream, writeLease, 0u));
+                    return false;
+                }
+
+            auto const out = std::ranges::data(writeLease);
+            auto const end = detail::store_fixed_shape(out, value);
+
+            DPLX_TRY(commit(outStream, writeLease,
+                            static_cast<std::size_t>(end - out)));
+            return true;
+        }
+    else
+    {
+        if (result<void> failure
+            = oc::try_operation_return_as(std::move(maybeWriteLease));
+            failure.assume_error() != errc::end_of_stream)
+        {
+            return failure.as_failure();
+        }
+        // the value may still fit into the remaining space
+        return false;
+    }
+}
+
+} // namespace dplx::dp::detail
@@ -0,0 +1,60 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/splice_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/lazy.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+template <typename T, output_stream Stream>
+    requires encodable<T, Stream>
+class basic_encoder<lazy<T>, Stream>
+{
+public:
+    using value_type = lazy<T>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        if (auto const encoded = value.encoded(); !encoded.empty())
+        {
+            return detail::splice_item(outStream, encoded);
+        }
+        if (auto const *const decoded = value.get_if(); decoded != nullptr)
+        {
+            return basic_encoder<T, Stream>()(outStream, *decoded);
+        }
+        return basic_encoder<T, Stream>()(outStream, T{});
+    }
+};
+
+template <typename T>
+    requires tag_invocable<encoded_size_of_fn, T const &>
+constexpr auto tag_invoke(encoded_size_of_fn, lazy<T> const &value) noexcept
+        -> std::uint64_t
+{
+    if (auto const encoded = value.encoded(); !encoded.empty())
+    {
+        return encoded.size();
+    }
+    if (auto const *const decoded = value.get_if(); decoded != nullptr)
+    {
+        return encoded_size_of(*decoded);
+    }
+    return encoded_size_of(T{});
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,46 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/message_registry.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+// encodes the message within its envelope [T::message_id, value]
+inline constexpr struct encode_message_fn final
+{
+    template <message_type T, output_stream Stream>
+        requires encodable<T, Stream>
+    inline auto operator()(Stream &outStream, T const &value) const
+            -> result<void>
+    {
+        constexpr auto const &prefix = detail::encoded_message_prefix<T>;
+        DPLX_TRY(dp::write(outStream, prefix.data(), prefix.size()));
+        DPLX_TRY((basic_encoder<T, Stream>()(outStream, value)));
+        return success();
+    }
+
+} encode_message{};
+
+// the size of the envelope including the message
+template <message_type T>
+    requires tag_invocable<encoded_size_of_fn, T const &>
+inline auto encoded_message_size_of(T const &value) noexcept -> std::uint64_t
+{
+    return detail::encoded_message_prefix<T>.size()
+         + dp::encoded_size_of(value);
+}
+
+} // namespace dplx::dp
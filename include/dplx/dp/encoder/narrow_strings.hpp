@@ -12,6 +12,8 @@
 #include <dplx/dp/concepts.hpp>
 #include <dplx/dp/encoder/api.hpp>
 #include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
 
 namespace dplx::dp
 {
@@ -27,11 +29,21 @@ public:
     auto operator()(Stream &outStream, value_type value) const -> result<void>
     {
         auto const size = value.size();
+        auto const *const data
+                = reinterpret_cast<std::byte const *>(value.data());
+        if constexpr (has_stream_state<Stream, stringref_table>)
+        {
+            DPLX_TRY(bool const referenced,
+                     detail::emit_stringref(outStream, true, data, size));
+            if (referenced)
+            {
+                return success();
+            }
+        }
+
         DPLX_TRY(emit::u8string(outStream, size));
 
-        DPLX_TRY(dp::write(outStream,
-                           reinterpret_cast<std::byte const *>(value.data()),
-                           size));
+        DPLX_TRY(dp::write(outStream, data, size));
         return success();
     }
 };
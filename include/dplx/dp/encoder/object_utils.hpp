@@ -7,38 +7,183 @@
 
 #pragma once
 
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+
 #include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/mp_for_dots.hpp>
+#include <dplx/dp/detail/item_size.hpp>
 #include <dplx/dp/detail/mp_lite.hpp>
+#include <dplx/dp/detail/pre_encoded.hpp>
+#include <dplx/dp/detail/type_utils.hpp>
 #include <dplx/dp/disappointment.hpp>
 #include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/fixed_shape.hpp>
 #include <dplx/dp/item_emitter.hpp>
 #include <dplx/dp/layout_descriptor.hpp>
 #include <dplx/dp/object_def.hpp>
 #include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+#include <dplx/dp/type_code.hpp>
 
 namespace dplx::dp::detail
 {
 
-template <typename T, typename Stream>
+template <auto const &descriptor, typename T, typename Stream>
 struct mp_encode_object_property_fn
 {
     Stream &outStream;
     T const &value;
 
-    template <typename PropDefType>
-    inline auto operator()(PropDefType const &propertyDef) -> result<void>
+    template <std::size_t I>
+    inline auto operator()(mp_size_t<I>) -> result<void>
     {
-        using key_encoder
-                = basic_encoder<typename PropDefType::id_type, Stream>;
-        using value_encoder
-                = basic_encoder<typename PropDefType::value_type, Stream>;
-
-        DPLX_TRY(key_encoder()(outStream, propertyDef.id));
-        DPLX_TRY(value_encoder()(outStream, propertyDef.access(value)));
+        using property_def_type = remove_cref_t<
+                decltype(descriptor.template property<I>())>;
+        using id_type = typename property_def_type::id_type;
+        using key_encoder = basic_encoder<id_type, Stream>;
+        using value_encoder = basic_encoder<
+                typename property_def_type::value_type, Stream>;
+
+        if constexpr (has_stream_state<Stream, stringref_table>
+                      && is_fixed_u8string_v<id_type>
+                      && !(descriptor.use_property_aliases
+                           && aliased_property<property_def_type>))
+        {
+            // textual keys take part in the stringref namespace
+            DPLX_TRY(key_encoder()(outStream, property_def_type::id));
+        }
+        else if constexpr (pre_encodable_property_id<id_type>)
+        {
+            constexpr auto const &encodedId
+                    = detail::encoded_property_key<descriptor,
+                                                   property_def_type>;
+            DPLX_TRY(write(outStream, encodedId.data(), encodedId.size()));
+        }
+        else
+        {
+            DPLX_TRY(key_encoder()(outStream, property_def_type::id));
+        }
+        DPLX_TRY(value_encoder()(outStream,
+                                 property_def_type::access(value)));
         return oc::success();
     }
 };
 
+template <auto const &descriptor>
+using presence_bitmap = std::array<std::uint64_t,
+                                   detail::presence_bitmap_size<descriptor>>;
+
+template <auto const &descriptor, typename T>
+inline auto object_presence_bitmap(T const &value)
+        -> presence_bitmap<descriptor>
+{
+    presence_bitmap<descriptor> bitmap{};
+    std::size_t i = 0u;
+    descriptor.mp_for_each([&](auto const &propertyDef) {
+        if (!detail::is_omitted_property(propertyDef, value))
+        {
+            bitmap[i / presence_word_bits] |= std::uint64_t{1}
+                                           << (i % presence_word_bits);
+        }
+        ++i;
+    });
+    return bitmap;
+}
+
+template <std::size_t N>
+constexpr auto presence_count(std::array<std::uint64_t, N> const &bitmap)
+        -> std::uint64_t
+{
+    std::uint64_t count = 0u;
+    for (auto const word : bitmap)
+    {
+        count += static_cast<std::uint64_t>(std::popcount(word));
+    }
+    return count;
+}
+
+template <auto const &descriptor, typename T, typename Stream>
+struct mp_encode_present_property_fn
+{
+    Stream &outStream;
+    T const &value;
+    presence_bitmap<descriptor> const &presence;
+
+    template <std::size_t I>
+    inline auto operator()(mp_size_t<I>) -> result<void>
+    {
+        using property_def_type = remove_cref_t<
+                decltype(descriptor.template property<I>())>;
+        using value_encoder = basic_encoder<
+                typename property_def_type::value_type, Stream>;
+
+        if ((presence[I / presence_word_bits] >> (I % presence_word_bits)
+             & 1u)
+            == 0u)
+        {
+            return oc::success();
+        }
+        if constexpr (descriptor.encoding == object_encoding::sparse_map)
+        {
+            return mp_encode_object_property_fn<descriptor, T, Stream>{
+                    outStream, value}(mp_size_t<I>{});
+        }
+        else
+        {
+            return value_encoder()(outStream,
+                                   property_def_type::access(value));
+        }
+    }
+};
+
+// encodes the object with one of the sparse object encodings. The version is
+// omitted if it equals null_def_version.
+template <auto const &descriptor, typename T, typename Stream>
+inline auto encode_sparse_object(Stream &outStream,
+                                 T const &value,
+                                 std::uint32_t const version) -> result<void>
+{
+    using emit = item_emitter<Stream>;
+    using encode_property_fn
+            = mp_encode_present_property_fn<descriptor, T, Stream>;
+
+    auto const presence = detail::object_presence_bitmap<descriptor>(value);
+    auto const numPresent = detail::presence_count(presence);
+    bool const hasVersion = version != null_def_version;
+
+    if constexpr (descriptor.encoding == object_encoding::sparse_map)
+    {
+        DPLX_TRY(emit::map(outStream, numPresent + hasVersion));
+        if (hasVersion)
+        {
+            // the version property id is posint 0
+            DPLX_TRY(emit::integer(outStream, 0u));
+            DPLX_TRY(emit::integer(outStream, version));
+        }
+    }
+    else
+    {
+        DPLX_TRY(emit::array(outStream,
+                             hasVersion + presence.size() + numPresent));
+        if (hasVersion)
+        {
+            DPLX_TRY(emit::integer(outStream, version));
+        }
+        for (auto const word : presence)
+        {
+            DPLX_TRY(emit::integer(outStream, word));
+        }
+    }
+
+    return detail::mp_for_dots<descriptor.num_properties>(
+            encode_property_fn{outStream, value, presence});
+}
+
 } // namespace dplx::dp::detail
 
 namespace dplx::dp
@@ -53,11 +198,21 @@ public:
     auto operator()(Stream &outStream, value_type const &value) const
             -> result<void>
     {
+        auto const *const data
+                = reinterpret_cast<std::byte const *>(value.data());
+        if constexpr (has_stream_state<Stream, stringref_table>)
+        {
+            DPLX_TRY(bool const referenced,
+                     detail::emit_stringref(outStream, true, data,
+                                            value.size()));
+            if (referenced)
+            {
+                return success();
+            }
+        }
         DPLX_TRY(item_emitter<Stream>::u8string(outStream, value.size()));
 
-        DPLX_TRY(write(outStream,
-                       reinterpret_cast<std::byte const *>(value.data()),
-                       value.size()));
+        DPLX_TRY(write(outStream, data, value.size()));
 
         return success();
     }
@@ -66,30 +221,29 @@ public:
 template <auto const &descriptor, typename T, output_stream Stream>
 inline auto encode_object(Stream &outStream, T const &value) -> result<void>
 {
-    using emit = item_emitter<Stream>;
-    using encode_property_fn = detail::mp_encode_object_property_fn<T, Stream>;
+    static_assert(descriptor.version == null_def_version
+                          || descriptor.encoding
+                                     == object_encoding::presence_bitmap
+                          || !descriptor.claims_version_key,
+                  "versioned objects must not use posint 0 as property key");
 
-    if constexpr (descriptor.version == null_def_version)
+    using encode_property_fn
+            = detail::mp_encode_object_property_fn<descriptor, T, Stream>;
+
+    if constexpr (descriptor.encoding != object_encoding::map)
     {
-        DPLX_TRY(emit::map(outStream, descriptor.num_properties));
+        return detail::encode_sparse_object<descriptor>(outStream, value,
+                                                        descriptor.version);
     }
     else
     {
-        DPLX_TRY(emit::map(outStream, descriptor.num_properties + 1));
-
-        DPLX_TRY(auto &&versionIdWriteProxy, write(outStream, 1));
-        std::ranges::data(versionIdWriteProxy)[0] = std::byte{};
-        if constexpr (lazy_output_stream<Stream>)
-        {
-            DPLX_TRY(consume(outStream, versionIdWriteProxy));
-        }
+        constexpr auto const &encodedHead
+                = detail::encoded_object_head<descriptor>;
+        DPLX_TRY(write(outStream, encodedHead.data(), encodedHead.size()));
 
-        DPLX_TRY(emit::integer(outStream, descriptor.version));
+        return detail::mp_for_dots<descriptor.num_properties>(
+                encode_property_fn{outStream, value});
     }
-
-    DPLX_TRY(descriptor.mp_for_dots(encode_property_fn{outStream, value}));
-
-    return success();
 }
 
 template <auto const &descriptor, typename T, output_stream Stream>
@@ -97,25 +251,28 @@ inline auto encode_object(Stream &outStream,
                           T const &value,
                           std::uint32_t version) -> result<void>
 {
-    using encode_property_fn = detail::mp_encode_object_property_fn<T, Stream>;
+    static_assert(descriptor.encoding == object_encoding::presence_bitmap
+                          || !descriptor.claims_version_key,
+                  "versioned objects must not use posint 0 as property key");
 
-    DPLX_TRY(item_emitter<Stream>::map(outStream,
-                                       descriptor.num_properties + 1));
+    using encode_property_fn
+            = detail::mp_encode_object_property_fn<descriptor, T, Stream>;
 
+    if constexpr (descriptor.encoding != object_encoding::map)
     {
-        DPLX_TRY(auto &&versionIdWriteProxy, write(outStream, 1));
-        std::ranges::data(versionIdWriteProxy)[0] = std::byte{};
-
-        if constexpr (lazy_output_stream<Stream>)
-        {
-            DPLX_TRY(consume(outStream, versionIdWriteProxy));
-        }
+        return detail::encode_sparse_object<descriptor>(outStream, value,
+                                                        version);
     }
-    DPLX_TRY(item_emitter<Stream>::integer(outStream, version));
-
-    DPLX_TRY(descriptor.mp_for_dots(encode_property_fn{outStream, value}));
+    else
+    {
+        constexpr auto const &encodedHead
+                = detail::encoded_versioned_object_head<descriptor>;
+        DPLX_TRY(write(outStream, encodedHead.data(), encodedHead.size()));
+        DPLX_TRY(item_emitter<Stream>::integer(outStream, version));
 
-    return success();
+        return detail::mp_for_dots<descriptor.num_properties>(
+                encode_property_fn{outStream, value});
+    }
 }
 
 template <packable_object T, output_stream Stream>
@@ -127,6 +284,15 @@ public:
     auto operator()(Stream &outStream, value_type const &value) const
             -> result<void>
     {
+        if constexpr (single_reservation_encodable_to<T, Stream>)
+        {
+            DPLX_TRY(auto &&encoded,
+                     detail::try_encode_single_reservation(outStream, value));
+            if (encoded)
+            {
+                return success();
+            }
+        }
         return dp::encode_object<layout_descriptor_for_v<T>, T, Stream>(
                 outStream, value);
     }
@@ -135,49 +301,186 @@ public:
 namespace detail
 {
 
-template <typename T>
+template <auto const &descriptor, typename T>
 struct encoded_size_of_property
 {
     T const &value;
 
-    constexpr auto operator()(auto const &propertyDef) const noexcept
+    template <typename PropDefType>
+    constexpr auto operator()(PropDefType const &propertyDef) const noexcept
+            -> std::uint64_t
     {
-        auto const idSize = encoded_size_of(propertyDef.id);
         auto const valueSize = encoded_size_of(propertyDef.access(value));
-        return idSize + valueSize;
+        if constexpr (pre_encodable_property_id<
+                              typename PropDefType::id_type>)
+        {
+            return encoded_property_key<descriptor, PropDefType>.size()
+                 + valueSize;
+        }
+        else
+        {
+            return encoded_size_of(PropDefType::id) + valueSize;
+        }
     }
 };
 
 } // namespace detail
 
-template <auto const &descriptor, typename T>
-inline constexpr auto encoded_size_of_object(T const &value) noexcept
-        -> std::size_t
+namespace detail
+{
+
+// the size of the head items of a sparse object encoding
+template <auto const &descriptor>
+inline auto sparse_object_head_size(presence_bitmap<descriptor> const &presence)
+        -> std::uint64_t
 {
-    constexpr auto hasVersion = descriptor.version != null_def_version;
+    constexpr bool hasVersion = descriptor.version != null_def_version;
+    auto const numPresent = detail::presence_count(presence);
+
+    if constexpr (descriptor.encoding == object_encoding::sparse_map)
+    {
+        return detail::var_uint_encoded_size(numPresent + hasVersion)
+             + (hasVersion ? 1u + detail::var_uint_encoded_size(
+                                     descriptor.version)
+                           : 0u);
+    }
+    else
+    {
+        std::uint64_t size = detail::var_uint_encoded_size(
+                hasVersion + presence.size() + numPresent);
+        if constexpr (hasVersion)
+        {
+            size += detail::var_uint_encoded_size(descriptor.version);
+        }
+        for (auto const word : presence)
+        {
+            size += detail::var_uint_encoded_size(word);
+        }
+        return size;
+    }
+}
 
-    auto const sizeOfProps = descriptor.mp_map_fold_left(
-            detail::encoded_size_of_property<T>{value});
+template <auto const &descriptor, typename T, typename SizeOfValueFn>
+inline auto encoded_size_of_sparse_object(T const &value,
+                                          SizeOfValueFn &&sizeOfValue)
+        -> std::uint64_t
+{
+    auto const presence = detail::object_presence_bitmap<descriptor>(value);
+    std::uint64_t size = detail::sparse_object_head_size<descriptor>(presence);
+
+    std::size_t i = 0u;
+    descriptor.mp_for_each([&]<typename PropDefType>(
+                                   PropDefType const &propertyDef) {
+        if ((presence[i / presence_word_bits] >> (i % presence_word_bits) & 1u)
+            != 0u)
+        {
+            if constexpr (descriptor.encoding == object_encoding::sparse_map)
+            {
+                if constexpr (pre_encodable_property_id<
+                                      typename PropDefType::id_type>)
+                {
+                    size += encoded_property_key<descriptor, PropDefType>
+                                    .size();
+                }
+                else
+                {
+                    size += encoded_size_of(PropDefType::id);
+                }
+            }
+            size += sizeOfValue(propertyDef.access(value));
+        }
+        ++i;
+    });
+    return size;
+}
 
-    auto const prefixSize = detail::var_uint_encoded_size(
-            descriptor.num_properties + hasVersion);
+} // namespace detail
 
-    if constexpr (hasVersion)
+template <auto const &descriptor, typename T>
+inline constexpr auto encoded_size_of_object(T const &value) noexcept
+        -> std::uint64_t
+{
+    if constexpr (descriptor.encoding != object_encoding::map)
     {
-        return prefixSize + 1u + encoded_size_of(descriptor.version)
-             + sizeOfProps;
+        return detail::encoded_size_of_sparse_object<descriptor>(
+                value, [](auto const &propertyValue) {
+                    return encoded_size_of(propertyValue);
+                });
     }
     else
     {
-        return prefixSize + sizeOfProps;
+        auto const sizeOfProps = descriptor.mp_map_fold_left(
+                detail::encoded_size_of_property<descriptor, T>{value});
+
+        return detail::encoded_object_head<descriptor>.size() + sizeOfProps;
     }
 }
 
 template <packable_object T>
 inline constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
-        -> std::size_t
+        -> std::uint64_t
 {
     return dp::encoded_size_of_object<layout_descriptor_for_v<T>, T>(value);
 }
 
+namespace detail
+{
+
+template <auto const &descriptor, typename T>
+struct memoized_encoded_size_of_property
+{
+    T const &value;
+    encoded_size_memo &memo;
+    std::uint64_t &accumulator;
+
+    template <typename PropDefType>
+    void operator()(PropDefType const &propertyDef) const
+    {
+        if constexpr (pre_encodable_property_id<
+                              typename PropDefType::id_type>)
+        {
+            accumulator
+                    += encoded_property_key<descriptor, PropDefType>.size();
+        }
+        else
+        {
+            accumulator += encoded_size_of(PropDefType::id);
+        }
+        accumulator += encoded_size_of(propertyDef.access(value), memo);
+    }
+};
+
+} // namespace detail
+
+template <auto const &descriptor, typename T>
+inline auto encoded_size_of_object(T const &value, encoded_size_memo &memo)
+        -> std::uint64_t
+{
+    if constexpr (descriptor.encoding != object_encoding::map)
+    {
+        return detail::encoded_size_of_sparse_object<descriptor>(
+                value, [&memo](auto const &propertyValue) {
+                    return encoded_size_of(propertyValue, memo);
+                });
+    }
+    else
+    {
+        std::uint64_t accumulator
+                = detail::encoded_object_head<descriptor>.size();
+        descriptor.mp_for_each(
+                detail::memoized_encoded_size_of_property<descriptor, T>{
+                        value, memo, accumulator});
+        return accumulator;
+    }
+}
+
+template <packable_object T>
+inline auto
+tag_invoke(encoded_size_of_fn, T const &value, encoded_size_memo &memo)
+        -> std::uint64_t
+{
+    return dp::encoded_size_of_object<layout_descriptor_for_v<T>, T>(value,
+                                                                     memo);
+}
+
 } // namespace dplx::dp
@@ -0,0 +1,253 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#if __has_include(<boost/dynamic_bitset/dynamic_bitset.hpp>)
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#endif
+
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/packed_bits.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp::detail
+{
+
+// writes the packed bits in chunks
+template <output_stream Stream>
+class packed_bits_writer
+{
+    static constexpr std::size_t chunk_size = 256u;
+
+    Stream &mStream;
+    std::size_t mFill;
+    std::byte mChunk[chunk_size];
+
+public:
+    explicit packed_bits_writer(Stream &outStream) noexcept
+        : mStream(outStream)
+        , mFill(0u)
+    {
+    }
+
+    // emits the tag and the byte string head and buffers the padding size
+    auto start(std::uint64_t const numBits) -> result<void>
+    {
+        using emit = item_emitter<Stream>;
+
+        DPLX_TRY(emit::tag(mStream, packed_bits_tag));
+        DPLX_TRY(emit::binary(mStream,
+                              detail::packed_bits_payload_size(numBits)));
+        mChunk[0] = static_cast<std::byte>((8u - numBits % 8u) % 8u);
+        mFill = 1u;
+        return oc::success();
+    }
+
+    // buffers the numBits low bits of word in little endian byte order. Only
+    // the last word may have a bit count which isn't a multiple of eight.
+    auto put(std::uint64_t const word, std::size_t const numBits)
+            -> result<void>
+    {
+        if (mFill > chunk_size - sizeof(word))
+        {
+            DPLX_TRY(flush());
+        }
+        boost::endian::endian_store<std::uint64_t, sizeof(word),
+                                    boost::endian::order::little>(
+                reinterpret_cast<unsigned char *>(mChunk + mFill), word);
+        mFill += (numBits + 7u) / 8u;
+        return oc::success();
+    }
+
+    auto flush() -> result<void>
+    {
+        if (mFill > 0u)
+        {
+            DPLX_TRY(dp::write(mStream, mChunk, mFill));
+            mFill = 0u;
+        }
+        return oc::success();
+    }
+};
+
+// gathers packed_bits_word_size bits at a time from bitAt(i)
+template <output_stream Stream, typename BitAtFn>
+inline auto encode_packed_bits(Stream &outStream,
+                               std::size_t const numBits,
+                               BitAtFn &&bitAt) -> result<void>
+{
+    packed_bits_writer<Stream> writer(outStream);
+    DPLX_TRY(writer.start(numBits));
+
+    for (std::size_t offset = 0u; offset < numBits;
+         offset += packed_bits_word_size)
+    {
+        auto const wordSize = std::min(packed_bits_word_size, numBits - offset);
+        std::uint64_t word = 0u;
+        for (std::size_t i = 0u; i < wordSize; ++i)
+        {
+            word |= static_cast<std::uint64_t>(bitAt(offset + i)) << i;
+        }
+        DPLX_TRY(writer.put(word, wordSize));
+    }
+    return writer.flush();
+}
+
+// an output iterator which passes the assigned blocks to fn
+template <typename Fn>
+class block_sink
+{
+    Fn *mFn;
+
+public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    explicit block_sink(Fn &fn) noexcept
+        : mFn(&fn)
+    {
+    }
+
+    template <typename Block>
+        requires std::invocable<Fn &, Block const &>
+    auto operator=(Block const &block) -> block_sink &
+    {
+        (*mFn)(block);
+        return *this;
+    }
+    auto operator*() noexcept -> block_sink &
+    {
+        return *this;
+    }
+    auto operator++() noexcept -> block_sink &
+    {
+        return *this;
+    }
+    auto operator++(int) noexcept -> block_sink
+    {
+        return *this;
+    }
+};
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+template <typename Allocator, output_stream Stream>
+class basic_encoder<std::vector<bool, Allocator>, Stream>
+{
+public:
+    using value_type = std::vector<bool, Allocator>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        return detail::encode_packed_bits(
+                outStream, value.size(),
+                [&value](std::size_t const i) -> bool { return value[i]; });
+    }
+};
+
+template <typename Allocator>
+constexpr auto tag_invoke(encoded_size_of_fn,
+                          std::vector<bool, Allocator> const &value) noexcept
+        -> std::uint64_t
+{
+    return detail::packed_bits_encoded_size(value.size());
+}
+
+template <std::size_t N, output_stream Stream>
+class basic_encoder<std::bitset<N>, Stream>
+{
+public:
+    using value_type = std::bitset<N>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        return detail::encode_packed_bits(
+                outStream, N,
+                [&value](std::size_t const i) -> bool { return value[i]; });
+    }
+};
+
+template <std::size_t N>
+constexpr auto tag_invoke(encoded_size_of_fn, std::bitset<N> const &) noexcept
+        -> std::uint64_t
+{
+    return detail::packed_bits_encoded_size(N);
+}
+
+// boost::dynamic_bitset is only supported if its header is available
+#if __has_include(<boost/dynamic_bitset/dynamic_bitset.hpp>)
+
+// the blocks are written as they are, i.e. without gathering single bits
+template <typename Block, typename Allocator, output_stream Stream>
+    requires(std::numeric_limits<Block>::digits
+             <= detail::packed_bits_word_size)
+class basic_encoder<boost::dynamic_bitset<Block, Allocator>, Stream>
+{
+public:
+    using value_type = boost::dynamic_bitset<Block, Allocator>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        detail::packed_bits_writer<Stream> writer(outStream);
+        DPLX_TRY(writer.start(value.size()));
+
+        // to_block_range() can't be interrupted, therefore the first failure
+        // is kept and the remaining blocks are skipped
+        std::size_t remaining = value.size();
+        result<void> rx = oc::success();
+        auto putBlock = [&](Block const block) {
+            if (rx.has_failure())
+            {
+                return;
+            }
+            auto const blockSize = std::min<std::size_t>(
+                    value_type::bits_per_block, remaining);
+            remaining -= blockSize;
+            rx = writer.put(block, blockSize);
+        };
+        boost::to_block_range(value, detail::block_sink(putBlock));
+        DPLX_TRY(rx);
+        return writer.flush();
+    }
+};
+
+template <typename Block, typename Allocator>
+inline auto
+tag_invoke(encoded_size_of_fn,
+           boost::dynamic_bitset<Block, Allocator> const &value) noexcept
+        -> std::uint64_t
+{
+    return detail::packed_bits_encoded_size(value.size());
+}
+
+#endif
+
+} // namespace dplx::dp
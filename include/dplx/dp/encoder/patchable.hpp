@@ -0,0 +1,61 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+#include <ranges>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/patchable.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+template <typename T, output_stream Stream>
+class basic_encoder<patchable<T>, Stream>
+{
+public:
+    using value_type = patchable<T>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        if constexpr (iec559_floating_point<T>)
+        {
+            // floating point numbers are always emitted with their full width
+            return basic_encoder<T, Stream>()(outStream, value.value);
+        }
+        else
+        {
+            DPLX_TRY(auto &&writeLease, dp::write(outStream, 1 + sizeof(T)));
+
+            detail::store_fixed_width_integer(std::ranges::data(writeLease),
+                                              value.value);
+
+            if constexpr (lazy_output_stream<Stream>)
+            {
+                DPLX_TRY(dp::commit(outStream, writeLease));
+            }
+            return oc::success();
+        }
+    }
+};
+
+template <typename T>
+constexpr auto tag_invoke(encoded_size_of_fn, patchable<T> const &) noexcept
+        -> std::uint64_t
+{
+    return 1u + sizeof(T);
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,71 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+#include <dplx/dp/detail/splice_item.hpp>
+#include <dplx/dp/detail/utils.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/raw_item.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+// an empty (i.e. default constructed or moved-from) item isn't a CBOR item
+// and is therefore rejected
+template <output_stream Stream>
+class basic_encoder<raw_item, Stream>
+{
+public:
+    using value_type = raw_item;
+
+    auto operator()(Stream &outStream, raw_item const &value) const
+            -> result<void>
+    {
+        if (value.empty())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::invalid_argument;
+            }
+        return detail::splice_item(outStream, value.encoded());
+    }
+};
+inline auto tag_invoke(encoded_size_of_fn, raw_item const &value) noexcept
+        -> std::uint64_t
+{
+    return value.size();
+}
+
+template <output_stream Stream>
+class basic_encoder<raw_item_view, Stream>
+{
+public:
+    using value_type = raw_item_view;
+
+    auto operator()(Stream &outStream, raw_item_view const &value) const
+            -> result<void>
+    {
+        if (value.empty())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::invalid_argument;
+            }
+        return detail::splice_item(outStream, value.encoded());
+    }
+};
+inline auto tag_invoke(encoded_size_of_fn,
+                       raw_item_view const &value) noexcept
+        -> std::uint64_t
+{
+    return value.size();
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,54 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
+
+namespace dplx::dp
+{
+
+// encodes the value within a stringref namespace, i.e. repeated text and
+// byte strings are replaced by references. A stringref_table which is
+// already attached to the stream is cleared and reused.
+//
+// Note that encoded_size_of() doesn't account for the references.
+inline constexpr struct encode_stringref_fn final
+{
+    template <typename T, output_stream Stream>
+        requires(has_stream_state<Stream, stringref_table>
+                 && encodable<T, Stream>)
+    inline auto operator()(Stream &outStream, T const &value) const
+            -> result<void>
+    {
+        dp::get_stream_state<stringref_table>(outStream).clear();
+        DPLX_TRY(item_emitter<Stream>::tag(outStream, stringref_namespace_tag));
+        DPLX_TRY((basic_encoder<T, Stream>()(outStream, value)));
+        return success();
+    }
+
+    template <typename T, output_stream Stream>
+        requires(!has_stream_state<Stream, stringref_table>
+                 && encodable<T, stateful_stream<Stream, stringref_table>>)
+    inline auto operator()(Stream &outStream, T const &value) const
+            -> result<void>
+    {
+        using stringref_stream = stateful_stream<Stream, stringref_table>;
+
+        stringref_table table;
+        stringref_stream stringrefStream(outStream, table);
+        return (*this)(stringrefStream, value);
+    }
+
+} encode_stringref{};
+
+} // namespace dplx::dp
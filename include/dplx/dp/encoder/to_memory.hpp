@@ -0,0 +1,136 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/encoded_size_memo.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/streams/unchecked_memory_output_stream.hpp>
+
+namespace dplx::dp
+{
+
+// the sizes recorded during the sizing pass are made available to the
+// encoders via the stream state
+using memoized_memory_buffer
+        = stateful_stream<unchecked_memory_buffer, encoded_size_memo>;
+
+// clang-format off
+template <typename T>
+concept encodable_to_memory
+    = encodable<T, memoized_memory_buffer>
+    && tag_invocable<encoded_size_of_fn, T const &>;
+// clang-format on
+
+namespace detail
+{
+
+template <typename T>
+inline auto memoized_encoded_size_of(T const &value, encoded_size_memo &memo)
+        -> result<std::uint64_t>
+{
+    try
+    {
+        return dp::encoded_size_of(value, memo);
+    }
+    catch (std::bad_alloc const &)
+    {
+        return errc::not_enough_memory;
+    }
+}
+
+inline auto padded_encoding_size(std::uint64_t const encodedSize) noexcept
+        -> result<std::size_t>
+{
+    if (encodedSize > std::numeric_limits<std::size_t>::max()
+                              - unchecked_output_padding)
+    {
+        return errc::not_enough_memory;
+    }
+    return static_cast<std::size_t>(encodedSize) + unchecked_output_padding;
+}
+
+} // namespace detail
+
+// computes the exact encoded size of the value, allocates the memory in one
+// go and encodes the value without any per item bounds checks. Subtree sizes
+// which are needed during encoding are computed only once.
+inline constexpr struct encode_to_vector_fn final
+{
+    template <typename T>
+        requires encodable_to_memory<detail::remove_cref_t<T>>
+    inline auto operator()(T const &value) const
+            -> result<std::vector<std::byte>>
+    {
+        encoded_size_memo memo;
+        DPLX_TRY(auto encodedSize,
+                 detail::memoized_encoded_size_of(value, memo));
+        DPLX_TRY(auto paddedSize, detail::padded_encoding_size(encodedSize));
+
+        std::vector<std::byte> encoded;
+        try
+        {
+            encoded.resize(paddedSize);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+
+        unchecked_memory_buffer buffer{std::span<std::byte>(encoded)};
+        memoized_memory_buffer outStream{buffer, memo};
+        DPLX_TRY((basic_encoder<detail::remove_cref_t<T>,
+                                memoized_memory_buffer>()(outStream, value)));
+
+        // the padding is retained as spare capacity; releasing it would
+        // reallocate and copy the whole encoding
+        encoded.resize(buffer.written_size());
+        return dp::success(std::move(encoded));
+    }
+} encode_to_vector{};
+
+inline constexpr struct encode_to_allocation_fn final
+{
+    template <typename T, typename Allocator = std::allocator<std::byte>>
+        requires encodable_to_memory<detail::remove_cref_t<T>>
+    inline auto operator()(T const &value,
+                           Allocator const &allocator = Allocator()) const
+            -> result<memory_allocation<Allocator>>
+    {
+        encoded_size_memo memo;
+        DPLX_TRY(auto encodedSize,
+                 detail::memoized_encoded_size_of(value, memo));
+        DPLX_TRY(auto paddedSize, detail::padded_encoding_size(encodedSize));
+
+        memory_allocation<Allocator> encoded(allocator);
+        DPLX_TRY(encoded.resize(paddedSize));
+
+        unchecked_memory_buffer buffer{encoded.as_span()};
+        memoized_memory_buffer outStream{buffer, memo};
+        DPLX_TRY((basic_encoder<detail::remove_cref_t<T>,
+                                memoized_memory_buffer>()(outStream, value)));
+
+        DPLX_TRY(encoded.truncate(buffer.written_size()));
+        return dp::success(std::move(encoded));
+    }
+} encode_to_allocation{};
+
+} // namespace dplx::dp
@@ -7,17 +7,22 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <type_traits>
 
 #include <dplx/dp/concepts.hpp>
 #include <dplx/dp/detail/mp_lite.hpp>
+#include <dplx/dp/detail/pre_encoded.hpp>
 #include <dplx/dp/disappointment.hpp>
 #include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/fixed_shape.hpp>
 #include <dplx/dp/fwd.hpp>
 #include <dplx/dp/item_emitter.hpp>
 #include <dplx/dp/layout_descriptor.hpp>
 #include <dplx/dp/stream.hpp>
 #include <dplx/dp/tuple_def.hpp>
+#include <dplx/dp/type_code.hpp>
 
 namespace dplx::dp::detail
 {
@@ -47,18 +52,10 @@ namespace dplx::dp
 template <auto const &descriptor, typename T, output_stream Stream>
 inline auto encode_tuple(Stream &outStream, T const &value) -> result<void>
 {
-    using emit = item_emitter<Stream>;
     using encode_value_fn = detail::mp_encode_value_fn<T, Stream>;
 
-    if constexpr (descriptor.version == null_def_version)
-    {
-        DPLX_TRY(emit::array(outStream, descriptor.num_properties));
-    }
-    else
-    {
-        DPLX_TRY(emit::array(outStream, descriptor.num_properties + 1));
-        DPLX_TRY(emit::integer(outStream, descriptor.version));
-    }
+    constexpr auto const &encodedHead = detail::encoded_tuple_head<descriptor>;
+    DPLX_TRY(write(outStream, encodedHead.data(), encodedHead.size()));
 
     DPLX_TRY(descriptor.mp_for_dots(encode_value_fn{outStream, value}));
 
@@ -90,6 +87,15 @@ public:
     auto operator()(Stream &outStream, value_type const &value) const
             -> result<void>
     {
+        if constexpr (single_reservation_encodable_to<T, Stream>)
+        {
+            DPLX_TRY(auto &&encoded,
+                     detail::try_encode_single_reservation(outStream, value));
+            if (encoded)
+            {
+                return success();
+            }
+        }
         return dp::encode_tuple<layout_descriptor_for_v<T>, T, Stream>(
                 outStream, value);
     }
@@ -104,6 +110,7 @@ struct encoded_size_of_tuple_member
     T const &value;
 
     constexpr auto operator()(auto const &propertyDef) const noexcept
+            -> std::uint64_t
     {
         return encoded_size_of(propertyDef.access(value));
     }
@@ -112,32 +119,57 @@ struct encoded_size_of_tuple_member
 } // namespace detail
 
 template <auto const &descriptor, typename T>
-constexpr auto encoded_size_of_tuple(T const &value) noexcept -> std::size_t
+constexpr auto encoded_size_of_tuple(T const &value) noexcept
+        -> std::uint64_t
 {
-    constexpr auto hasVersion = descriptor.version != null_def_version;
-
     auto const sizeOfProps = descriptor.mp_map_fold_left(
             detail::encoded_size_of_tuple_member<T>{value});
 
-    auto const prefixSize = detail::var_uint_encoded_size(
-            descriptor.num_properties + hasVersion);
+    return detail::encoded_tuple_head<descriptor>.size() + sizeOfProps;
+}
+
+template <packable_tuple T>
+constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
+        -> std::uint64_t
+{
+    return dp::encoded_size_of_tuple<layout_descriptor_for_v<T>, T>(value);
+}
 
-    if constexpr (hasVersion)
-    {
-        return prefixSize + detail::var_uint_encoded_size(descriptor.version)
-             + sizeOfProps;
-    }
-    else
+namespace detail
+{
+
+template <typename T>
+struct memoized_encoded_size_of_tuple_member
+{
+    T const &value;
+    encoded_size_memo &memo;
+    std::uint64_t &accumulator;
+
+    void operator()(auto const &propertyDef) const
     {
-        return prefixSize + sizeOfProps;
+        accumulator += encoded_size_of(propertyDef.access(value), memo);
     }
+};
+
+} // namespace detail
+
+template <auto const &descriptor, typename T>
+inline auto encoded_size_of_tuple(T const &value, encoded_size_memo &memo)
+        -> std::uint64_t
+{
+    std::uint64_t accumulator = detail::encoded_tuple_head<descriptor>.size();
+    descriptor.mp_for_each(detail::memoized_encoded_size_of_tuple_member<T>{
+            value, memo, accumulator});
+    return accumulator;
 }
 
 template <packable_tuple T>
-constexpr auto tag_invoke(encoded_size_of_fn, T const &value) noexcept
-        -> std::size_t
+inline auto
+tag_invoke(encoded_size_of_fn, T const &value, encoded_size_memo &memo)
+        -> std::uint64_t
 {
-    return dp::encoded_size_of_tuple<layout_descriptor_for_v<T>, T>(value);
+    return dp::encoded_size_of_tuple<layout_descriptor_for_v<T>, T>(value,
+                                                                    memo);
 }
 
 } // namespace dplx::dp
@@ -0,0 +1,188 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/value.hpp>
+
+namespace dplx::dp
+{
+
+template <output_stream Stream>
+class basic_encoder<value, Stream>
+{
+    using emit = item_emitter<Stream>;
+    using access = detail::value_access;
+
+public:
+    using value_type = value;
+
+    auto operator()(Stream &outStream, value const &item) const
+            -> result<void>
+    {
+        switch (item.kind())
+        {
+        case value_kind::null:
+            return emit::null(outStream);
+
+        case value_kind::undefined:
+            return emit::undefined(outStream);
+
+        case value_kind::boolean:
+            return emit::boolean(outStream, item.as_boolean().assume_value());
+
+        case value_kind::integer:
+            if (access::is_negative(item))
+            {
+                return emit::negint(outStream, access::integer_bits(item));
+            }
+            return emit::integer(outStream, access::integer_bits(item));
+
+        case value_kind::floating_point:
+            if (access::float_width(item) == sizeof(float))
+            {
+                return emit::float_single(
+                        outStream,
+                        static_cast<float>(item.as_double().assume_value()));
+            }
+            return emit::float_double(outStream,
+                                      item.as_double().assume_value());
+
+        case value_kind::text:
+        {
+            auto const bytes = access::string_bytes(item);
+            DPLX_TRY(emit::u8string(outStream, bytes.size()));
+            return write_bytes(outStream, bytes);
+        }
+        case value_kind::binary:
+        {
+            auto const bytes = access::string_bytes(item);
+            DPLX_TRY(emit::binary(outStream, bytes.size()));
+            return write_bytes(outStream, bytes);
+        }
+
+        case value_kind::array:
+        {
+            auto const elements = item.as_array().assume_value();
+            DPLX_TRY(emit::array(outStream, elements.size()));
+            for (auto const &element : elements)
+            {
+                DPLX_TRY((*this)(outStream, element));
+            }
+            return oc::success();
+        }
+        case value_kind::map:
+        {
+            auto const entries = item.as_map().assume_value();
+            DPLX_TRY(emit::map(outStream, entries.size()));
+            for (auto const &entry : entries)
+            {
+                DPLX_TRY((*this)(outStream, entry.key));
+                DPLX_TRY((*this)(outStream, entry.mapped));
+            }
+            return oc::success();
+        }
+        case value_kind::tag:
+            DPLX_TRY(emit::tag(outStream, item.tag_number().assume_value()));
+            return (*this)(outStream, *item.tagged_item().assume_value());
+        }
+        return errc::bad;
+    }
+
+private:
+    static auto write_bytes(Stream &outStream,
+                            std::span<std::byte const> const bytes)
+            -> result<void>
+    {
+        if (bytes.empty())
+        {
+            return oc::success();
+        }
+        return dp::write(outStream, bytes.data(), bytes.size());
+    }
+};
+
+inline auto tag_invoke(encoded_size_of_fn, value const &item) noexcept
+        -> std::uint64_t
+{
+    using access = detail::value_access;
+
+    switch (item.kind())
+    {
+    case value_kind::null:
+    case value_kind::undefined:
+    case value_kind::boolean:
+        return 1u;
+
+    case value_kind::integer:
+        return detail::var_uint_encoded_size(access::integer_bits(item));
+
+    case value_kind::floating_point:
+        return 1u + access::float_width(item);
+
+    case value_kind::text:
+    case value_kind::binary:
+    {
+        auto const size = access::string_bytes(item).size();
+        return detail::var_uint_encoded_size(size) + size;
+    }
+
+    case value_kind::array:
+    {
+        auto const elements = item.as_array().assume_value();
+        std::uint64_t size = detail::var_uint_encoded_size(elements.size());
+        for (auto const &element : elements)
+        {
+            size += dp::encoded_size_of(element);
+        }
+        return size;
+    }
+    case value_kind::map:
+    {
+        auto const entries = item.as_map().assume_value();
+        std::uint64_t size = detail::var_uint_encoded_size(entries.size());
+        for (auto const &entry : entries)
+        {
+            size += dp::encoded_size_of(entry.key)
+                  + dp::encoded_size_of(entry.mapped);
+        }
+        return size;
+    }
+    case value_kind::tag:
+        return detail::var_uint_encoded_size(item.tag_number().assume_value())
+             + dp::encoded_size_of(*item.tagged_item().assume_value());
+    }
+    return 0u;
+}
+
+template <output_stream Stream>
+class basic_encoder<document, Stream>
+{
+public:
+    using value_type = document;
+
+    auto operator()(Stream &outStream, document const &doc) const
+            -> result<void>
+    {
+        return basic_encoder<value, Stream>()(outStream, doc.root());
+    }
+};
+
+inline auto tag_invoke(encoded_size_of_fn, document const &doc) noexcept
+        -> std::uint64_t
+{
+    return dp::encoded_size_of(doc.root());
+}
+
+} // namespace dplx::dp
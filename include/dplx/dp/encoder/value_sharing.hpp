@@ -0,0 +1,109 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <type_traits>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/value_sharing.hpp>
+
+namespace dplx::dp
+{
+
+// an empty pointer is encoded as null. The pointee is only shared if a
+// sharing_index is attached to the stream, see encode_sharing. Otherwise it
+// is encoded inline.
+template <typename T, output_stream Stream>
+    requires encodable<std::remove_cv_t<T>, Stream>
+class basic_encoder<std::shared_ptr<T>, Stream>
+{
+    using emit = item_emitter<Stream>;
+    using element_type = std::remove_cv_t<T>;
+    using element_encoder = basic_encoder<element_type, Stream>;
+
+public:
+    using value_type = std::shared_ptr<T>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        if (!value)
+        {
+            return emit::null(outStream);
+        }
+
+        element_type const &element = *value;
+        if constexpr (has_stream_state<Stream, sharing_index>)
+        {
+            auto &index = dp::get_stream_state<sharing_index>(outStream);
+            DPLX_TRY(std::uint64_t const i, index.find_or_insert(&element));
+            if (i != sharing_index::npos)
+            {
+                DPLX_TRY(emit::tag(outStream, shared_reference_tag));
+                return emit::integer(outStream, i);
+            }
+            DPLX_TRY(emit::tag(outStream, shareable_tag));
+        }
+        return element_encoder()(outStream, element);
+    }
+};
+
+// the size of the inline encoding, i.e. without sharing
+template <typename T>
+    requires tag_invocable<encoded_size_of_fn, std::remove_cv_t<T> const &>
+inline auto tag_invoke(encoded_size_of_fn,
+                       std::shared_ptr<T> const &value) noexcept
+        -> std::uint64_t
+{
+    if (!value)
+    {
+        return 1u;
+    }
+    std::remove_cv_t<T> const &element = *value;
+    return dp::encoded_size_of(element);
+}
+
+// encodes the value with a sharing_index attached to the stream. An index
+// which is already attached is cleared and reused.
+inline constexpr struct encode_sharing_fn final
+{
+    template <typename T, output_stream Stream>
+        requires(has_stream_state<Stream, sharing_index>
+                 && encodable<T, Stream>)
+    inline auto operator()(Stream &outStream, T const &value) const
+            -> result<void>
+    {
+        dp::get_stream_state<sharing_index>(outStream).clear();
+        DPLX_TRY((basic_encoder<T, Stream>()(outStream, value)));
+        return success();
+    }
+
+    template <typename T, output_stream Stream>
+        requires(!has_stream_state<Stream, sharing_index>
+                 && encodable<T, stateful_stream<Stream, sharing_index>>)
+    inline auto operator()(Stream &outStream, T const &value) const
+            -> result<void>
+    {
+        using sharing_stream = stateful_stream<Stream, sharing_index>;
+
+        sharing_index index;
+        sharing_stream sharingStream(outStream, index);
+        return (*this)(sharingStream, value);
+    }
+
+} encode_sharing{};
+
+} // namespace dplx::dp
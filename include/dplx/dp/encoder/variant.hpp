@@ -0,0 +1,145 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <optional>
+#include <variant>
+
+#include <boost/mp11/algorithm.hpp>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/variant.hpp>
+
+namespace dplx::dp
+{
+
+template <typename T, output_stream Stream>
+    requires encodable<T, Stream>
+class basic_encoder<std::optional<T>, Stream>
+{
+    using emit = item_emitter<Stream>;
+
+public:
+    using value_type = std::optional<T>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        if (!value.has_value())
+        {
+            return emit::null(outStream);
+        }
+        return basic_encoder<T, Stream>()(outStream, *value);
+    }
+};
+
+template <typename T>
+    requires tag_invocable<encoded_size_of_fn, T const &>
+inline auto tag_invoke(encoded_size_of_fn,
+                       std::optional<T> const &value) noexcept
+        -> std::uint64_t
+{
+    if (!value.has_value())
+    {
+        return 1u;
+    }
+    return dp::encoded_size_of(*value);
+}
+
+template <std::uint64_t Tag, typename T, output_stream Stream>
+    requires encodable<T, Stream>
+class basic_encoder<tagged<Tag, T>, Stream>
+{
+    using emit = item_emitter<Stream>;
+
+public:
+    using value_type = tagged<Tag, T>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        DPLX_TRY(emit::tag(outStream, Tag));
+        return basic_encoder<T, Stream>()(outStream, value.value);
+    }
+};
+
+template <std::uint64_t Tag, typename T>
+    requires tag_invocable<encoded_size_of_fn, T const &>
+inline auto tag_invoke(encoded_size_of_fn,
+                       tagged<Tag, T> const &value) noexcept -> std::uint64_t
+{
+    return detail::var_uint_encoded_size(Tag)
+         + dp::encoded_size_of(value.value);
+}
+
+// a variant which is valueless by exception can't be encoded
+template <typename... Ts, output_stream Stream>
+    requires(encodable<Ts, Stream> &&...)
+class basic_encoder<std::variant<Ts...>, Stream>
+{
+    using emit = item_emitter<Stream>;
+
+public:
+    using value_type = std::variant<Ts...>;
+
+    auto operator()(Stream &outStream, value_type const &value) const
+            -> result<void>
+    {
+        if (value.valueless_by_exception())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::bad;
+            }
+        if constexpr (variant_encoding_for<value_type>
+                      == variant_encoding::indexed)
+        {
+            DPLX_TRY(emit::array(outStream, 2u));
+            DPLX_TRY(emit::integer(outStream,
+                                   static_cast<std::uint64_t>(value.index())));
+        }
+        return boost::mp11::mp_with_index<sizeof...(Ts)>(
+                value.index(), [&](auto const i) -> result<void> {
+                    using alternative_type
+                            = std::variant_alternative_t<i, value_type>;
+                    return basic_encoder<alternative_type, Stream>()(
+                            outStream, *std::get_if<i>(&value));
+                });
+    }
+};
+
+template <typename... Ts>
+    requires(tag_invocable<encoded_size_of_fn, Ts const &> &&...)
+inline auto tag_invoke(encoded_size_of_fn,
+                       std::variant<Ts...> const &value) noexcept
+        -> std::uint64_t
+{
+    if (value.valueless_by_exception())
+    {
+        return 0u;
+    }
+    std::uint64_t const headSize
+            = variant_encoding_for<std::variant<Ts...>>
+                            == variant_encoding::indexed
+                    ? 1u + detail::var_uint_encoded_size(value.index())
+                    : 0u;
+    return headSize
+         + boost::mp11::mp_with_index<sizeof...(Ts)>(
+                 value.index(), [&](auto const i) -> std::uint64_t {
+                     return dp::encoded_size_of(*std::get_if<i>(&value));
+                 });
+}
+
+} // namespace dplx::dp
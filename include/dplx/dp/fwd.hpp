@@ -22,6 +22,8 @@ class basic_encoder;
 template <typename T, input_stream Stream>
 class basic_decoder;
 
+class encoded_size_memo;
+
 template <typename... TArgs>
 class mp_varargs
 {
@@ -0,0 +1,307 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <compare>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/detail/hash.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/value.hpp>
+
+namespace dplx::dp
+{
+
+class u8string_pool;
+
+// an immutable reference to a string owned by an u8string_pool, i.e. it is
+// as cheap to copy as a string_view and mustn't outlive its pool. Equal
+// strings interned by the same pool share their storage.
+//
+// It is a contiguous range of char8_t and is therefore encoded as text.
+// Decoding requires an u8string_pool attached to the stream, see
+// stateful_stream.
+class interned_u8string
+{
+    friend class u8string_pool;
+
+    char8_t const *mData;
+    std::size_t mSize;
+
+    constexpr interned_u8string(char8_t const *data,
+                                std::size_t const size) noexcept
+        : mData(data)
+        , mSize(size)
+    {
+    }
+
+public:
+    using value_type = char8_t;
+
+    constexpr interned_u8string() noexcept
+        : mData(nullptr)
+        , mSize(0u)
+    {
+    }
+
+    [[nodiscard]] constexpr auto view() const noexcept -> std::u8string_view
+    {
+        return {mData, mSize};
+    }
+    constexpr operator std::u8string_view() const noexcept
+    {
+        return view();
+    }
+
+    [[nodiscard]] constexpr auto data() const noexcept -> char8_t const *
+    {
+        return mData;
+    }
+    [[nodiscard]] constexpr auto size() const noexcept -> std::size_t
+    {
+        return mSize;
+    }
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool
+    {
+        return mSize == 0u;
+    }
+    [[nodiscard]] constexpr auto begin() const noexcept -> char8_t const *
+    {
+        return mData;
+    }
+    [[nodiscard]] constexpr auto end() const noexcept -> char8_t const *
+    {
+        return mData + mSize;
+    }
+
+    friend constexpr auto operator==(interned_u8string const &lhs,
+                                     interned_u8string const &rhs) noexcept
+            -> bool
+    {
+        // the storage comparison short-circuits strings from the same pool
+        return (lhs.mData == rhs.mData && lhs.mSize == rhs.mSize)
+            || lhs.view() == rhs.view();
+    }
+    friend constexpr auto operator<=>(interned_u8string const &lhs,
+                                      interned_u8string const &rhs) noexcept
+            -> std::strong_ordering
+    {
+        return lhs.view() <=> rhs.view();
+    }
+};
+
+namespace detail
+{
+
+inline auto hash_interned(std::u8string_view const str) noexcept
+        -> std::uint64_t
+{
+    return detail::fnvx_hash(str.data(), str.size(), 0u);
+}
+
+} // namespace detail
+
+// deduplicates strings. The string bytes are allocated from a value_arena
+// and indexed by an open addressing hash table, i.e. interning a known
+// string doesn't allocate at all.
+class u8string_pool
+{
+    struct slot
+    {
+        std::uint64_t hash;
+        interned_u8string str;
+    };
+
+    static constexpr std::size_t initial_capacity = 64u;
+
+    value_arena mStorage;
+    std::vector<slot> mSlots;
+    // the interned strings in insertion order
+    std::vector<slot> mInterned;
+    std::u8string mBuffer;
+
+public:
+    u8string_pool() noexcept
+        : mStorage()
+        , mSlots()
+        , mInterned()
+        , mBuffer()
+    {
+    }
+
+    // the number of distinct non-empty strings
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mInterned.size();
+    }
+
+    // the empty string is never stored
+    auto intern(std::u8string_view const str) noexcept
+            -> result<interned_u8string>
+    {
+        if (str.empty())
+        {
+            return interned_u8string();
+        }
+        // the load factor is kept at or below 50%
+        if (mInterned.size() >= mSlots.size() / 2u)
+        {
+            DPLX_TRY(grow());
+        }
+
+        auto const hash = detail::hash_interned(str);
+        auto const mask = mSlots.size() - 1u;
+        for (auto i = static_cast<std::size_t>(hash) & mask;;
+             i = (i + 1u) & mask)
+        {
+            auto &candidate = mSlots[i];
+            if (candidate.str.data() == nullptr)
+            {
+                DPLX_TRY(std::byte * memory,
+                         mStorage.allocate(str.size(), 1u));
+                std::memcpy(memory, str.data(), str.size());
+
+                candidate.hash = hash;
+                candidate.str = interned_u8string(
+                        reinterpret_cast<char8_t const *>(memory), str.size());
+                // cannot throw, because grow() reserves the capacity
+                mInterned.push_back(candidate);
+                return candidate.str;
+            }
+            if (candidate.hash == hash && candidate.str.view() == str)
+            {
+                return candidate.str;
+            }
+        }
+    }
+
+    // invalidates all strings interned by this pool, but retains the memory
+    void clear() noexcept
+    {
+        mStorage.clear();
+        for (auto &s : mSlots)
+        {
+            s = slot{};
+        }
+        mInterned.clear();
+    }
+
+    // allows a stream carrying the pool to be rewound, see stateful_stream.
+    // The checkpoint is invalidated by clear().
+    struct checkpoint_type
+    {
+        std::size_t num_interned;
+        value_arena::checkpoint_type storage;
+    };
+    [[nodiscard]] auto checkpoint() const noexcept -> checkpoint_type
+    {
+        return {mInterned.size(), mStorage.checkpoint()};
+    }
+    // invalidates the strings which have been interned after the checkpoint
+    void rewind(checkpoint_type const &cp) noexcept
+    {
+        while (mInterned.size() > cp.num_interned)
+        {
+            erase(mInterned.back());
+            mInterned.pop_back();
+        }
+        mStorage.rewind(cp.storage);
+    }
+
+    // a scratch buffer for assembling a string before interning it. Its
+    // capacity is retained which avoids allocating while decoding.
+    [[nodiscard]] auto buffer() noexcept -> std::u8string &
+    {
+        return mBuffer;
+    }
+
+private:
+    auto grow() noexcept -> result<void>
+    {
+        auto const capacity = mSlots.empty() ? initial_capacity
+                                             : mSlots.size() * 2u;
+        std::vector<slot> slots;
+        try
+        {
+            slots.resize(capacity);
+            mInterned.reserve(capacity / 2u);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+
+        auto const mask = capacity - 1u;
+        for (auto const &s : mSlots)
+        {
+            if (s.str.data() == nullptr)
+            {
+                continue;
+            }
+            auto i = static_cast<std::size_t>(s.hash) & mask;
+            while (slots[i].str.data() != nullptr)
+            {
+                i = (i + 1u) & mask;
+            }
+            slots[i] = s;
+        }
+        mSlots = std::move(slots);
+        return oc::success();
+    }
+
+    // removes the slot of an interned string by shifting the subsequent
+    // members of its probe sequence backwards
+    void erase(slot const &interned) noexcept
+    {
+        auto const mask = mSlots.size() - 1u;
+        auto i = static_cast<std::size_t>(interned.hash) & mask;
+        while (mSlots[i].str.data() != interned.str.data())
+        {
+            i = (i + 1u) & mask;
+        }
+        for (auto j = (i + 1u) & mask; mSlots[j].str.data() != nullptr;
+             j = (j + 1u) & mask)
+        {
+            auto const home = static_cast<std::size_t>(mSlots[j].hash) & mask;
+            // the slot may only be moved if the hole lies within its probe
+            // sequence
+            if (((j - home) & mask) >= ((j - i) & mask))
+            {
+                mSlots[i] = mSlots[j];
+                i = j;
+            }
+        }
+        mSlots[i] = slot{};
+    }
+};
+
+} // namespace dplx::dp
+
+namespace std
+{
+
+template <>
+struct hash<dplx::dp::interned_u8string>
+{
+    auto operator()(dplx::dp::interned_u8string const &str) const noexcept
+            -> std::size_t
+    {
+        return static_cast<std::size_t>(
+                dplx::dp::detail::hash_interned(str.view()));
+    }
+};
+
+} // namespace std
@@ -161,6 +161,15 @@ public:
         }
     }
 
+    // emits the negative integer -1 - complement, i.e. the whole negative
+    // range of CBOR integers can be represented
+    static inline auto negint(Stream &outStream,
+                              std::uint64_t const complement) -> result<void>
+    {
+        return item_emitter::encode_type_info(outStream, complement,
+                                              to_byte(type_code::negint));
+    }
+
     template <typename T>
     static inline auto binary(Stream &outStream, T const byteSize)
             -> result<void>
@@ -9,6 +9,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include <ranges>
 #include <type_traits>
@@ -23,6 +24,8 @@
 #include <dplx/dp/detail/utils.hpp>
 #include <dplx/dp/disappointment.hpp>
 #include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
 #include <dplx/dp/type_code.hpp>
 
 namespace dplx::dp
@@ -374,13 +377,13 @@ public:
         if (rolled > 1u)
             DPLX_ATTR_UNLIKELY
             {
-                DPLX_TRY(consume(readProxy, 0));
+                DPLX_TRY(consume(inStream, readProxy, 0));
                 return errc::item_type_mismatch;
             }
 
         if constexpr (lazy_input_stream<Stream>)
         {
-            DPLX_TRY(consume(readProxy));
+            DPLX_TRY(consume(inStream, readProxy));
         }
 
         return static_cast<bool>(rolled);
@@ -456,6 +459,18 @@ private:
                                      parse_mode const mode,
                                      type_code const expectedType)
             -> result<std::size_t>;
+    template <typename StringType>
+    static inline auto stringref(Stream &inStream,
+                                 StringType &dest,
+                                 std::size_t const maxSize,
+                                 type_code const expectedType)
+            -> result<std::size_t>;
+    template <typename StringType>
+    static inline auto register_stringref(Stream &inStream,
+                                          StringType const &str,
+                                          std::size_t const size,
+                                          type_code const expectedType)
+            -> result<void>;
 
     template <typename T, typename DecodeElementFn>
     static inline auto array_like(Stream &inStream,
@@ -486,6 +501,13 @@ inline auto item_parser<Stream>::string(Stream &inStream,
 {
     DPLX_TRY(item_info item, parse::generic(inStream));
 
+    if constexpr (has_stream_state<Stream, stringref_dictionary>)
+    {
+        if (item.type == type_code::tag && item.value == stringref_tag)
+        {
+            return parse::stringref(inStream, dest, maxSize, expectedType);
+        }
+    }
     if (item.type != expectedType)
     {
         return errc::item_type_mismatch;
@@ -519,6 +541,9 @@ inline auto item_parser<Stream>::string(Stream &inStream,
 
             DPLX_TRY(read(inStream, reinterpret_cast<std::byte *>(memory),
                           size));
+            // indefinite length strings aren't assigned an index
+            DPLX_TRY(parse::register_stringref(inStream, dest, size,
+                                               expectedType));
         }
     else if (mode != parse_mode::lenient)
     {
@@ -587,6 +612,13 @@ inline auto item_parser<Stream>::string_finite(Stream &inStream,
 {
     DPLX_TRY(item_info item, parse::generic(inStream));
 
+    if constexpr (has_stream_state<Stream, stringref_dictionary>)
+    {
+        if (item.type == type_code::tag && item.value == stringref_tag)
+        {
+            return parse::stringref(inStream, dest, maxSize, expectedType);
+        }
+    }
     if (item.type != expectedType)
     {
         return errc::item_type_mismatch;
@@ -618,6 +650,7 @@ inline auto item_parser<Stream>::string_finite(Stream &inStream,
     auto const memory = std::ranges::data(dest);
 
     DPLX_TRY(read(inStream, reinterpret_cast<std::byte *>(memory), byteSize));
+    DPLX_TRY(parse::register_stringref(inStream, dest, byteSize, expectedType));
 
     // if (mode == parse_mode::strict && expectedType == type_code::text)
     //{
@@ -627,6 +660,56 @@ inline auto item_parser<Stream>::string_finite(Stream &inStream,
     return byteSize;
 }
 
+template <input_stream Stream>
+template <typename StringType>
+inline auto item_parser<Stream>::stringref(Stream &inStream,
+                                           StringType &dest,
+                                           std::size_t const maxSize,
+                                           type_code const expectedType)
+        -> result<std::size_t>
+{
+    DPLX_TRY(item_info const indexItem, parse::generic(inStream));
+    if (indexItem.type != type_code::posint)
+    {
+        return errc::item_type_mismatch;
+    }
+
+    auto const &dictionary = get_stream_state<stringref_dictionary>(inStream);
+    DPLX_TRY(auto const str, dictionary.find(indexItem.value,
+                                             expectedType == type_code::text));
+    if (str.size() > maxSize)
+    {
+        return errc::string_exceeds_size_limit;
+    }
+
+    DPLX_TRY(container_resize_for_overwrite(dest, str.size()));
+    std::memcpy(std::ranges::data(dest), str.data(), str.size());
+    return str.size();
+}
+
+template <input_stream Stream>
+template <typename StringType>
+inline auto
+item_parser<Stream>::register_stringref(Stream &inStream,
+                                        StringType const &str,
+                                        std::size_t const size,
+                                        type_code const expectedType)
+        -> result<void>
+{
+    if constexpr (has_stream_state<Stream, stringref_dictionary>)
+    {
+        auto &dictionary = get_stream_state<stringref_dictionary>(inStream);
+        return dictionary.add(
+                expectedType == type_code::text,
+                reinterpret_cast<std::byte const *>(std::ranges::data(str)),
+                size);
+    }
+    else
+    {
+        return oc::success();
+    }
+}
+
 template <input_stream Stream>
 template <typename T, typename DecodeElementFn>
 inline auto item_parser<Stream>::array_like(Stream &inStream,
@@ -0,0 +1,371 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/detail/capture_item.hpp>
+#include <dplx/dp/detail/map_key.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/skip_item.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// accumulates the encoded form of consecutive items which are copied to the
+// output with a single write. Items captured from streams other than memory
+// buffers are copied into a buffer which is flushed before the next item is
+// appended once it exceeds flush_threshold bytes.
+template <input_stream Stream>
+class raw_item_run
+{
+    static constexpr bool borrows = is_memory_buffer_v<Stream>;
+
+    std::byte const *mBegin = nullptr;
+    std::byte const *mEnd = nullptr;
+    std::vector<std::byte> mBuffer;
+
+public:
+    static constexpr std::size_t flush_threshold = 4096u;
+
+    // the number of bytes which have been appended but not yet flushed
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        if constexpr (borrows)
+        {
+            return static_cast<std::size_t>(mEnd - mBegin);
+        }
+        else
+        {
+            return mBuffer.size();
+        }
+    }
+
+    // captures the next item from the input and returns its encoded form
+    template <output_stream OutStream>
+    auto append_item(Stream &inStream, OutStream &outStream)
+            -> result<std::span<std::byte const>>
+    {
+        if constexpr (borrows)
+        {
+            DPLX_TRY(auto const item, detail::capture_item_view(inStream));
+            if (item.data() != mEnd)
+            {
+                DPLX_TRY(flush(outStream));
+                mBegin = item.data();
+            }
+            mEnd = item.data() + item.size();
+            return item;
+        }
+        else
+        {
+            // only the last item may be dropped, i.e. the preceding ones
+            // can be written out
+            if (mBuffer.size() >= flush_threshold)
+            {
+                DPLX_TRY(flush(outStream));
+            }
+            auto const offset = mBuffer.size();
+            DPLX_TRY(detail::capture_item(inStream, mBuffer));
+            return std::span<std::byte const>(mBuffer).subspan(offset);
+        }
+    }
+
+    // removes the trailing numBytes which must have been appended
+    // by the last append_item() call
+    void drop_last(std::size_t const numBytes) noexcept
+    {
+        if constexpr (borrows)
+        {
+            assert(numBytes <= static_cast<std::size_t>(mEnd - mBegin));
+            mEnd -= numBytes;
+        }
+        else
+        {
+            assert(numBytes <= mBuffer.size());
+            mBuffer.resize(mBuffer.size() - numBytes);
+        }
+    }
+
+    template <output_stream OutStream>
+    auto flush(OutStream &outStream) -> result<void>
+    {
+        if constexpr (borrows)
+        {
+            if (mBegin != mEnd)
+            {
+                DPLX_TRY(dp::write(outStream, mBegin,
+                                   static_cast<std::size_t>(mEnd - mBegin)));
+            }
+            mBegin = mEnd;
+        }
+        else
+        {
+            if (!mBuffer.empty())
+            {
+                DPLX_TRY(dp::write(outStream, mBuffer.data(), mBuffer.size()));
+            }
+            mBuffer.clear();
+        }
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// copies a CBOR item from an input stream to an output stream while applying
+// rules to the map entries selected by paths of text string keys, e.g. the
+// path {u8"headers", u8"ttl"} selects the ttl entry of the headers map
+// within the root map. Subtrees which aren't selected by any rule are copied
+// as raw byte ranges, values are never materialized.
+//
+// Dropping entries of a definite length map changes its size. With memory
+// buffer input the entries are counted upfront, otherwise the map is
+// re-emitted with indefinite length.
+template <input_stream InStream, output_stream OutStream>
+class item_rewriter
+{
+public:
+    // must consume exactly one item from the input stream and write exactly
+    // one item to the output stream
+    using replace_fn = std::function<result<void>(InStream &, OutStream &)>;
+
+private:
+    enum class rule_action
+    {
+        descend,
+        drop,
+        replace,
+    };
+
+    struct rule_node
+    {
+        std::u8string key;
+        rule_action action = rule_action::descend;
+        replace_fn replacement;
+        std::vector<rule_node> children;
+
+        [[nodiscard]] auto drops_children() const noexcept -> bool
+        {
+            return std::ranges::any_of(children, [](rule_node const &child) {
+                return child.action == rule_action::drop;
+            });
+        }
+    };
+
+    rule_node mRoot;
+
+public:
+    item_rewriter() = default;
+
+    // the path must not be empty
+    auto drop(std::initializer_list<std::u8string_view> const path)
+            -> item_rewriter &
+    {
+        auto &node = add_rule_node(path);
+        node.action = rule_action::drop;
+        return *this;
+    }
+    // the path must not be empty
+    auto replace(std::initializer_list<std::u8string_view> const path,
+                 replace_fn replacement) -> item_rewriter &
+    {
+        auto &node = add_rule_node(path);
+        node.action = rule_action::replace;
+        node.replacement = std::move(replacement);
+        return *this;
+    }
+
+    auto operator()(InStream &inStream, OutStream &outStream) const
+            -> result<void>
+    {
+        return rewrite(mRoot, inStream, outStream);
+    }
+
+private:
+    auto add_rule_node(std::initializer_list<std::u8string_view> const path)
+            -> rule_node &
+    {
+        assert(path.size() > 0u);
+
+        rule_node *node = &mRoot;
+        for (auto const key : path)
+        {
+            auto const it = std::ranges::find(node->children, key,
+                                              &rule_node::key);
+            if (it != node->children.end())
+            {
+                node = &*it;
+            }
+            else
+            {
+                node = &node->children.emplace_back(rule_node{
+                        std::u8string(key), rule_action::descend, {}, {}});
+            }
+        }
+        return *node;
+    }
+
+    static auto find_rule(rule_node const &node,
+                          std::span<std::byte const> const encodedKey) noexcept
+            -> rule_node const *
+    {
+        for (auto const &child : node.children)
+        {
+            if (detail::is_text_key(encodedKey, child.key))
+            {
+                return &child;
+            }
+        }
+        return nullptr;
+    }
+
+    auto rewrite(rule_node const &node,
+                 InStream &inStream,
+                 OutStream &outStream) const -> result<void>
+    {
+        if (!node.children.empty())
+        {
+            DPLX_TRY(auto const initialByte,
+                     detail::peek_initial_byte(inStream));
+            if ((initialByte & std::byte{0b111'00000})
+                == to_byte(type_code::map))
+            {
+                return rewrite_map(node, inStream, outStream);
+            }
+        }
+
+        detail::raw_item_run<InStream> run;
+        DPLX_TRY(run.append_item(inStream, outStream));
+        return run.flush(outStream);
+    }
+
+    auto rewrite_map(rule_node const &node,
+                     InStream &inStream,
+                     OutStream &outStream) const -> result<void>
+    {
+        using emit = item_emitter<OutStream>;
+
+        DPLX_TRY(item_info const head, detail::parse_item(inStream));
+        bool emitIndefinite = head.indefinite();
+        if (!emitIndefinite)
+        {
+            std::uint64_t numDropped = 0u;
+            if (node.drops_children())
+            {
+                if constexpr (detail::is_memory_buffer_v<InStream>)
+                {
+                    DPLX_TRY(numDropped,
+                             count_dropped(node, inStream, head.value));
+                }
+                else
+                {
+                    emitIndefinite = true;
+                }
+            }
+            if (!emitIndefinite)
+            {
+                DPLX_TRY(emit::map(outStream, head.value - numDropped));
+            }
+        }
+        if (emitIndefinite)
+        {
+            DPLX_TRY(emit::map_indefinite(outStream));
+        }
+
+        detail::raw_item_run<InStream> run;
+        for (std::uint64_t i = 0u; head.indefinite() || i < head.value; ++i)
+        {
+            if (head.indefinite())
+            {
+                DPLX_TRY(auto const initialByte,
+                         detail::peek_initial_byte(inStream));
+                if (initialByte == to_byte(type_code::special_break))
+                {
+                    DPLX_TRY(dp::skip_bytes(inStream, 1u));
+                    break;
+                }
+            }
+
+            DPLX_TRY(auto const encodedKey,
+                     run.append_item(inStream, outStream));
+            auto const *const rule = find_rule(node, encodedKey);
+            if (rule == nullptr)
+            {
+                DPLX_TRY(run.append_item(inStream, outStream));
+                continue;
+            }
+
+            switch (rule->action)
+            {
+            case rule_action::drop:
+                run.drop_last(encodedKey.size());
+                DPLX_TRY(dp::skip_item(inStream));
+                break;
+
+            case rule_action::replace:
+                DPLX_TRY(run.flush(outStream));
+                DPLX_TRY(rule->replacement(inStream, outStream));
+                break;
+
+            case rule_action::descend:
+                DPLX_TRY(run.flush(outStream));
+                DPLX_TRY(rewrite(*rule, inStream, outStream));
+                break;
+            }
+        }
+        DPLX_TRY(run.flush(outStream));
+
+        if (emitIndefinite)
+        {
+            DPLX_TRY(emit::break_(outStream));
+        }
+        return oc::success();
+    }
+
+    // scans the map entries of a copy of the input buffer
+    static auto count_dropped(rule_node const &node,
+                              InStream const &inStream,
+                              std::uint64_t const numEntries)
+            -> result<std::uint64_t>
+    {
+        InStream probe = inStream;
+        std::uint64_t numDropped = 0u;
+        for (std::uint64_t i = 0u; i < numEntries; ++i)
+        {
+            DPLX_TRY(auto const encodedKey, detail::capture_item_view(probe));
+            auto const *const rule = find_rule(node, encodedKey);
+            numDropped += rule != nullptr && rule->action == rule_action::drop;
+
+            DPLX_TRY(dp::skip_item(probe));
+        }
+        return numDropped;
+    }
+};
+
+} // namespace dplx::dp
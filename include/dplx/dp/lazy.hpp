@@ -0,0 +1,132 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+
+namespace dplx::dp
+{
+
+// defers the decoding of a (sub)item until it is first accessed. Decoding a
+// lazy<T> only captures the encoded item which is decoded by get(). An
+// untouched lazy<T> is encoded by splicing the captured bytes verbatim.
+//
+// A lazy<T> which neither holds an encoded item nor a value behaves like it
+// holds a value initialized T.
+template <typename T>
+class lazy
+{
+    std::vector<std::byte> mEncoded;
+    std::optional<T> mValue;
+
+public:
+    using value_type = T;
+
+    lazy() noexcept = default;
+
+    explicit lazy(value_type value)
+        : mEncoded()
+        , mValue(std::move(value))
+    {
+    }
+
+    [[nodiscard]] auto has_value() const noexcept -> bool
+    {
+        return mValue.has_value();
+    }
+    // the captured encoded item or an empty span if the value has been
+    // decoded or assigned
+    [[nodiscard]] auto encoded() const noexcept -> std::span<std::byte const>
+    {
+        return mEncoded;
+    }
+
+    // returns the value if it has been decoded or assigned, nullptr otherwise
+    [[nodiscard]] auto get_if() const noexcept -> value_type const *
+    {
+        return mValue.has_value() ? &*mValue : nullptr;
+    }
+
+    // decodes the captured item on first access, the returned pointer is
+    // never null and stays valid until the lazy<T> is modified.
+    auto get() -> result<value_type *>
+        requires decodable<value_type, memory_view>
+    {
+        if (!mValue.has_value())
+        {
+            DPLX_TRY(decode_encoded());
+        }
+        return &*mValue;
+    }
+
+    auto operator=(value_type value) -> lazy &
+    {
+        mValue = std::move(value);
+        mEncoded.clear();
+        return *this;
+    }
+
+    // replaces the content with the given encoded item, i.e. the item isn't
+    // validated.
+    auto assign_encoded(std::span<std::byte const> const encoded)
+            -> result<void>
+    {
+        try
+        {
+            mEncoded.assign(encoded.begin(), encoded.end());
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        mValue.reset();
+        return oc::success();
+    }
+    void assign_encoded(std::vector<std::byte> &&encoded) noexcept
+    {
+        mEncoded = std::move(encoded);
+        mValue.reset();
+    }
+
+private:
+    auto decode_encoded() -> result<void>
+    {
+        mValue.emplace();
+        if (mEncoded.empty())
+        {
+            return oc::success();
+        }
+
+        memory_view encodedView{std::span<std::byte const>(mEncoded)};
+        if (auto decodeRx = basic_decoder<value_type, memory_view>()(
+                    encodedView, *mValue);
+            decodeRx.has_failure())
+            DPLX_ATTR_UNLIKELY
+            {
+                mValue.reset();
+                return std::move(decodeRx).as_failure();
+            }
+
+        // the encoded form may diverge from the value from now on
+        std::vector<std::byte>().swap(mEncoded);
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
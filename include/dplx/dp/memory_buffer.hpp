@@ -141,7 +141,9 @@ public:
     inline void move_consumer_to(difference_type const absoluteOffset) noexcept
     {
         auto const newSize = mAllocationSize - absoluteOffset;
-        mWindowBegin += mWindowSize - newSize;
+        // the offset may lie before the current position
+        mWindowBegin += static_cast<difference_type>(mWindowSize)
+                      - static_cast<difference_type>(newSize);
         mWindowSize = newSize;
     }
 };
@@ -159,17 +161,18 @@ public:
 
 private:
     std::span<std::byte> mBuffer{};
+    std::size_t mAllocationSize{};
     /*[[no_unique_address]]*/ allocator_type mAllocator{};
 
 public:
-    using size_type = unsigned;
+    using size_type = std::size_t;
 
     ~memory_allocation() noexcept
     {
         if (mBuffer.data() != nullptr)
         {
             allocator_traits::deallocate(mAllocator, mBuffer.data(),
-                                         mBuffer.size());
+                                         mAllocationSize);
         }
     }
 
@@ -180,12 +183,14 @@ public:
 
     explicit memory_allocation(memory_allocation &&other) noexcept
         : mBuffer(std::exchange(other.mBuffer, {}))
+        , mAllocationSize(std::exchange(other.mAllocationSize, 0u))
         , mAllocator(std::move(other.mAllocator))
     {
     }
     auto operator=(memory_allocation &&other) noexcept -> memory_allocation &
     {
         mBuffer = std::exchange(other.mBuffer, {});
+        mAllocationSize = std::exchange(other.mAllocationSize, 0u);
         if constexpr (allocator_traits::propagate_on_container_move_assignment::
                               value)
         {
@@ -205,6 +210,7 @@ public:
                             memory_allocation &rhs) noexcept
     {
         std::ranges::swap(lhs.mBuffer, rhs.mBuffer);
+        std::ranges::swap(lhs.mAllocationSize, rhs.mAllocationSize);
         std::ranges::swap(lhs.mAllocator, rhs.mAllocator);
     }
 
@@ -236,7 +242,7 @@ public:
         if (mBuffer.data() != nullptr)
         {
             allocator_traits::deallocate(mAllocator, mBuffer.data(),
-                                         mBuffer.size());
+                                         mAllocationSize);
 
             mBuffer = std::span<std::byte>();
         }
@@ -247,22 +253,33 @@ public:
     {
         if (newSize <= mBuffer.size())
         {
-            return errc::bad; // TODO: appropriate error code for invalid
-                              // parameter values
+            return errc::invalid_argument;
         }
 
-        auto const *const oldMemory = mBuffer.data();
+        auto *const oldMemory = mBuffer.data();
         auto const oldSize = mBuffer.size();
+        auto const oldAllocationSize = mAllocationSize;
 
         auto allocRx = allocate(newSize);
         if (allocRx)
         {
             std::memcpy(mBuffer.data(), oldMemory, oldSize);
 
-            allocator_traits::deallocate(mAllocator, oldMemory, oldSize);
+            allocator_traits::deallocate(mAllocator, oldMemory,
+                                         oldAllocationSize);
         }
         return allocRx;
     }
+    // shrinks the usable size without reallocating
+    inline auto truncate(size_type const newSize) noexcept -> result<void>
+    {
+        if (newSize > mBuffer.size())
+        {
+            return errc::invalid_argument;
+        }
+        mBuffer = mBuffer.first(newSize);
+        return dp::success();
+    }
 
 private:
     inline auto allocate(size_type const bufferSize) noexcept -> result<void>
@@ -273,6 +290,7 @@ private:
                     = allocator_traits::allocate(mAllocator, bufferSize);
 
             mBuffer = std::span<std::byte>(memory, bufferSize);
+            mAllocationSize = bufferSize;
             return dp::success();
         }
         catch (std::bad_alloc const &)
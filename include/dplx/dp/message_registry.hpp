@@ -0,0 +1,127 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+#include <boost/mp11/list.hpp>
+
+#include <dplx/dp/detail/item_size.hpp>
+#include <dplx/dp/detail/pre_encoded.hpp>
+#include <dplx/dp/type_code.hpp>
+
+// polymorphic messages are encoded as an envelope [type_id, payload] where
+// the type id is a compile time constant declared by each message type:
+//
+//     struct heartbeat
+//     {
+//         static constexpr std::uint64_t message_id = 7;
+//         ...
+//     };
+//
+// A message_registry lists the message types which can be decoded from an
+// envelope, see encode_message and decode_message.
+
+namespace dplx::dp
+{
+
+// clang-format off
+template <typename T>
+concept message_type
+    = requires
+    {
+        typename std::integral_constant<std::uint64_t, T::message_id>;
+    };
+// clang-format on
+
+template <message_type... Ts>
+class message_registry
+{
+    struct id_position
+    {
+        std::uint64_t id;
+        std::size_t type_index;
+    };
+
+    static constexpr auto sorted_ids() noexcept
+            -> std::array<id_position, sizeof...(Ts)>
+    {
+        std::array<id_position, sizeof...(Ts)> sorted{
+                id_position{Ts::message_id, 0u}...};
+        for (std::size_t i = 0; i < sorted.size(); ++i)
+        {
+            sorted[i].type_index = i;
+        }
+        std::sort(sorted.begin(), sorted.end(),
+                  [](id_position const &lhs, id_position const &rhs) {
+                      return lhs.id < rhs.id;
+                  });
+        return sorted;
+    }
+    static constexpr auto sorted = sorted_ids();
+
+    static constexpr auto collect_ids() noexcept
+            -> std::array<std::uint64_t, sizeof...(Ts)>
+    {
+        std::array<std::uint64_t, sizeof...(Ts)> ids{};
+        for (std::size_t i = 0; i < ids.size(); ++i)
+        {
+            ids[i] = sorted[i].id;
+        }
+        return ids;
+    }
+    static constexpr auto collect_type_indices() noexcept
+            -> std::array<std::size_t, sizeof...(Ts)>
+    {
+        std::array<std::size_t, sizeof...(Ts)> typeIndices{};
+        for (std::size_t i = 0; i < typeIndices.size(); ++i)
+        {
+            typeIndices[i] = sorted[i].type_index;
+        }
+        return typeIndices;
+    }
+
+public:
+    using types = boost::mp11::mp_list<Ts...>;
+
+    static constexpr std::size_t num_messages = sizeof...(Ts);
+
+    // the message ids in ascending order
+    static constexpr std::array<std::uint64_t, num_messages> ids
+            = collect_ids();
+    // the position within Ts of the message type with the id ids[i]
+    static constexpr std::array<std::size_t, num_messages> type_indices
+            = collect_type_indices();
+
+    static_assert(num_messages > 0u);
+    static_assert(std::adjacent_find(ids.begin(), ids.end()) == ids.end(),
+                  "message ids must be unique within a registry");
+};
+
+} // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+// the array head of the envelope followed by the type id
+template <message_type T>
+inline constexpr auto encoded_message_prefix = []() {
+    std::array<std::byte,
+               1u + detail::var_uint_encoded_size_branching(T::message_id)>
+            encoded{};
+    encoded[0] = to_byte(type_code::array) | std::byte{2};
+    detail::store_var_uint_static(encoded.data() + 1, T::message_id,
+                                  to_byte(type_code::posint));
+    return encoded;
+}();
+
+} // namespace dplx::dp::detail
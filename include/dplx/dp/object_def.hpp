@@ -250,6 +250,15 @@ using named_property_def
 
 #endif
 
+// a named property which can also be keyed by a compact integer alias.
+// Objects are encoded with the aliases if object_def::use_property_aliases
+// is set, but both forms are accepted by the decoder.
+template <fixed_u8string Id, std::uint32_t Alias, auto M, auto... Ms>
+struct aliased_property_def : named_property_def<Id, M, Ms...>
+{
+    static constexpr std::uint32_t alias = Alias;
+};
+
 template <auto Id,
           typename AccessorType,
           typename IdRuntimeType = detail::remove_cref_t<decltype(Id)>>
@@ -304,6 +313,85 @@ using named_property_fun
 
 #endif
 
+// the wire format of an object_def
+enum class object_encoding : unsigned char
+{
+    // a map with a key/value pair for every property
+    map,
+    // a map which omits optional properties holding a default value
+    sparse_map,
+    // an array of presence bitmap words followed by the values of the present
+    // properties in declaration order. Bit i of the bitmap (LSB first, 64 bits
+    // per word) denotes the presence of the i-th property. Optional
+    // properties holding a default value are omitted.
+    presence_bitmap,
+};
+
+} // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+// clang-format off
+template <typename PropDefType>
+concept aliased_property
+    = requires
+    {
+        { PropDefType::alias } -> std::convertible_to<std::uint32_t>;
+    };
+// clang-format on
+
+template <typename T, std::size_t N>
+constexpr auto has_duplicates(std::array<T, N> const &values) noexcept -> bool
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = i + 1; j < N; ++j)
+        {
+            if (values[i] == values[j])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// the number of posint keys a property may be decoded from, i.e. its integer
+// id and/or its alias
+template <typename PropDefType>
+inline constexpr std::size_t num_integer_keys
+        = static_cast<std::size_t>(
+                  std::integral<typename PropDefType::id_type>)
+        + static_cast<std::size_t>(aliased_property<PropDefType>);
+
+template <auto... Properties>
+constexpr auto collect_integer_keys() noexcept
+{
+    constexpr std::size_t numKeys
+            = (0u + ...
+               + num_integer_keys<remove_cref_t<decltype(Properties)>>);
+    std::array<std::uint32_t, numKeys> keys{};
+    std::size_t pos = 0;
+    auto collect = [&]<typename PropDefType>(PropDefType const &) {
+        if constexpr (std::integral<typename PropDefType::id_type>)
+        {
+            keys[pos++] = static_cast<std::uint32_t>(PropDefType::id);
+        }
+        if constexpr (aliased_property<PropDefType>)
+        {
+            keys[pos++] = PropDefType::alias;
+        }
+    };
+    (..., collect(Properties));
+    return keys;
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
 template <auto... Properties>
 struct object_def
 {
@@ -318,9 +406,23 @@ struct object_def
     static constexpr bool has_optional_properties
             = !(... && Properties.required);
     static constexpr std::array<id_type, num_properties> ids{Properties.id...};
+    // the posint keys of the properties, i.e. integer ids and aliases
+    static constexpr auto integer_keys
+            = detail::collect_integer_keys<Properties...>();
+    // posint 0 is reserved for the version property of versioned objects
+    static constexpr bool claims_version_key
+            = std::find(integer_keys.begin(), integer_keys.end(), 0u)
+           != integer_keys.end();
+
+    static_assert(!detail::has_duplicates(ids), "property ids must be unique");
+    static_assert(!detail::has_duplicates(integer_keys),
+                  "property ids and aliases must not collide");
 
     std::uint32_t version = 0xffff'ffff;
     bool allow_versioned_auto_decoder = false;
+    object_encoding encoding = object_encoding::map;
+    // whether aliased properties are keyed by their integer alias
+    bool use_property_aliases = false;
 
     template <std::size_t N>
     static constexpr decltype(auto) property() noexcept
@@ -347,6 +449,12 @@ struct object_def
     {
         return (... + static_cast<MapFn &&>(map)(Properties));
     }
+    // invokes fn for each property in declaration order
+    template <typename Fn>
+    static constexpr void mp_for_each(Fn &&fn)
+    {
+        (..., static_cast<Fn &&>(fn)(Properties));
+    }
 
     friend inline constexpr auto operator==(object_def const &,
                                             object_def const &) noexcept -> bool
@@ -369,3 +477,33 @@ template <typename T>
 concept is_object_def_v = is_object_def<T>::value;
 
 } // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+inline constexpr std::size_t presence_word_bits = 64u;
+
+template <auto const &descriptor>
+inline constexpr std::size_t presence_bitmap_size
+        = detail::div_ceil(descriptor.num_properties, presence_word_bits);
+
+// optional properties are omitted from the sparse encodings if they compare
+// equal to a value initialized instance, e.g. an empty std::optional
+template <typename PropDefType, typename T>
+constexpr auto is_omitted_property(PropDefType const &propertyDef,
+                                   T const &value) -> bool
+{
+    using value_type = typename PropDefType::value_type;
+    if constexpr (std::equality_comparable<
+                          value_type> && std::default_initializable<value_type>)
+    {
+        return !propertyDef.required
+            && PropDefType::access(value) == value_type{};
+    }
+    else
+    {
+        return false;
+    }
+}
+
+} // namespace dplx::dp::detail
@@ -0,0 +1,49 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <dplx/dp/detail/item_size.hpp>
+
+namespace dplx::dp
+{
+
+// std::vector<bool>, std::bitset and boost::dynamic_bitset are encoded as a
+// tagged byte string:
+//     tag(bstr(number of padding bits, packed bits...))
+// Bit i is stored in byte i / 8 at position i % 8 (LSB first) and the
+// padding bits of the last byte are zero. The tag number lies in the first
+// come first served range, but hasn't been registered with IANA.
+// The boost::dynamic_bitset codecs are only defined if its header is
+// available.
+inline constexpr std::uint64_t packed_bits_tag = 0x6470'0004u;
+
+namespace detail
+{
+
+// the number of packed bits per word
+inline constexpr std::size_t packed_bits_word_size = 64u;
+
+constexpr auto packed_bits_payload_size(std::uint64_t const numBits) noexcept
+        -> std::uint64_t
+{
+    return 1u + (numBits + 7u) / 8u;
+}
+
+constexpr auto packed_bits_encoded_size(std::uint64_t const numBits) noexcept
+        -> std::uint64_t
+{
+    auto const payloadSize = detail::packed_bits_payload_size(numBits);
+    return detail::var_uint_encoded_size(packed_bits_tag)
+         + detail::var_uint_encoded_size(payloadSize) + payloadSize;
+}
+
+} // namespace detail
+
+} // namespace dplx::dp
@@ -0,0 +1,223 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <span>
+#include <type_traits>
+
+#include <dplx/dp/detail/map_key.hpp>
+#include <dplx/dp/detail/parse_item.hpp>
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/detail/utils.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/patchable.hpp>
+#include <dplx/dp/skip_item.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp::detail
+{
+
+// returns the offset of the value item which belongs to the given key of the
+// map at the beginning of the encoded buffer
+template <typename Id>
+inline auto find_property_value(std::span<std::byte const> const encoded,
+                                Id const &id) -> result<std::size_t>
+{
+    memory_view mapStream{encoded};
+    DPLX_TRY(dp::item_info const head, detail::parse_item(mapStream));
+    if (head.type != type_code::map)
+        DPLX_ATTR_UNLIKELY
+        {
+            return errc::item_type_mismatch;
+        }
+
+    for (std::uint64_t i = 0u; head.indefinite() || i < head.value; ++i)
+    {
+        if (head.indefinite())
+        {
+            if (mapStream.remaining_size() == 0u)
+                DPLX_ATTR_UNLIKELY
+                {
+                    return errc::end_of_stream;
+                }
+            if (*mapStream.remaining_begin()
+                == to_byte(type_code::special_break))
+            {
+                break;
+            }
+        }
+
+        std::byte const *const keyBegin = mapStream.remaining_begin();
+        DPLX_TRY(dp::skip_item(mapStream));
+        if (detail::is_map_key(std::span<std::byte const>(
+                                       keyBegin, mapStream.remaining_begin()),
+                               id))
+        {
+            if (mapStream.remaining_size() == 0u)
+                DPLX_ATTR_UNLIKELY
+                {
+                    return errc::end_of_stream;
+                }
+            return static_cast<std::size_t>(mapStream.remaining_begin()
+                                            - encoded.data());
+        }
+        DPLX_TRY(dp::skip_item(mapStream));
+    }
+    return errc::required_object_property_missing;
+}
+
+template <integer T>
+inline auto patch_integer_item(std::span<std::byte> const item, T const value)
+        -> result<void>
+{
+    auto const category = item[0] & std::byte{0b111'00000};
+    auto const info = static_cast<unsigned>(item[0] & std::byte{0b000'11111});
+    if ((category != to_byte(type_code::posint)
+         && category != to_byte(type_code::negint))
+        || info < 24u || info > 27u)
+        DPLX_ATTR_UNLIKELY
+        {
+            // the value is stored within the head byte or the item isn't an
+            // integer, i.e. there is no room for an arbitrary value
+            return errc::item_type_mismatch;
+        }
+    std::size_t const width = std::size_t{1} << (info - 24u);
+    if (item.size() < 1u + width)
+        DPLX_ATTR_UNLIKELY
+        {
+            return errc::end_of_stream;
+        }
+
+    using uvalue_type = std::make_unsigned_t<T>;
+    auto uvalue = static_cast<std::uint64_t>(static_cast<uvalue_type>(value));
+    std::byte newCategory = to_byte(type_code::posint);
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (value < 0)
+        {
+            // complement negatives
+            uvalue = static_cast<std::uint64_t>(
+                    static_cast<uvalue_type>(~static_cast<uvalue_type>(value)));
+            newCategory = to_byte(type_code::negint);
+        }
+    }
+    if (width < sizeof(std::uint64_t) && (uvalue >> (width * 8u)) != 0u)
+        DPLX_ATTR_UNLIKELY
+        {
+            return errc::item_value_out_of_range;
+        }
+
+    item[0] = newCategory | (item[0] & std::byte{0b000'11111});
+    switch (width)
+    {
+    case 1u:
+        detail::store(&item[1], static_cast<std::uint8_t>(uvalue));
+        break;
+    case 2u:
+        detail::store(&item[1], static_cast<std::uint16_t>(uvalue));
+        break;
+    case 4u:
+        detail::store(&item[1], static_cast<std::uint32_t>(uvalue));
+        break;
+    default:
+        detail::store(&item[1], uvalue);
+        break;
+    }
+    return oc::success();
+}
+
+template <iec559_floating_point T>
+inline auto patch_float_item(std::span<std::byte> const item, T const value)
+        -> result<void>
+{
+    if (item[0] == to_byte(type_code::float_double))
+    {
+        if (item.size() < 1u + sizeof(double))
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::end_of_stream;
+            }
+        detail::store(&item[1], static_cast<double>(value));
+        return oc::success();
+    }
+    if (item[0] == to_byte(type_code::float_single))
+    {
+        auto const narrowed = static_cast<float>(value);
+        // NaNs don't compare equal but can be narrowed without loss
+        if (narrowed != value && !std::isnan(value))
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_value_out_of_range;
+            }
+        if (item.size() < 1u + sizeof(float))
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::end_of_stream;
+            }
+        detail::store(&item[1], narrowed);
+        return oc::success();
+    }
+    return errc::item_type_mismatch;
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// overwrites the value of a property within an encoded map in place, i.e.
+// the property value must have been encoded with a fixed width item like the
+// ones emitted for patchable<T>. The new value is stored with the width of the
+// existing item if it fits.
+//
+// The id is either a text (e.g. a u8 string literal or fixed_u8string) or an
+// integer. Only the entries of the outermost map are considered.
+//
+// Fails with required_object_property_missing if no entry has the given id,
+// with item_type_mismatch if the current value isn't a fixed width number of
+// the same kind and with item_value_out_of_range if the value doesn't fit.
+template <typename Id, typename T>
+    requires integer<T> || iec559_floating_point<T>
+inline auto patch_property(std::span<std::byte> const encoded,
+                           Id const &id,
+                           T const value) -> result<void>
+{
+    DPLX_TRY(std::size_t const offset,
+             detail::find_property_value(std::span<std::byte const>(encoded),
+                                         id));
+
+    auto const item = encoded.subspan(offset);
+    if constexpr (integer<T>)
+    {
+        return detail::patch_integer_item(item, value);
+    }
+    else
+    {
+        return detail::patch_float_item(item, value);
+    }
+}
+
+// the encoded map must start at the beginning of the buffer, e.g. it has been
+// encoded into the buffer or the buffer has been created over the encoded map.
+template <typename Id, typename T>
+    requires integer<T> || iec559_floating_point<T>
+inline auto patch_property(memory_buffer const &buffer,
+                           Id const &id,
+                           T const value) -> result<void>
+{
+    return dp::patch_property(
+            std::span<std::byte>(buffer.consumed_begin(), buffer.buffer_size()),
+            id, value);
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,73 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+#include <bit>
+#include <type_traits>
+
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/detail/utils.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp
+{
+
+// wraps a number which is always encoded with the full width of its type,
+// e.g. a patchable<std::uint32_t> is encoded as 0x1a followed by 4 bytes
+// regardless of its value. Therefore it can be overwritten within an encoded
+// buffer without moving the subsequent bytes, see patch_property().
+//
+// The decoder accepts any encoding of the value.
+template <typename T>
+    requires integer<T> || iec559_floating_point<T>
+struct patchable final
+{
+    using value_type = T;
+
+    value_type value;
+
+    bool operator==(patchable const &) const = default;
+};
+
+template <typename T>
+patchable(T) -> patchable<T>;
+
+} // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+// the additional information of a head with sizeof(T) argument bytes
+template <integer T>
+inline constexpr std::byte fixed_width_info{
+        static_cast<unsigned char>(24 + std::countr_zero(sizeof(T)))};
+
+// writes the 1 + sizeof(T) bytes of a fixed width integer item
+template <integer T>
+inline void store_fixed_width_integer(std::byte *dest, T const value)
+{
+    using uvalue_type = std::make_unsigned_t<T>;
+
+    auto uvalue = static_cast<uvalue_type>(value);
+    std::byte category = to_byte(type_code::posint);
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (value < 0)
+        {
+            // complement negatives
+            uvalue = static_cast<uvalue_type>(~uvalue);
+            category = to_byte(type_code::negint);
+        }
+    }
+
+    dest[0] = category | fixed_width_info<T>;
+    detail::store(dest + 1, uvalue);
+}
+
+} // namespace dplx::dp::detail
@@ -0,0 +1,97 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+#include <algorithm>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace dplx::dp
+{
+
+// a complete encoded CBOR data item which is passed through verbatim, i.e.
+// decoding captures the bytes of exactly one item and encoding writes them
+// back unchanged. The content isn't validated on construction.
+class raw_item
+{
+    std::vector<std::byte> mEncoded;
+
+public:
+    raw_item() noexcept = default;
+
+    explicit raw_item(std::vector<std::byte> encoded) noexcept
+        : mEncoded(std::move(encoded))
+    {
+    }
+
+    [[nodiscard]] auto encoded() const noexcept -> std::span<std::byte const>
+    {
+        return mEncoded;
+    }
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mEncoded.size();
+    }
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return mEncoded.empty();
+    }
+
+    // exposes the underlying storage e.g. in order to reuse its capacity
+    [[nodiscard]] auto storage() noexcept -> std::vector<std::byte> &
+    {
+        return mEncoded;
+    }
+
+    friend inline auto operator==(raw_item const &lhs,
+                                  raw_item const &rhs) noexcept -> bool
+            = default;
+};
+
+// like raw_item, but borrows the encoded item from the input buffer and
+// therefore must not outlive it. It can only be decoded from memory buffers.
+class raw_item_view
+{
+    std::span<std::byte const> mEncoded;
+
+public:
+    raw_item_view() noexcept = default;
+
+    explicit raw_item_view(std::span<std::byte const> const encoded) noexcept
+        : mEncoded(encoded)
+    {
+    }
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    raw_item_view(raw_item const &item) noexcept
+        : mEncoded(item.encoded())
+    {
+    }
+
+    [[nodiscard]] auto encoded() const noexcept -> std::span<std::byte const>
+    {
+        return mEncoded;
+    }
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mEncoded.size();
+    }
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return mEncoded.empty();
+    }
+
+    friend inline auto operator==(raw_item_view const &lhs,
+                                  raw_item_view const &rhs) noexcept -> bool
+    {
+        return std::ranges::equal(lhs.mEncoded, rhs.mEncoded);
+    }
+};
+
+} // namespace dplx::dp
@@ -293,6 +293,33 @@ inline constexpr struct available_input_size_fn
     }
 } available_input_size{};
 
+// captures the read position of an input stream which can be restored with
+// rewind() as long as the stream retains the data behind the position, i.e.
+// decoding can be attempted speculatively.
+inline constexpr struct checkpoint_fn
+{
+    template <typename Stream>
+        requires tag_invocable<checkpoint_fn, Stream &>
+    auto operator()(Stream &stream) const
+            noexcept(nothrow_tag_invocable<checkpoint_fn, Stream &>)
+                    -> tag_invoke_result_t<checkpoint_fn, Stream &>
+    {
+        return cpo::tag_invoke(*this, stream);
+    }
+} checkpoint{};
+
+inline constexpr struct rewind_fn
+{
+    template <typename Stream, typename Checkpoint>
+        requires tag_invocable<rewind_fn, Stream &, Checkpoint const &>
+    auto operator()(Stream &stream, Checkpoint const &cp) const noexcept(
+            nothrow_tag_invocable<rewind_fn, Stream &, Checkpoint const &>)
+            -> tag_invoke_result_t<rewind_fn, Stream &, Checkpoint const &>
+    {
+        return cpo::tag_invoke(*this, stream, cp);
+    }
+} rewind{};
+
 namespace detail
 {
 
@@ -371,6 +398,26 @@ concept lazy_input_stream
     };
 // clang-format on
 
+// clang-format off
+template <typename Stream>
+concept rewindable_input_stream
+    = input_stream<Stream>
+    && requires (Stream &stream)
+    {
+        { checkpoint(stream) } -> detail::tryable;
+    }
+    && requires (Stream &stream,
+                 detail::result_value_t<
+                    tag_invoke_result_t<checkpoint_fn, Stream &>> const &cp)
+    {
+        { rewind(stream, cp) } -> detail::tryable;
+    };
+// clang-format on
+
+template <rewindable_input_stream Stream>
+using checkpoint_t = detail::result_value_t<decltype(checkpoint(
+        std::declval<Stream &>()))>;
+
 } // namespace dplx::dp
 
 namespace dplx::dp::detail
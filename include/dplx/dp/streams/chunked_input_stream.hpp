@@ -23,6 +23,7 @@ class chunked_input_stream_base
 {
     memory_view mReadArea;
     std::uint64_t mRemaining;
+    std::uint64_t mChunkIndex;
 
     static constexpr unsigned int small_buffer_size
             = 2 * (minimum_guaranteed_read_size - 1);
@@ -37,6 +38,7 @@ protected:
             std::uint64_t streamSize)
         : mReadArea(initialReadArea)
         , mRemaining(streamSize)
+        , mChunkIndex(0)
         , mBufferStart(-1)
     {
     }
@@ -87,6 +89,8 @@ private:
 
     inline auto acquire_next_chunk() noexcept -> result<void>
     {
+        // invalidates the checkpoints into the previous chunk
+        mChunkIndex += 1;
         DPLX_TRY(this->mReadArea, impl()->acquire_next_chunk_impl(mRemaining));
         return success();
     }
@@ -279,6 +283,38 @@ private:
     }
 
 public:
+    // a checkpoint can only be rewound to as long as no further chunk has
+    // been acquired, because the impl is free to release previous chunks
+    struct read_checkpoint
+    {
+        memory_view read_area;
+        std::uint64_t remaining;
+        std::uint64_t chunk_index;
+        std::int8_t buffer_start;
+    };
+
+    friend inline auto tag_invoke(tag_t<dp::checkpoint>,
+                                  chunked_input_stream_base &self) noexcept
+            -> result<read_checkpoint>
+    {
+        return read_checkpoint{self.mReadArea, self.mRemaining,
+                               self.mChunkIndex, self.mBufferStart};
+    }
+    friend inline auto tag_invoke(tag_t<dp::rewind>,
+                                  chunked_input_stream_base &self,
+                                  read_checkpoint const &cp) noexcept
+            -> result<void>
+    {
+        if (cp.chunk_index != self.mChunkIndex)
+        {
+            return dp::errc::checkpoint_expired;
+        }
+        self.mReadArea = cp.read_area;
+        self.mRemaining = cp.remaining;
+        self.mBufferStart = cp.buffer_start;
+        return oc::success();
+    }
+
     friend inline auto tag_invoke(tag_t<dp::available_input_size>,
                                   chunked_input_stream_base &self) noexcept
             -> result<std::uint64_t>
@@ -83,4 +83,29 @@ inline auto tag_invoke(tag_t<dp::skip_bytes>,
     return oc::success();
 }
 
+// the checkpoint is the consumed size, i.e. it stays valid across copies of
+// the buffer
+template <typename T>
+    requires std::is_same_v<std::byte, std::remove_const_t<T>>
+inline auto tag_invoke(tag_t<dp::checkpoint>,
+                       basic_memory_buffer<T> &self) noexcept
+        -> dplx::dp::result<typename basic_memory_buffer<T>::size_type>
+{
+    return self.consumed_size();
+}
+template <typename T>
+    requires std::is_same_v<std::byte, std::remove_const_t<T>>
+inline auto tag_invoke(tag_t<dp::rewind>,
+                       basic_memory_buffer<T> &self,
+                       typename basic_memory_buffer<T>::size_type const cp)
+        noexcept -> dplx::dp::result<void>
+{
+    if (cp > self.consumed_size())
+    {
+        return errc::bad;
+    }
+    self.move_consumer_to(static_cast<int>(cp));
+    return oc::success();
+}
+
 } // namespace dplx::dp
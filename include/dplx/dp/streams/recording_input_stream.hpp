@@ -0,0 +1,165 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <new>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp::detail
+{
+
+// declared outside of recording_input_stream in order to keep its friend
+// functions out of the overload sets looked up for the checkpoint
+template <typename BaseCheckpoint>
+struct recording_checkpoint
+{
+    BaseCheckpoint base;
+    std::size_t recorded_size;
+};
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// an input stream adapter which appends every byte consumed from the wrapped
+// stream to a byte vector, e.g. in order to capture the encoded form of an
+// item while skipping it.
+template <input_stream Stream>
+class recording_input_stream
+{
+    Stream *mStream;
+    std::vector<std::byte> *mRecording;
+
+public:
+    explicit recording_input_stream(Stream &stream,
+                                    std::vector<std::byte> &recording) noexcept
+        : mStream(&stream)
+        , mRecording(&recording)
+    {
+    }
+
+    [[nodiscard]] auto base() const noexcept -> Stream &
+    {
+        return *mStream;
+    }
+
+private:
+    auto record(std::byte const *data, std::size_t const size) -> result<void>
+    {
+        try
+        {
+            mRecording->insert(mRecording->end(), data, data + size);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        return oc::success();
+    }
+
+public:
+    friend inline auto tag_invoke(available_input_size_fn,
+                                  recording_input_stream &self)
+            -> decltype(dp::available_input_size(std::declval<Stream &>()))
+    {
+        return dp::available_input_size(*self.mStream);
+    }
+    friend inline auto tag_invoke(read_fn,
+                                  recording_input_stream &self,
+                                  std::size_t const size)
+            -> decltype(dp::read(std::declval<Stream &>(), size))
+    {
+        return dp::read(*self.mStream, size);
+    }
+    template <typename ReadProxy>
+    friend inline auto tag_invoke(consume_fn,
+                                  recording_input_stream &self,
+                                  ReadProxy &proxy,
+                                  std::size_t const actualAmount)
+            -> result<void>
+    {
+        DPLX_TRY(self.record(std::ranges::data(proxy), actualAmount));
+        return dp::consume(*self.mStream, proxy, actualAmount);
+    }
+    template <typename ReadProxy>
+        requires tag_invocable<consume_fn, Stream &, ReadProxy &>
+    friend inline auto tag_invoke(consume_fn,
+                                  recording_input_stream &self,
+                                  ReadProxy &proxy) -> result<void>
+    {
+        DPLX_TRY(self.record(std::ranges::data(proxy),
+                             std::ranges::size(proxy)));
+        return dp::consume(*self.mStream, proxy);
+    }
+    friend inline auto tag_invoke(read_fn,
+                                  recording_input_stream &self,
+                                  std::byte *buffer,
+                                  std::size_t const size) -> result<void>
+    {
+        DPLX_TRY(dp::read(*self.mStream, buffer, size));
+        return self.record(buffer, size);
+    }
+    // the skipped bytes need to be recorded, too, therefore they are read
+    // directly into the recording.
+    friend inline auto tag_invoke(skip_bytes_fn,
+                                  recording_input_stream &self,
+                                  std::uint64_t const numBytes)
+            -> result<void>
+    {
+        DPLX_TRY(std::size_t const remaining,
+                 dp::available_input_size(*self.mStream));
+        if (numBytes > remaining)
+        {
+            return errc::end_of_stream;
+        }
+
+        auto const size = static_cast<std::size_t>(numBytes);
+        auto const offset = self.mRecording->size();
+        try
+        {
+            self.mRecording->resize(offset + size);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        return dp::read(*self.mStream, self.mRecording->data() + offset, size);
+    }
+
+    // rewinding drops the bytes recorded after the checkpoint
+    template <rewindable_input_stream S = Stream>
+    friend inline auto tag_invoke(checkpoint_fn, recording_input_stream &self)
+            -> result<detail::recording_checkpoint<checkpoint_t<S>>>
+    {
+        DPLX_TRY(checkpoint_t<S> base, dp::checkpoint(*self.mStream));
+        return detail::recording_checkpoint<checkpoint_t<S>>{
+                std::move(base), self.mRecording->size()};
+    }
+    template <rewindable_input_stream S = Stream>
+    friend inline auto
+    tag_invoke(rewind_fn,
+               recording_input_stream &self,
+               detail::recording_checkpoint<checkpoint_t<S>> const &cp)
+            -> result<void>
+    {
+        DPLX_TRY(dp::rewind(*self.mStream, cp.base));
+        self.mRecording->resize(cp.recorded_size);
+        return oc::success();
+    }
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,277 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/stream.hpp>
+
+namespace dplx::dp
+{
+
+// a state which can be rolled back to a previously captured checkpoint
+// clang-format off
+template <typename State>
+concept rewindable_stream_state
+    = requires(State &state,
+               typename State::checkpoint_type const &cp)
+    {
+        { state.checkpoint() } noexcept
+            -> std::same_as<typename State::checkpoint_type>;
+        { state.rewind(cp) } noexcept;
+    };
+// clang-format on
+
+namespace detail
+{
+
+template <typename StreamCheckpoint, typename StateCheckpoint>
+struct stateful_checkpoint
+{
+    StreamCheckpoint stream;
+    StateCheckpoint state;
+};
+
+} // namespace detail
+
+// attaches a (non-owned) state object to a stream which can be retrieved by
+// codecs via get_stream_state<State>(stream). Adapters can be nested in order
+// to attach multiple states. The adapter forwards the input operations and/or
+// the output operations depending on what the wrapped stream supports. It can
+// only be rewound if the state is a rewindable_stream_state.
+template <typename Stream, typename State>
+class stateful_stream
+{
+    Stream *mStream;
+    State *mState;
+
+public:
+    using stream_type = Stream;
+    using state_type = State;
+
+    explicit stateful_stream(Stream &stream, State &state) noexcept
+        : mStream(&stream)
+        , mState(&state)
+    {
+    }
+
+    [[nodiscard]] auto base() const noexcept -> Stream &
+    {
+        return *mStream;
+    }
+    [[nodiscard]] auto state() const noexcept -> State &
+    {
+        return *mState;
+    }
+
+    // output stream operations
+    template <output_stream S = Stream>
+    friend inline auto tag_invoke(write_fn,
+                                  stateful_stream &self,
+                                  std::size_t const size) noexcept(
+            noexcept(dp::write(std::declval<S &>(), size)))
+            -> decltype(dp::write(std::declval<S &>(), size))
+    {
+        return dp::write(*self.mStream, size);
+    }
+    template <output_stream S = Stream>
+    friend inline auto tag_invoke(write_fn,
+                                  stateful_stream &self,
+                                  std::byte const *bytes,
+                                  std::size_t const numBytes) noexcept(
+            noexcept(dp::write(std::declval<S &>(), bytes, numBytes)))
+            -> decltype(dp::write(std::declval<S &>(), bytes, numBytes))
+    {
+        return dp::write(*self.mStream, bytes, numBytes);
+    }
+    template <typename WriteProxy, output_stream S = Stream>
+    friend inline auto tag_invoke(commit_fn,
+                                  stateful_stream &self,
+                                  WriteProxy &proxy,
+                                  std::size_t const size) noexcept(
+            noexcept(dp::commit(std::declval<S &>(), proxy, size)))
+            -> decltype(dp::commit(std::declval<S &>(), proxy, size))
+    {
+        return dp::commit(*self.mStream, proxy, size);
+    }
+    template <typename WriteProxy, output_stream S = Stream>
+    friend inline auto
+    tag_invoke(commit_fn, stateful_stream &self, WriteProxy &proxy) noexcept(
+            noexcept(dp::commit(std::declval<S &>(), proxy)))
+            -> decltype(dp::commit(std::declval<S &>(), proxy))
+    {
+        return dp::commit(*self.mStream, proxy);
+    }
+
+    // input stream operations
+    template <input_stream S = Stream>
+    friend inline auto tag_invoke(read_fn,
+                                  stateful_stream &self,
+                                  std::size_t const size) noexcept(
+            noexcept(dp::read(std::declval<S &>(), size)))
+            -> decltype(dp::read(std::declval<S &>(), size))
+    {
+        return dp::read(*self.mStream, size);
+    }
+    template <input_stream S = Stream>
+    friend inline auto tag_invoke(read_fn,
+                                  stateful_stream &self,
+                                  std::byte *buffer,
+                                  std::size_t const size) noexcept(
+            noexcept(dp::read(std::declval<S &>(), buffer, size)))
+            -> decltype(dp::read(std::declval<S &>(), buffer, size))
+    {
+        return dp::read(*self.mStream, buffer, size);
+    }
+    template <typename ReadProxy, input_stream S = Stream>
+    friend inline auto tag_invoke(consume_fn,
+                                  stateful_stream &self,
+                                  ReadProxy &proxy,
+                                  std::size_t const size) noexcept(
+            noexcept(dp::consume(std::declval<S &>(), proxy, size)))
+            -> decltype(dp::consume(std::declval<S &>(), proxy, size))
+    {
+        return dp::consume(*self.mStream, proxy, size);
+    }
+    template <typename ReadProxy, input_stream S = Stream>
+    friend inline auto
+    tag_invoke(consume_fn, stateful_stream &self, ReadProxy &proxy) noexcept(
+            noexcept(dp::consume(std::declval<S &>(), proxy)))
+            -> decltype(dp::consume(std::declval<S &>(), proxy))
+    {
+        return dp::consume(*self.mStream, proxy);
+    }
+    template <input_stream S = Stream>
+    friend inline auto tag_invoke(skip_bytes_fn,
+                                  stateful_stream &self,
+                                  std::uint64_t const numBytes) noexcept(
+            noexcept(dp::skip_bytes(std::declval<S &>(), numBytes)))
+            -> decltype(dp::skip_bytes(std::declval<S &>(), numBytes))
+    {
+        return dp::skip_bytes(*self.mStream, numBytes);
+    }
+    template <input_stream S = Stream>
+    friend inline auto
+    tag_invoke(available_input_size_fn, stateful_stream &self) noexcept(
+            noexcept(dp::available_input_size(std::declval<S &>())))
+            -> decltype(dp::available_input_size(std::declval<S &>()))
+    {
+        return dp::available_input_size(*self.mStream);
+    }
+    // the state must be rolled back together with the stream, because
+    // states usually accumulate information about the already decoded
+    // items, e.g. the strings which can be referenced by a stringref
+    template <rewindable_input_stream S = Stream,
+              rewindable_stream_state St = State>
+    friend inline auto tag_invoke(checkpoint_fn, stateful_stream &self)
+            -> result<detail::stateful_checkpoint<checkpoint_t<S>,
+                                                  typename St::checkpoint_type>>
+    {
+        DPLX_TRY(checkpoint_t<S> streamCheckpoint,
+                 dp::checkpoint(*self.mStream));
+        return detail::stateful_checkpoint<checkpoint_t<S>,
+                                           typename St::checkpoint_type>{
+                std::move(streamCheckpoint), self.mState->checkpoint()};
+    }
+    template <rewindable_input_stream S = Stream,
+              rewindable_stream_state St = State>
+    friend inline auto tag_invoke(
+            rewind_fn,
+            stateful_stream &self,
+            detail::stateful_checkpoint<checkpoint_t<S>,
+                                        typename St::checkpoint_type> const
+                    &cp) -> result<void>
+    {
+        self.mState->rewind(cp.state);
+        DPLX_TRY(dp::rewind(*self.mStream, cp.stream));
+        return oc::success();
+    }
+};
+
+namespace detail
+{
+
+template <typename T>
+inline constexpr bool is_stateful_stream_v = false;
+template <typename Stream, typename State>
+inline constexpr bool is_stateful_stream_v<stateful_stream<Stream, State>>
+        = true;
+
+template <typename Stream, typename State>
+constexpr auto has_stream_state_impl() noexcept -> bool
+{
+    if constexpr (!is_stateful_stream_v<Stream>)
+    {
+        return false;
+    }
+    else if constexpr (std::same_as<typename Stream::state_type, State>)
+    {
+        return true;
+    }
+    else
+    {
+        return has_stream_state_impl<typename Stream::stream_type, State>();
+    }
+}
+
+} // namespace detail
+
+template <typename Stream, typename State>
+concept has_stream_state = detail::has_stream_state_impl<Stream, State>();
+
+// retrieves the outermost state of the given type attached to the stream
+template <typename State, typename Stream>
+    requires has_stream_state<Stream, State>
+constexpr auto get_stream_state(Stream &stream) noexcept -> State &
+{
+    if constexpr (std::same_as<typename Stream::state_type, State>)
+    {
+        return stream.state();
+    }
+    else
+    {
+        return dp::get_stream_state<State>(stream.base());
+    }
+}
+
+// invokes fn with a stream which forwards to the given stream but doesn't
+// carry any of the given States, e.g. in order to encode a nested item which
+// must not take part in a namespace established by the outer stream. The
+// remaining states are reattached in their original order.
+template <typename... States, typename Stream, typename Fn>
+inline auto with_stream_states_detached(Stream &stream, Fn &&fn)
+        -> decltype(auto)
+{
+    if constexpr (!(has_stream_state<Stream, States> || ...))
+    {
+        return static_cast<Fn &&>(fn)(stream);
+    }
+    else if constexpr ((std::same_as<typename Stream::state_type, States>
+                        || ...))
+    {
+        return dp::with_stream_states_detached<States...>(
+                stream.base(), static_cast<Fn &&>(fn));
+    }
+    else
+    {
+        return dp::with_stream_states_detached<States...>(
+                stream.base(), [&stream, &fn](auto &inner) {
+                    stateful_stream<std::remove_cvref_t<decltype(inner)>,
+                                    typename Stream::state_type>
+                            reattached(inner, stream.state());
+                    return static_cast<Fn &&>(fn)(reattached);
+                });
+    }
+}
+
+} // namespace dplx::dp
@@ -0,0 +1,116 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#include <limits>
+#include <span>
+
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+
+namespace dplx::dp
+{
+
+// encoders may reserve up to this many bytes more than they eventually commit
+// e.g. item_emitter always reserves var_uint_max_size bytes for an item head.
+// Buffers fed to an unchecked_memory_buffer must therefore extend at least
+// this far beyond the end of the encoded data.
+inline constexpr std::size_t unchecked_output_padding
+        = minimum_guaranteed_write_size;
+
+// an output stream writing into a buffer whose size is known to suffice,
+// e.g. because it has been computed with encoded_size_of() beforehand.
+// Capacity is only checked in debug builds.
+class unchecked_memory_buffer
+{
+    std::byte *mBegin;
+    std::byte *mCursor;
+#if !defined(NDEBUG)
+    std::byte *mEnd;
+#endif
+
+public:
+    explicit unchecked_memory_buffer(std::span<std::byte> const memory) noexcept
+        : mBegin(memory.data())
+        , mCursor(memory.data())
+#if !defined(NDEBUG)
+        , mEnd(memory.data() + memory.size())
+#endif
+    {
+    }
+
+    [[nodiscard]] auto written_size() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(mCursor - mBegin);
+    }
+    [[nodiscard]] auto written() const noexcept -> std::span<std::byte>
+    {
+        return {mBegin, mCursor};
+    }
+
+    friend inline auto tag_invoke(write_fn,
+                                  unchecked_memory_buffer &self,
+                                  std::size_t const size) noexcept
+            -> result<std::span<std::byte>>
+    {
+        assert(size <= static_cast<std::size_t>(self.mEnd - self.mCursor));
+
+        auto *const proxy = self.mCursor;
+        self.mCursor += size;
+        return std::span<std::byte>(proxy, size);
+    }
+    friend inline auto tag_invoke(write_fn,
+                                  unchecked_memory_buffer &self,
+                                  std::byte const *data,
+                                  std::size_t const size) noexcept
+            -> result<void>
+    {
+        assert(size <= static_cast<std::size_t>(self.mEnd - self.mCursor));
+
+        std::memcpy(self.mCursor, data, size);
+        self.mCursor += size;
+        return success();
+    }
+
+    friend inline auto tag_invoke(commit_fn,
+                                  unchecked_memory_buffer &self,
+                                  std::span<std::byte> const writeProxy,
+                                  std::size_t const actualSize) noexcept
+            -> result<void>
+    {
+        assert(actualSize <= writeProxy.size());
+
+        self.mCursor -= writeProxy.size() - actualSize;
+        return success();
+    }
+};
+
+namespace detail
+{
+
+// the number of bytes a write reservation may exceed the space which is
+// eventually committed. Checked streams simply fail a reservation which
+// exceeds their capacity.
+template <typename Stream>
+inline constexpr std::size_t over_reservation_limit
+        = std::numeric_limits<std::size_t>::max();
+template <>
+inline constexpr std::size_t over_reservation_limit<unchecked_memory_buffer>
+        = unchecked_output_padding;
+template <typename Stream, typename State>
+inline constexpr std::size_t
+        over_reservation_limit<stateful_stream<Stream, State>>
+        = over_reservation_limit<Stream>;
+
+} // namespace detail
+
+} // namespace dplx::dp
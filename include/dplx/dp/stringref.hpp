@@ -0,0 +1,344 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/detail/hash.hpp>
+#include <dplx/dp/disappointment.hpp>
+#include <dplx/dp/item_emitter.hpp>
+#include <dplx/dp/stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+
+// implements the stringref extension
+// http://cbor.schmorp.de/stringref
+//
+// Within a namespace (tag 256) every definite length text or byte string
+// which is long enough is assigned the next index of a table which is
+// shared by both string types. Repeated strings are then replaced by a
+// reference to their index (tag 25).
+
+namespace dplx::dp
+{
+
+inline constexpr std::uint64_t stringref_tag = 25u;
+inline constexpr std::uint64_t stringref_namespace_tag = 256u;
+
+namespace detail
+{
+
+// a string is only assigned an index if a reference to it is shorter
+constexpr auto stringref_min_size(std::uint64_t const index) noexcept
+        -> std::size_t
+{
+    return index < 24u            ? 3u
+         : index < 0x100u         ? 4u
+         : index < 0x1'0000u      ? 5u
+         : index < 0x1'0000'0000u ? 7u
+                                  : 11u;
+}
+
+} // namespace detail
+
+// the encoder side string table. It doesn't copy the strings, i.e. they
+// must outlive the table content which is the case for the duration of an
+// encode_stringref() call. Clearing the table retains its memory.
+class stringref_table
+{
+    struct slot
+    {
+        std::uint64_t hash;
+        std::byte const *data;
+        std::size_t size;
+        std::uint64_t index;
+        bool text;
+    };
+
+    static constexpr std::size_t initial_capacity = 64u;
+
+    std::vector<slot> mSlots;
+    std::size_t mSize;
+
+public:
+    static constexpr std::uint64_t npos = ~std::uint64_t{};
+
+    stringref_table() noexcept
+        : mSlots()
+        , mSize(0u)
+    {
+    }
+
+    // the number of strings which have been assigned an index
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mSize;
+    }
+
+    // returns the index of an equal string of the same type or npos in which
+    // case the string is assigned the next index if it is long enough
+    auto find_or_insert(bool const text,
+                        std::byte const *const data,
+                        std::size_t const size) noexcept
+            -> result<std::uint64_t>
+    {
+        if (size < detail::stringref_min_size(0u))
+        {
+            return npos;
+        }
+        // the load factor is kept at or below 50%
+        if (mSize >= mSlots.size() / 2u)
+        {
+            DPLX_TRY(grow());
+        }
+
+        auto const hash = detail::fnvx_hash(data, size, text ? 1u : 0u);
+        auto const mask = mSlots.size() - 1u;
+        for (auto i = static_cast<std::size_t>(hash) & mask;;
+             i = (i + 1u) & mask)
+        {
+            auto &candidate = mSlots[i];
+            if (candidate.data == nullptr)
+            {
+                if (size >= detail::stringref_min_size(mSize))
+                {
+                    candidate = slot{hash, data, size, mSize, text};
+                    ++mSize;
+                }
+                return npos;
+            }
+            if (candidate.hash == hash && candidate.size == size
+                && candidate.text == text
+                && std::memcmp(candidate.data, data, size) == 0)
+            {
+                return candidate.index;
+            }
+        }
+    }
+
+    // assigns the next index to a string which has been written verbatim,
+    // e.g. as part of a raw item, if it is long enough. The decoder assigns
+    // an index to every such string even if it is a duplicate.
+    auto insert(bool const text,
+                std::byte const *const data,
+                std::size_t const size) noexcept -> result<void>
+    {
+        if (size < detail::stringref_min_size(mSize))
+        {
+            return oc::success();
+        }
+        if (mSize >= mSlots.size() / 2u)
+        {
+            DPLX_TRY(grow());
+        }
+
+        auto const hash = detail::fnvx_hash(data, size, text ? 1u : 0u);
+        auto const mask = mSlots.size() - 1u;
+        for (auto i = static_cast<std::size_t>(hash) & mask;;
+             i = (i + 1u) & mask)
+        {
+            auto &candidate = mSlots[i];
+            if (candidate.data == nullptr)
+            {
+                candidate = slot{hash, data, size, mSize, text};
+                break;
+            }
+            // the older index is kept as it is encoded at most as long
+            if (candidate.hash == hash && candidate.size == size
+                && candidate.text == text
+                && std::memcmp(candidate.data, data, size) == 0)
+            {
+                break;
+            }
+        }
+        ++mSize;
+        return oc::success();
+    }
+
+    void clear() noexcept
+    {
+        for (auto &s : mSlots)
+        {
+            s = slot{};
+        }
+        mSize = 0u;
+    }
+
+private:
+    auto grow() noexcept -> result<void>
+    {
+        auto const capacity = mSlots.empty() ? initial_capacity
+                                             : mSlots.size() * 2u;
+        std::vector<slot> slots;
+        try
+        {
+            slots.resize(capacity);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+
+        auto const mask = capacity - 1u;
+        for (auto const &s : mSlots)
+        {
+            if (s.data == nullptr)
+            {
+                continue;
+            }
+            auto i = static_cast<std::size_t>(s.hash) & mask;
+            while (slots[i].data != nullptr)
+            {
+                i = (i + 1u) & mask;
+            }
+            slots[i] = s;
+        }
+        mSlots = std::move(slots);
+        return oc::success();
+    }
+};
+
+// the decoder side string table. The strings are copied into a single
+// buffer. Clearing the table retains its memory.
+class stringref_dictionary
+{
+    struct entry
+    {
+        std::size_t offset;
+        std::size_t size;
+        bool text;
+    };
+
+    std::vector<entry> mEntries;
+    std::vector<std::byte> mStorage;
+
+public:
+    stringref_dictionary() noexcept
+        : mEntries()
+        , mStorage()
+    {
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mEntries.size();
+    }
+
+    // assigns the next index to the string if it is long enough
+    auto add(bool const text,
+             std::byte const *const data,
+             std::size_t const size) noexcept -> result<void>
+    {
+        if (size < detail::stringref_min_size(mEntries.size()))
+        {
+            return oc::success();
+        }
+        try
+        {
+            auto const offset = mStorage.size();
+            mStorage.insert(mStorage.end(), data, data + size);
+            mEntries.push_back(entry{offset, size, text});
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        return oc::success();
+    }
+
+    struct referenced_string
+    {
+        std::span<std::byte const> content;
+        bool text;
+    };
+    // the referenced string of either type
+    [[nodiscard]] auto find(std::uint64_t const index) const noexcept
+            -> result<referenced_string>
+    {
+        if (index >= mEntries.size())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_value_out_of_range;
+            }
+        auto const &e = mEntries[static_cast<std::size_t>(index)];
+        return referenced_string{
+                std::span<std::byte const>(mStorage.data() + e.offset, e.size),
+                e.text};
+    }
+
+    // the referenced string must be of the expected type
+    [[nodiscard]] auto find(std::uint64_t const index, bool const text) const
+            noexcept -> result<std::span<std::byte const>>
+    {
+        DPLX_TRY(referenced_string const str, find(index));
+        if (str.text != text)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_type_mismatch;
+            }
+        return str.content;
+    }
+
+    void clear() noexcept
+    {
+        mEntries.clear();
+        mStorage.clear();
+    }
+
+    // allows a stream carrying the dictionary to be rewound, see
+    // stateful_stream
+    struct checkpoint_type
+    {
+        std::size_t num_entries;
+        std::size_t storage_size;
+    };
+    [[nodiscard]] auto checkpoint() const noexcept -> checkpoint_type
+    {
+        return {mEntries.size(), mStorage.size()};
+    }
+    // forgets the strings which have been added after the checkpoint
+    void rewind(checkpoint_type const &cp) noexcept
+    {
+        mEntries.resize(cp.num_entries);
+        mStorage.resize(cp.storage_size);
+    }
+};
+
+namespace detail
+{
+
+// emits a reference if the string is known and otherwise registers it with
+// the stringref_table attached to the stream. Returns true if the string
+// has been replaced by a reference.
+template <output_stream Stream>
+    requires has_stream_state<Stream, stringref_table>
+inline auto emit_stringref(Stream &outStream,
+                           bool const text,
+                           std::byte const *const data,
+                           std::size_t const size) -> result<bool>
+{
+    auto &table = dp::get_stream_state<stringref_table>(outStream);
+    DPLX_TRY(std::uint64_t const index, table.find_or_insert(text, data, size));
+    if (index == stringref_table::npos)
+    {
+        return false;
+    }
+
+    DPLX_TRY(item_emitter<Stream>::tag(outStream, stringref_tag));
+    DPLX_TRY(item_emitter<Stream>::integer(outStream, index));
+    return true;
+}
+
+} // namespace detail
+
+} // namespace dplx::dp
@@ -127,6 +127,12 @@ struct tuple_def
     {
         return (... + static_cast<MapFn &&>(map)(Properties));
     }
+    // invokes fn for each property in declaration order
+    template <typename Fn>
+    static constexpr void mp_for_each(Fn &&fn)
+    {
+        (..., static_cast<Fn &&>(fn)(Properties));
+    }
 
     friend inline constexpr auto operator==(tuple_def const &,
                                             tuple_def const &) noexcept -> bool
@@ -0,0 +1,722 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <concepts>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/detail/type_utils.hpp>
+#include <dplx/dp/detail/utils.hpp>
+#include <dplx/dp/disappointment.hpp>
+
+namespace dplx::dp
+{
+
+enum class value_kind : std::uint8_t
+{
+    null,
+    undefined,
+    boolean,
+    integer,
+    floating_point,
+    text,
+    binary,
+    array,
+    map,
+    tag,
+};
+
+class value_arena;
+struct value_map_entry;
+
+namespace detail
+{
+struct value_access;
+}
+
+// a schema-less CBOR data item represented by a 16 byte node. Scalars and
+// strings of up to 14 bytes are stored inline, everything else references
+// memory owned by a value_arena, i.e. copying a value is cheap, but the
+// copy must not outlive the arena.
+//
+// Text and binary views returned for inline strings point into the value
+// object itself.
+class value
+{
+    static constexpr std::size_t inline_capacity = 14u;
+    static constexpr std::uint8_t out_of_line = 0xffu;
+
+    // integers: CBOR argument, i.e. the complement for negative integers
+    // floating point: double
+    // strings/containers: pointer + std::uint32_t size or inline bytes
+    alignas(std::uint64_t) std::byte mStorage[inline_capacity];
+    // boolean value, negative flag, float width or inline string size
+    std::uint8_t mAux;
+    value_kind mKind;
+
+    friend class value_arena;
+    friend struct detail::value_access;
+
+public:
+    constexpr value() noexcept
+        : mStorage{}
+        , mAux(0u)
+        , mKind(value_kind::null)
+    {
+    }
+
+    template <std::same_as<bool> B>
+    value(B const boolean) noexcept
+        : value(value_kind::boolean, boolean ? 1u : 0u)
+    {
+    }
+    template <integer T>
+    value(T const integer) noexcept
+        : value(value_kind::integer, 0u)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (integer < 0)
+            {
+                // complement negatives
+                store_bits(~static_cast<std::uint64_t>(
+                        static_cast<std::int64_t>(integer)));
+                mAux = 1u;
+                return;
+            }
+        }
+        store_bits(static_cast<std::uint64_t>(integer));
+    }
+    value(float const number) noexcept
+        : value(value_kind::floating_point, sizeof(float))
+    {
+        store_float(number);
+    }
+    value(double const number) noexcept
+        : value(value_kind::floating_point, sizeof(double))
+    {
+        store_float(number);
+    }
+
+    static auto undefined() noexcept -> value
+    {
+        return value(value_kind::undefined, 0u);
+    }
+
+    [[nodiscard]] auto kind() const noexcept -> value_kind
+    {
+        return mKind;
+    }
+
+    [[nodiscard]] auto as_boolean() const noexcept -> result<bool>
+    {
+        if (mKind != value_kind::boolean)
+        {
+            return errc::item_type_mismatch;
+        }
+        return mAux != 0u;
+    }
+
+    // fails with item_value_out_of_range if the integer isn't representable
+    // by T
+    template <integer T>
+    [[nodiscard]] auto as_integer() const noexcept -> result<T>
+    {
+        if (mKind != value_kind::integer)
+        {
+            return errc::item_type_mismatch;
+        }
+        auto const bits = load_bits();
+        if (mAux == 0u)
+        {
+            if (bits > static_cast<std::make_unsigned_t<T>>(
+                        std::numeric_limits<T>::max()))
+            {
+                return errc::item_value_out_of_range;
+            }
+            return static_cast<T>(bits);
+        }
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (bits > static_cast<std::make_unsigned_t<T>>(
+                        std::numeric_limits<T>::max()))
+            {
+                return errc::item_value_out_of_range;
+            }
+            return static_cast<T>(static_cast<std::int64_t>(~bits));
+        }
+        else
+        {
+            return errc::item_value_out_of_range;
+        }
+    }
+
+    [[nodiscard]] auto as_double() const noexcept -> result<double>
+    {
+        if (mKind != value_kind::floating_point)
+        {
+            return errc::item_type_mismatch;
+        }
+        return load_float();
+    }
+
+    [[nodiscard]] auto as_text() const noexcept -> result<std::u8string_view>
+    {
+        if (mKind != value_kind::text)
+        {
+            return errc::item_type_mismatch;
+        }
+        auto const bytes = string_bytes();
+        return std::u8string_view(
+                reinterpret_cast<char8_t const *>(bytes.data()), bytes.size());
+    }
+
+    [[nodiscard]] auto as_binary() const noexcept
+            -> result<std::span<std::byte const>>
+    {
+        if (mKind != value_kind::binary)
+        {
+            return errc::item_type_mismatch;
+        }
+        return string_bytes();
+    }
+
+    [[nodiscard]] auto as_array() const noexcept
+            -> result<std::span<value const>>
+    {
+        if (mKind != value_kind::array)
+        {
+            return errc::item_type_mismatch;
+        }
+        return std::span<value const>(load_pointer<value>(), load_size());
+    }
+
+    [[nodiscard]] inline auto as_map() const noexcept
+            -> result<std::span<value_map_entry const>>;
+
+    [[nodiscard]] auto tag_number() const noexcept -> result<std::uint64_t>
+    {
+        if (mKind != value_kind::tag)
+        {
+            return errc::item_type_mismatch;
+        }
+        return load_pointer<value>()[0].load_bits();
+    }
+    [[nodiscard]] auto tagged_item() const noexcept -> result<value const *>
+    {
+        if (mKind != value_kind::tag)
+        {
+            return errc::item_type_mismatch;
+        }
+        return load_pointer<value>() + 1;
+    }
+
+    // returns the value of the map entry with the given text key or nullptr if
+    // this isn't a map or there is no such entry
+    [[nodiscard]] inline auto find(std::u8string_view key) const noexcept
+            -> value const *;
+
+    friend inline auto operator==(value const &lhs, value const &rhs) noexcept
+            -> bool;
+
+private:
+    constexpr value(value_kind const kind, std::uint8_t const aux) noexcept
+        : mStorage{}
+        , mAux(aux)
+        , mKind(kind)
+    {
+    }
+
+    static auto make_reference(value_kind const kind,
+                               void const *const data,
+                               std::uint32_t const size) noexcept -> value
+    {
+        value self(kind, out_of_line);
+        std::memcpy(self.mStorage, &data, sizeof(data));
+        std::memcpy(self.mStorage + sizeof(data), &size, sizeof(size));
+        return self;
+    }
+    // copies short strings inline, otherwise the data must be owned by an
+    // arena
+    static auto make_string(value_kind const kind,
+                            std::byte const *const data,
+                            std::uint32_t const size) noexcept -> value
+    {
+        if (size > inline_capacity)
+        {
+            return make_reference(kind, data, size);
+        }
+        value self(kind, static_cast<std::uint8_t>(size));
+        if (size > 0u)
+        {
+            std::memcpy(self.mStorage, data, size);
+        }
+        return self;
+    }
+
+    void store_bits(std::uint64_t const bits) noexcept
+    {
+        std::memcpy(mStorage, &bits, sizeof(bits));
+    }
+    [[nodiscard]] auto load_bits() const noexcept -> std::uint64_t
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, mStorage, sizeof(bits));
+        return bits;
+    }
+    void store_float(double const number) noexcept
+    {
+        std::memcpy(mStorage, &number, sizeof(number));
+    }
+    [[nodiscard]] auto load_float() const noexcept -> double
+    {
+        double number;
+        std::memcpy(&number, mStorage, sizeof(number));
+        return number;
+    }
+    template <typename T>
+    [[nodiscard]] auto load_pointer() const noexcept -> T const *
+    {
+        void const *data;
+        std::memcpy(&data, mStorage, sizeof(data));
+        return static_cast<T const *>(data);
+    }
+    [[nodiscard]] auto load_size() const noexcept -> std::uint32_t
+    {
+        std::uint32_t size;
+        std::memcpy(&size, mStorage + sizeof(void const *), sizeof(size));
+        return size;
+    }
+    [[nodiscard]] auto string_bytes() const noexcept
+            -> std::span<std::byte const>
+    {
+        if (mAux == out_of_line)
+        {
+            return {load_pointer<std::byte>(), load_size()};
+        }
+        return {mStorage, mAux};
+    }
+};
+static_assert(sizeof(value) == 16u);
+static_assert(std::is_trivially_copyable_v<value>);
+
+struct value_map_entry
+{
+    value key;
+    value mapped;
+};
+
+inline auto value::as_map() const noexcept
+        -> result<std::span<value_map_entry const>>
+{
+    if (mKind != value_kind::map)
+    {
+        return errc::item_type_mismatch;
+    }
+    return std::span<value_map_entry const>(load_pointer<value_map_entry>(),
+                                            load_size());
+}
+
+inline auto value::find(std::u8string_view const key) const noexcept
+        -> value const *
+{
+    if (mKind != value_kind::map)
+    {
+        return nullptr;
+    }
+    std::span<value_map_entry const> const entries(
+            load_pointer<value_map_entry>(), load_size());
+    for (auto const &entry : entries)
+    {
+        if (entry.key.mKind == value_kind::text)
+        {
+            auto const bytes = entry.key.string_bytes();
+            if (bytes.size() == key.size()
+                && (key.empty()
+                    || std::memcmp(bytes.data(), key.data(), key.size()) == 0))
+            {
+                return &entry.mapped;
+            }
+        }
+    }
+    return nullptr;
+}
+
+inline auto operator==(value const &lhs, value const &rhs) noexcept -> bool
+{
+    if (lhs.mKind != rhs.mKind)
+    {
+        return false;
+    }
+    switch (lhs.mKind)
+    {
+    case value_kind::null:
+    case value_kind::undefined:
+        return true;
+
+    case value_kind::boolean:
+        return lhs.mAux == rhs.mAux;
+
+    case value_kind::integer:
+        return lhs.mAux == rhs.mAux && lhs.load_bits() == rhs.load_bits();
+
+    case value_kind::floating_point:
+        return lhs.load_float() == rhs.load_float();
+
+    case value_kind::text:
+    case value_kind::binary:
+        return std::ranges::equal(lhs.string_bytes(), rhs.string_bytes());
+
+    case value_kind::array:
+        return std::ranges::equal(lhs.as_array().assume_value(),
+                                  rhs.as_array().assume_value());
+
+    case value_kind::map:
+        return std::ranges::equal(
+                lhs.as_map().assume_value(), rhs.as_map().assume_value(),
+                [](value_map_entry const &l, value_map_entry const &r) {
+                    return l.key == r.key && l.mapped == r.mapped;
+                });
+
+    case value_kind::tag:
+        return lhs.load_pointer<value>()[0].load_bits()
+                    == rhs.load_pointer<value>()[0].load_bits()
+            && lhs.load_pointer<value>()[1] == rhs.load_pointer<value>()[1];
+    }
+    return false;
+}
+
+// a monotonic allocator for the nodes and strings of values. The memory is
+// only released by clear() or by destroying the arena. Moving the arena
+// doesn't invalidate the values allocated from it.
+class value_arena
+{
+    static constexpr std::size_t initial_block_size = 1024u;
+
+    std::vector<std::unique_ptr<std::byte[]>> mBlocks;
+    std::byte *mCursor;
+    std::size_t mRemaining;
+    std::size_t mBlockSize;
+    std::size_t mMaxNestingDepth;
+
+public:
+    // the value decoder recurses once per nesting level
+    static constexpr std::size_t default_max_nesting_depth = 256u;
+
+    value_arena() noexcept
+        : mBlocks()
+        , mCursor(nullptr)
+        , mRemaining(0u)
+        , mBlockSize(0u)
+        , mMaxNestingDepth(default_max_nesting_depth)
+    {
+    }
+
+    value_arena(value_arena const &) = delete;
+    auto operator=(value_arena const &) -> value_arena & = delete;
+
+    value_arena(value_arena &&other) noexcept
+        : mBlocks(std::move(other.mBlocks))
+        , mCursor(std::exchange(other.mCursor, nullptr))
+        , mRemaining(std::exchange(other.mRemaining, 0u))
+        , mBlockSize(std::exchange(other.mBlockSize, 0u))
+        , mMaxNestingDepth(other.mMaxNestingDepth)
+    {
+    }
+    auto operator=(value_arena &&other) noexcept -> value_arena &
+    {
+        mBlocks = std::move(other.mBlocks);
+        mCursor = std::exchange(other.mCursor, nullptr);
+        mRemaining = std::exchange(other.mRemaining, 0u);
+        mBlockSize = std::exchange(other.mBlockSize, 0u);
+        mMaxNestingDepth = other.mMaxNestingDepth;
+        return *this;
+    }
+
+    // the maximum number of arrays, maps and tags enclosing a value decoded
+    // into this arena
+    [[nodiscard]] auto max_nesting_depth() const noexcept -> std::size_t
+    {
+        return mMaxNestingDepth;
+    }
+    void max_nesting_depth(std::size_t const maxDepth) noexcept
+    {
+        mMaxNestingDepth = maxDepth;
+    }
+
+    // invalidates all values allocated from this arena, but keeps the most
+    // recently allocated block for reuse.
+    void clear() noexcept
+    {
+        if (mBlocks.empty())
+        {
+            return;
+        }
+        if (mBlocks.size() > 1u)
+        {
+            std::swap(mBlocks.front(), mBlocks.back());
+            mBlocks.erase(mBlocks.begin() + 1, mBlocks.end());
+        }
+        mCursor = mBlocks.front().get();
+        mRemaining = mBlockSize;
+    }
+
+    // allows a stream carrying the arena to be rewound, see stateful_stream.
+    // The checkpoint is invalidated by clear().
+    struct checkpoint_type
+    {
+        std::size_t num_blocks;
+        std::byte *cursor;
+        std::size_t remaining;
+        std::size_t block_size;
+    };
+    [[nodiscard]] auto checkpoint() const noexcept -> checkpoint_type
+    {
+        return {mBlocks.size(), mCursor, mRemaining, mBlockSize};
+    }
+    // invalidates the values which have been allocated after the checkpoint
+    void rewind(checkpoint_type const &cp) noexcept
+    {
+        mBlocks.erase(mBlocks.begin()
+                              + static_cast<std::ptrdiff_t>(cp.num_blocks),
+                      mBlocks.end());
+        mCursor = cp.cursor;
+        mRemaining = cp.remaining;
+        mBlockSize = cp.block_size;
+    }
+
+    auto allocate(std::size_t const size, std::size_t const alignment) noexcept
+            -> result<std::byte *>
+    {
+        auto const misalignment
+                = reinterpret_cast<std::uintptr_t>(mCursor) % alignment;
+        auto const padding
+                = misalignment == 0u ? 0u : alignment - misalignment;
+        if (mRemaining < padding || mRemaining - padding < size)
+        {
+            DPLX_TRY(allocate_block(size + alignment));
+            return allocate(size, alignment);
+        }
+        std::byte *const memory = mCursor + padding;
+        mCursor = memory + size;
+        mRemaining -= padding + size;
+        return memory;
+    }
+
+    auto make_text(std::u8string_view const text) -> result<value>
+    {
+        return make_string(value_kind::text,
+                           std::as_bytes(std::span(text.data(), text.size())));
+    }
+    auto make_binary(std::span<std::byte const> const bytes) -> result<value>
+    {
+        return make_string(value_kind::binary, bytes);
+    }
+    // the elements are copied, i.e. they must have been allocated from this
+    // arena
+    auto make_array(std::span<value const> const elements) -> result<value>
+    {
+        DPLX_TRY(auto const size, checked_size(elements.size()));
+        DPLX_TRY(value * nodes, allocate_nodes<value>(size));
+        std::ranges::copy(elements, nodes);
+        return value::make_reference(value_kind::array, nodes, size);
+    }
+    auto make_map(std::span<value_map_entry const> const entries)
+            -> result<value>
+    {
+        DPLX_TRY(auto const size, checked_size(entries.size()));
+        DPLX_TRY(value_map_entry * nodes,
+                 allocate_nodes<value_map_entry>(size));
+        std::ranges::copy(entries, nodes);
+        return value::make_reference(value_kind::map, nodes, size);
+    }
+    auto make_tag(std::uint64_t const tagNumber, value const &item)
+            -> result<value>
+    {
+        DPLX_TRY(value * nodes, allocate_nodes<value>(2u));
+        nodes[0] = value(tagNumber);
+        nodes[1] = item;
+        return value::make_reference(value_kind::tag, nodes, 2u);
+    }
+
+    // default constructs the nodes
+    template <typename T>
+    auto allocate_nodes(std::size_t const numNodes) noexcept -> result<T *>
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+        if (numNodes == 0u)
+        {
+            return static_cast<T *>(nullptr);
+        }
+        if (numNodes > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            return errc::not_enough_memory;
+        }
+        DPLX_TRY(std::byte * memory,
+                 allocate(numNodes * sizeof(T), alignof(T)));
+
+        auto *const nodes = reinterpret_cast<T *>(memory);
+        std::uninitialized_value_construct_n(nodes, numNodes);
+        return nodes;
+    }
+
+    static auto checked_size(std::size_t const size) noexcept
+            -> result<std::uint32_t>
+    {
+        if (size > std::numeric_limits<std::uint32_t>::max())
+        {
+            return errc::item_value_out_of_range;
+        }
+        return static_cast<std::uint32_t>(size);
+    }
+
+private:
+    auto make_string(value_kind const kind,
+                     std::span<std::byte const> const bytes) -> result<value>
+    {
+        DPLX_TRY(auto const size, checked_size(bytes.size()));
+        if (size <= value::inline_capacity)
+        {
+            return value::make_string(kind, bytes.data(), size);
+        }
+        DPLX_TRY(std::byte * memory, allocate(size, 1u));
+        std::memcpy(memory, bytes.data(), size);
+        return value::make_string(kind, memory, size);
+    }
+
+    auto allocate_block(std::size_t const minSize) noexcept -> result<void>
+    {
+        auto const blockSize = std::max(
+                minSize, mBlocks.empty() ? initial_block_size : 2 * mBlockSize);
+        try
+        {
+            std::unique_ptr<std::byte[]> block(new std::byte[blockSize]);
+            mBlocks.push_back(std::move(block));
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        mCursor = mBlocks.back().get();
+        mRemaining = blockSize;
+        mBlockSize = blockSize;
+        return oc::success();
+    }
+};
+
+// owns a value_arena and the root value of a decoded or assembled item
+class document
+{
+    value_arena mArena;
+    value mRoot;
+
+public:
+    document() noexcept = default;
+
+    [[nodiscard]] auto root() const noexcept -> value const &
+    {
+        return mRoot;
+    }
+    [[nodiscard]] auto arena() noexcept -> value_arena &
+    {
+        return mArena;
+    }
+
+    // the root must have been allocated from the document arena
+    void assign_root(value const &root) noexcept
+    {
+        mRoot = root;
+    }
+
+    void clear() noexcept
+    {
+        mArena.clear();
+        mRoot = value();
+    }
+};
+
+namespace detail
+{
+
+// grants the codecs access to the value representation
+struct value_access
+{
+    static auto make_integer(std::uint64_t const bits,
+                             bool const negative) noexcept -> value
+    {
+        value self(value_kind::integer, negative ? 1u : 0u);
+        self.store_bits(bits);
+        return self;
+    }
+    static auto make_float(double const number,
+                           std::uint8_t const width) noexcept -> value
+    {
+        value self(value_kind::floating_point, width);
+        self.store_float(number);
+        return self;
+    }
+    static auto make_boolean(bool const boolean) noexcept -> value
+    {
+        return value(value_kind::boolean, boolean ? 1u : 0u);
+    }
+    static auto make_string(value_kind const kind,
+                            std::byte const *const data,
+                            std::uint32_t const size) noexcept -> value
+    {
+        return value::make_string(kind, data, size);
+    }
+    static auto make_reference(value_kind const kind,
+                               void const *const data,
+                               std::uint32_t const size) noexcept -> value
+    {
+        return value::make_reference(kind, data, size);
+    }
+
+    static auto integer_bits(value const &self) noexcept -> std::uint64_t
+    {
+        return self.load_bits();
+    }
+    static auto is_negative(value const &self) noexcept -> bool
+    {
+        return self.mAux != 0u;
+    }
+    static auto float_width(value const &self) noexcept -> std::uint8_t
+    {
+        return self.mAux;
+    }
+    static auto string_bytes(value const &self) noexcept
+            -> std::span<std::byte const>
+    {
+        return self.string_bytes();
+    }
+    static auto children(value const &self) noexcept -> value const *
+    {
+        return self.load_pointer<value>();
+    }
+    static auto size(value const &self) noexcept -> std::uint32_t
+    {
+        return self.load_size();
+    }
+
+    static constexpr std::size_t inline_capacity = value::inline_capacity;
+};
+
+} // namespace detail
+
+} // namespace dplx::dp
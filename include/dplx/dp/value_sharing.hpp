@@ -0,0 +1,238 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <dplx/dp/disappointment.hpp>
+
+// implements the value sharing extension for std::shared_ptr
+// http://cbor.schmorp.de/value-sharing
+//
+// The first occurrence of an object is tagged as shareable (tag 28) which
+// implicitly assigns it the next index. Later occurrences of the same object
+// are encoded as a reference to its index (tag 29). The indices are assigned
+// before the object content is encoded, i.e. cyclic graphs round trip, too.
+
+namespace dplx::dp
+{
+
+inline constexpr std::uint64_t shareable_tag = 28u;
+inline constexpr std::uint64_t shared_reference_tag = 29u;
+
+namespace detail
+{
+
+// the address of this variable identifies the object type
+template <typename T>
+inline constexpr char sharing_type_key = 0;
+
+} // namespace detail
+
+// the encoder side map from object addresses (and types) to indices. Clearing
+// the index retains its memory.
+class sharing_index
+{
+    struct slot
+    {
+        void const *object;
+        void const *type;
+        std::uint64_t index;
+    };
+
+    static constexpr std::size_t initial_capacity = 64u;
+
+    std::vector<slot> mSlots;
+    std::size_t mSize;
+
+public:
+    static constexpr std::uint64_t npos = ~std::uint64_t{};
+
+    sharing_index() noexcept
+        : mSlots()
+        , mSize(0u)
+    {
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mSize;
+    }
+
+    // returns the index of the object or npos in which case the object is
+    // assigned the next index
+    template <typename T>
+    auto find_or_insert(T const *const object) noexcept
+            -> result<std::uint64_t>
+    {
+        // the load factor is kept at or below 50%
+        if (mSize >= mSlots.size() / 2u)
+        {
+            DPLX_TRY(grow());
+        }
+
+        void const *const type = &detail::sharing_type_key<T>;
+        auto const mask = mSlots.size() - 1u;
+        for (auto i = hash(object) & mask;; i = (i + 1u) & mask)
+        {
+            auto &candidate = mSlots[i];
+            if (candidate.object == nullptr)
+            {
+                candidate = slot{object, type, mSize};
+                ++mSize;
+                return npos;
+            }
+            if (candidate.object == object && candidate.type == type)
+            {
+                return candidate.index;
+            }
+        }
+    }
+
+    void clear() noexcept
+    {
+        for (auto &s : mSlots)
+        {
+            s = slot{};
+        }
+        mSize = 0u;
+    }
+
+private:
+    static auto hash(void const *const object) noexcept -> std::size_t
+    {
+        // fibonacci hashing; the high bits are folded into the low bits
+        // which are used for indexing
+        auto const bits = static_cast<std::uint64_t>(
+                reinterpret_cast<std::uintptr_t>(object));
+        auto const h = bits * 0x9e37'79b9'7f4a'7c15u;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    auto grow() noexcept -> result<void>
+    {
+        auto const capacity = mSlots.empty() ? initial_capacity
+                                             : mSlots.size() * 2u;
+        std::vector<slot> slots;
+        try
+        {
+            slots.resize(capacity);
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+
+        auto const mask = capacity - 1u;
+        for (auto const &s : mSlots)
+        {
+            if (s.object == nullptr)
+            {
+                continue;
+            }
+            auto i = hash(s.object) & mask;
+            while (slots[i].object != nullptr)
+            {
+                i = (i + 1u) & mask;
+            }
+            slots[i] = s;
+        }
+        mSlots = std::move(slots);
+        return oc::success();
+    }
+};
+
+// the decoder side list of the shareable objects. A reference must resolve
+// to an object of the same type. Clearing the table retains its memory.
+class sharing_table
+{
+    struct entry
+    {
+        std::shared_ptr<void> object;
+        void const *type;
+    };
+
+    std::vector<entry> mEntries;
+
+public:
+    sharing_table() noexcept
+        : mEntries()
+    {
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return mEntries.size();
+    }
+
+    template <typename T>
+    auto add(std::shared_ptr<T> object) noexcept -> result<void>
+    {
+        try
+        {
+            mEntries.push_back(entry{std::move(object),
+                                     &detail::sharing_type_key<T>});
+        }
+        catch (std::bad_alloc const &)
+        {
+            return errc::not_enough_memory;
+        }
+        return oc::success();
+    }
+
+    template <typename T>
+    [[nodiscard]] auto find(std::uint64_t const index) const noexcept
+            -> result<std::shared_ptr<T>>
+    {
+        if (index >= mEntries.size())
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_value_out_of_range;
+            }
+        auto const &e = mEntries[static_cast<std::size_t>(index)];
+        if (e.type != &detail::sharing_type_key<T>)
+            DPLX_ATTR_UNLIKELY
+            {
+                return errc::item_type_mismatch;
+            }
+        return std::static_pointer_cast<T>(e.object);
+    }
+
+    // whether the object at the index is of the given type
+    template <typename T>
+    [[nodiscard]] auto holds(std::uint64_t const index) const noexcept -> bool
+    {
+        return index < mEntries.size()
+            && mEntries[static_cast<std::size_t>(index)].type
+                       == &detail::sharing_type_key<T>;
+    }
+
+    void clear() noexcept
+    {
+        mEntries.clear();
+    }
+
+    // allows a stream carrying the table to be rewound, see stateful_stream
+    using checkpoint_type = std::size_t;
+    [[nodiscard]] auto checkpoint() const noexcept -> checkpoint_type
+    {
+        return mEntries.size();
+    }
+    // forgets the objects which have been added after the checkpoint
+    void rewind(checkpoint_type const cp) noexcept
+    {
+        mEntries.resize(cp);
+    }
+};
+
+} // namespace dplx::dp
@@ -0,0 +1,256 @@
+// Copyright Henrik Steffen Gaßmann 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <concepts>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <dplx/dp/concepts.hpp>
+#include <dplx/dp/detail/pre_encoded.hpp>
+#include <dplx/dp/fwd.hpp>
+#include <dplx/dp/layout_descriptor.hpp>
+#include <dplx/dp/object_def.hpp>
+#include <dplx/dp/packed_bits.hpp>
+#include <dplx/dp/type_code.hpp>
+
+namespace dplx::dp
+{
+
+// std::optional is encoded as null or the value. std::variant is either
+// encoded as the active alternative which is selected during decoding by its
+// initial item (see initial_items_of) or as an array of the alternative index
+// followed by the alternative.
+enum class variant_encoding : unsigned char
+{
+    item_dispatch,
+    indexed,
+};
+
+template <typename Variant>
+inline constexpr variant_encoding variant_encoding_for
+        = variant_encoding::item_dispatch;
+
+// a value which is encoded as tag(Tag, value). Variant alternatives which
+// share the item type of their encoding can be told apart by their tags.
+template <std::uint64_t Tag, typename T>
+struct tagged
+{
+    static constexpr std::uint64_t tag = Tag;
+
+    T value;
+
+    friend inline auto operator==(tagged const &, tagged const &) -> bool
+            = default;
+};
+
+// the initial bytes the encoding of a type can start with. If the encoding
+// starts with a tag the initial bytes are the head of the tag number.
+struct initial_item_set
+{
+    std::array<std::uint64_t, 4> bytes;
+    std::uint64_t tag;
+    bool is_tagged;
+
+    [[nodiscard]] constexpr auto contains(std::size_t const initialByte) const
+            noexcept -> bool
+    {
+        return ((bytes[initialByte / 64u] >> (initialByte % 64u)) & 1u) != 0u;
+    }
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool
+    {
+        return (bytes[0] | bytes[1] | bytes[2] | bytes[3]) == 0u;
+    }
+
+    constexpr void add(std::size_t const initialByte) noexcept
+    {
+        bytes[initialByte / 64u] |= std::uint64_t{1} << (initialByte % 64u);
+    }
+    // adds every (definite and indefinite) head of the given major type
+    constexpr void add_heads_of(type_code const type) noexcept
+    {
+        auto const category = static_cast<std::size_t>(type);
+        for (std::size_t i = 0u; i <= 27u; ++i)
+        {
+            add(category | i);
+        }
+        if (type != type_code::posint && type != type_code::negint)
+        {
+            add(category | 31u);
+        }
+    }
+
+    static constexpr auto of_tag(std::uint64_t const number) noexcept
+            -> initial_item_set
+    {
+        std::size_t const additionalInfo
+                = number <= detail::inline_value_max ? number
+                : number <= 0xffu                    ? 24u
+                : number <= 0xffffu                  ? 25u
+                : number <= 0xffff'ffffu             ? 26u
+                                                     : 27u;
+
+        initial_item_set set{};
+        set.add(static_cast<std::size_t>(type_code::tag) | additionalInfo);
+        set.tag = number;
+        set.is_tagged = true;
+        return set;
+    }
+};
+
+template <typename T>
+struct initial_items_of;
+
+} // namespace dplx::dp
+
+namespace dplx::dp::detail
+{
+
+template <typename T>
+inline constexpr bool is_std_optional_v = false;
+template <typename T>
+inline constexpr bool is_std_optional_v<std::optional<T>> = true;
+
+template <typename T>
+inline constexpr bool is_std_shared_ptr_v = false;
+template <typename T>
+inline constexpr bool is_std_shared_ptr_v<std::shared_ptr<T>> = true;
+
+template <typename T>
+inline constexpr bool is_std_vector_bool_v = false;
+template <typename Allocator>
+inline constexpr bool is_std_vector_bool_v<std::vector<bool, Allocator>>
+        = true;
+
+// clang-format off
+template <typename T>
+concept statically_tagged
+    = requires
+    {
+        typename std::integral_constant<std::uint64_t, T::tag>;
+    };
+// clang-format on
+
+// the initial items of the codecs shipped with this library; types which
+// aren't covered yield an empty set
+template <typename T>
+constexpr auto default_initial_items() noexcept -> initial_item_set
+{
+    initial_item_set set{};
+    if constexpr (statically_tagged<T>)
+    {
+        set = initial_item_set::of_tag(T::tag);
+    }
+    else if constexpr (is_std_vector_bool_v<T>)
+    {
+        set = initial_item_set::of_tag(packed_bits_tag);
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        set.add(static_cast<std::size_t>(type_code::bool_false));
+        set.add(static_cast<std::size_t>(type_code::bool_true));
+    }
+    else if constexpr (std::same_as<T, null_type>)
+    {
+        set.add(static_cast<std::size_t>(type_code::null));
+    }
+    else if constexpr (std::unsigned_integral<T>)
+    {
+        set.add_heads_of(type_code::posint);
+    }
+    else if constexpr (std::signed_integral<T>)
+    {
+        set.add_heads_of(type_code::posint);
+        set.add_heads_of(type_code::negint);
+    }
+    else if constexpr (std::floating_point<T>)
+    {
+        set.add(static_cast<std::size_t>(type_code::float_half));
+        set.add(static_cast<std::size_t>(type_code::float_single));
+        set.add(static_cast<std::size_t>(type_code::float_double));
+    }
+    else if constexpr (codable_enum<T>)
+    {
+        set = detail::default_initial_items<std::underlying_type_t<T>>();
+    }
+    else if constexpr (is_std_optional_v<T>)
+    {
+        set = initial_items_of<typename T::value_type>::value;
+        set.add(static_cast<std::size_t>(type_code::null));
+    }
+    else if constexpr (is_std_shared_ptr_v<T>)
+    {
+        // shareable and shared reference tags are looked through
+        set = initial_items_of<
+                std::remove_cv_t<typename T::element_type>>::value;
+        set.add(static_cast<std::size_t>(type_code::null));
+    }
+    else if constexpr (is_fixed_u8string_v<T>)
+    {
+        set.add_heads_of(type_code::text);
+    }
+    else if constexpr (packable_object<T>)
+    {
+        set.add_heads_of(layout_descriptor_for_v<T>.encoding
+                                         == object_encoding::presence_bitmap
+                                 ? type_code::array
+                                 : type_code::map);
+    }
+    else if constexpr (packable_tuple<T> || tuple_like<T>)
+    {
+        set.add_heads_of(type_code::array);
+    }
+    else if constexpr (std::ranges::range<T>)
+    {
+        using value_type = std::ranges::range_value_t<T>;
+        if constexpr (std::same_as<value_type, std::byte>)
+        {
+            set.add_heads_of(type_code::binary);
+        }
+        else if constexpr (std::same_as<value_type, char8_t>
+                           || std::same_as<value_type, char>)
+        {
+            set.add_heads_of(type_code::text);
+        }
+        else if constexpr (associative_range<T>)
+        {
+            set.add_heads_of(type_code::map);
+        }
+        else
+        {
+            set.add_heads_of(type_code::array);
+        }
+    }
+    return set;
+}
+
+} // namespace dplx::dp::detail
+
+namespace dplx::dp
+{
+
+// may be specialized for types whose encoding isn't covered by the defaults
+template <typename T>
+struct initial_items_of
+{
+    static constexpr initial_item_set value
+            = detail::default_initial_items<T>();
+};
+
+template <typename T>
+inline constexpr initial_item_set initial_items_of_v
+        = initial_items_of<T>::value;
+
+} // namespace dplx::dp
@@ -71,6 +71,16 @@ auto error_category_impl::message(int errval) const -> std::string
         return "An indefinite binary/string/array/map CBOR item has been encountered during canonical or strict parsing"s;
     case errc::string_exceeds_size_limit:
         return "A binary/string CBOR item exceeded a size limit imposed by the user."s;
+    case errc::unknown_message_type:
+        return "the message envelope carries a type id which isn't registered"s;
+    case errc::checkpoint_expired:
+        return "the input stream no longer retains the data of the checkpoint"s;
+    case errc::invalid_argument:
+        return "a function has been called with an invalid argument value"s;
+    case errc::nesting_depth_exceeded:
+        return "the CBOR items are nested deeper than the limit imposed by the user"s;
+    case errc::unsupported_raw_item:
+        return "the raw item refers to stream state which can't be captured or spliced"s;
 
     default:
         return fmt::format(FMT_STRING("unknown code {}"), errval);
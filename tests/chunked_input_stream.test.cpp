@@ -65,6 +65,7 @@ static_assert(dp::input_stream<test_chunked_input_stream>);
 static_assert(!dp::lazy_input_stream<test_chunked_input_stream>);
 static_assert(dp::stream_traits<test_chunked_input_stream>::input);
 static_assert(dp::stream_traits<test_chunked_input_stream>::nothrow_input);
+static_assert(dp::rewindable_input_stream<test_chunked_input_stream>);
 
 struct chunked_input_stream_dependencies
 {
@@ -438,6 +439,47 @@ BOOST_AUTO_TEST_CASE(skips_over_a_chunk_gap)
     BOOST_TEST(std::ranges::size(proxy) == 39u);
 }
 
+BOOST_AUTO_TEST_CASE(rewinds_within_the_small_buffer)
+{
+    DPLX_REQUIRE_RESULT(dp::skip_bytes(subject, 70u));
+
+    // reading across the chunk boundary fills the small buffer
+    auto sreadRx = dp::read(subject, 20u);
+    DPLX_REQUIRE_RESULT(sreadRx);
+    auto proxy = sreadRx.assume_value();
+    DPLX_REQUIRE_RESULT(dp::consume(subject, proxy, 4u));
+
+    auto checkpointRx = dp::checkpoint(subject);
+    DPLX_REQUIRE_RESULT(checkpointRx);
+
+    DPLX_REQUIRE_RESULT(dp::skip_bytes(subject, 30u));
+    DPLX_REQUIRE_RESULT(dp::rewind(subject, checkpointRx.assume_value()));
+
+    auto availableRx = dp::available_input_size(subject);
+    DPLX_REQUIRE_RESULT(availableRx);
+    BOOST_TEST(availableRx.assume_value() == testSize - 74u);
+
+    std::array<std::byte, 10> buffer{};
+    DPLX_REQUIRE_RESULT(dp::read(subject, buffer.data(), buffer.size()));
+    for (std::size_t i = 0; i < buffer.size(); ++i)
+    {
+        BOOST_TEST(buffer[i] == static_cast<std::byte>(74u + i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(checkpoints_expire_with_their_chunk)
+{
+    DPLX_REQUIRE_RESULT(dp::skip_bytes(subject, 10u));
+
+    auto checkpointRx = dp::checkpoint(subject);
+    DPLX_REQUIRE_RESULT(checkpointRx);
+
+    DPLX_REQUIRE_RESULT(dp::skip_bytes(subject, 80u));
+    auto rewindRx = dp::rewind(subject, checkpointRx.assume_value());
+    BOOST_TEST_REQUIRE(rewindRx.has_error());
+    BOOST_TEST(rewindRx.assume_error() == dp::errc::checkpoint_expired);
+}
+
 BOOST_AUTO_TEST_CASE(skips_correctly_from_sbo_1)
 {
     auto sreadRx = dp::read(subject, 57);
@@ -0,0 +1,170 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/columnar.hpp>
+
+#include <bit>
+#include <cstdint>
+
+#include <span>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/columnar.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/columnar.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/object_def.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/streams/memory_output_stream.hpp>
+#include <dplx/dp/tuple_def.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(columnar)
+
+struct sample
+{
+    std::uint64_t timestamp;
+    std::int32_t delta;
+    double value;
+    bool valid;
+
+    static constexpr dp::tuple_def<dp::tuple_member_def<&sample::timestamp>{},
+                                   dp::tuple_member_def<&sample::delta>{},
+                                   dp::tuple_member_def<&sample::value>{},
+                                   dp::tuple_member_def<&sample::valid>{}>
+            layout_descriptor{};
+
+    friend auto operator==(sample const &, sample const &) noexcept -> bool
+            = default;
+};
+
+struct point
+{
+    std::uint16_t id;
+    std::int8_t x;
+
+    static constexpr dp::object_def<
+            dp::named_property_def<u8"id", &point::id>{},
+            dp::named_property_def<u8"x", &point::x>{}>
+            layout_descriptor{
+                    .version = 1u,
+            };
+};
+
+using sample_columns = dp::columnar<std::vector<sample>>;
+using typed_sample_columns
+        = dp::columnar<std::vector<sample>, dp::column_encoding::typed_array>;
+
+static_assert(dp::encodable<sample_columns, test_output_stream<>>);
+static_assert(dp::decodable<sample_columns, test_input_stream>);
+
+static_assert(dp::detail::typed_array_tag<std::uint8_t>(std::endian::little)
+              == 64u);
+static_assert(dp::detail::typed_array_tag<std::uint16_t>(std::endian::big)
+              == 65u);
+static_assert(dp::detail::typed_array_tag<std::int64_t>(std::endian::little)
+              == 79u);
+static_assert(dp::detail::typed_array_tag<float>(std::endian::big) == 81u);
+static_assert(dp::detail::typed_array_tag<double>(std::endian::little)
+              == 86u);
+
+auto make_samples(std::size_t const num) -> std::vector<sample>
+{
+    std::vector<sample> samples;
+    for (std::size_t i = 0u; i < num; ++i)
+    {
+        samples.push_back({1'600'000'000u + i, static_cast<std::int32_t>(i) - 5,
+                           static_cast<double>(i) * 0.5, i % 3u == 0u});
+    }
+    return samples;
+}
+
+template <typename Columnar>
+void check_round_trip(std::size_t const numRecords)
+{
+    Columnar const value{make_samples(numRecords)};
+
+    std::vector<std::byte> storage(dp::encoded_size_of(value));
+    dp::memory_buffer encodingBuffer{std::span<std::byte>(storage)};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+    BOOST_TEST(encodingBuffer.remaining_size() == 0u);
+
+    dp::memory_view istream{std::span<std::byte const>(storage)};
+    Columnar decoded{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST((decoded.records == value.records));
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_arrays)
+{
+    check_round_trip<sample_columns>(0u);
+    check_round_trip<sample_columns>(100u);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_typed_arrays)
+{
+    // exceeds the chunk size of the typed array codec
+    check_round_trip<typed_sample_columns>(300u);
+}
+
+BOOST_AUTO_TEST_CASE(encode_object_columns)
+{
+    dp::columnar<std::vector<point>> const value{{{1u, -1}, {2u, 2}}};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+    BOOST_TEST(encodingBuffer.size() == dp::encoded_size_of(value));
+
+    // [1, [1, 2], [-1, 2]]
+    auto const expected
+            = make_byte_array(0x83, 0x01, 0x82, 0x01, 0x02, 0x82, 0x20, 0x02);
+    BOOST_TEST(std::span(static_cast<byte_span>(encodingBuffer)) == expected,
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(decode_big_endian_typed_arrays)
+{
+    // [1, 65(h'0001 0102'), 72(h'ff02')]
+    auto bytes = make_byte_array<16>({0x83, 0x01, 0xd8, 0x41, 0x44, 0x00, 0x01,
+                                      0x01, 0x02, 0xd8, 0x48, 0x42, 0xff,
+                                      0x02});
+    test_input_stream istream{byte_span(bytes)};
+
+    dp::columnar<std::vector<point>> decoded{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+
+    BOOST_TEST_REQUIRE(decoded.records.size() == 2u);
+    BOOST_TEST(decoded.records[0].id == 1u);
+    BOOST_TEST(decoded.records[1].id == 0x0102u);
+    BOOST_TEST(decoded.records[0].x == -1);
+    BOOST_TEST(decoded.records[1].x == 2);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_uneven_columns)
+{
+    // [1, [1, 2], [2]]
+    auto bytes = make_byte_array<16>(
+            {0x83, 0x01, 0x82, 0x01, 0x02, 0x81, 0x02});
+    test_input_stream istream{byte_span(bytes)};
+
+    dp::columnar<std::vector<point>> decoded{};
+    auto rx = dp::decode(istream, decoded);
+    BOOST_TEST(rx.error() == dp::errc::tuple_size_mismatch);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
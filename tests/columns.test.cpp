@@ -0,0 +1,127 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/columns.hpp>
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/columns.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/std_string.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/columns.hpp>
+#include <dplx/dp/encoder/core.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(columns)
+
+using test_columns = dp::columns<std::vector<std::int64_t>,
+                                 std::vector<unsigned>,
+                                 std::vector<std::u8string>>;
+
+static_assert(dp::decodable<test_columns, test_input_stream>);
+static_assert(dp::encodable<test_columns, test_output_stream<>>);
+
+BOOST_AUTO_TEST_CASE(decode_scatters_rows)
+{
+    // [[-1, 2, "a"], [3, 4, "bc"]]
+    auto bytes = make_byte_array<16, int>({0x82, 0x83, 0x20, 0x02, 0x61, 'a',
+                                           0x83, 0x03, 0x04, 0x62, 'b', 'c'});
+    test_input_stream stream{byte_span(bytes)};
+
+    test_columns out;
+    out.column<1>().push_back(7u);
+    DPLX_REQUIRE_RESULT(dp::decode(stream, out));
+
+    BOOST_TEST_REQUIRE(out.size() == 2u);
+    BOOST_TEST(out.column<0>() == (std::vector<std::int64_t>{-1, 3}),
+               boost::test_tools::per_element{});
+    BOOST_TEST(out.column<1>() == (std::vector<unsigned>{2u, 4u}),
+               boost::test_tools::per_element{});
+    BOOST_TEST((out.column<2>()[1] == u8"bc"));
+}
+
+BOOST_AUTO_TEST_CASE(decode_into_referenced_containers)
+{
+    // [_ [1, 2], [3, 4]]
+    auto bytes = make_byte_array<12>(
+            {0x9f, 0x82, 0x01, 0x02, 0x82, 0x03, 0x04, 0xff});
+    test_input_stream stream{byte_span(bytes)};
+
+    std::vector<int> timestamps;
+    std::vector<int> values;
+    auto out = dp::as_columns(timestamps, values);
+    DPLX_REQUIRE_RESULT(dp::decode(stream, out));
+
+    BOOST_TEST(timestamps == (std::vector<int>{1, 3}),
+               boost::test_tools::per_element{});
+    BOOST_TEST(values == (std::vector<int>{2, 4}),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_mismatching_rows)
+{
+    // [[1, 2], [3]]
+    auto bytes
+            = make_byte_array<12>({0x82, 0x82, 0x01, 0x02, 0x81, 0x03});
+    test_input_stream stream{byte_span(bytes)};
+
+    std::vector<int> first;
+    std::vector<int> second;
+    auto out = dp::as_columns(first, second);
+    auto rx = dp::decode(stream, out);
+
+    BOOST_TEST(rx.error() == dp::errc::tuple_size_mismatch);
+    BOOST_TEST(first.empty());
+    BOOST_TEST(second.empty());
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    test_columns value(std::vector<std::int64_t>{-500, 0, 1'000'000},
+                       std::vector<unsigned>{1u, 24u, 256u},
+                       std::vector<std::u8string>{u8"", u8"a", u8"bcd"});
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+    BOOST_TEST(encodingBuffer.size() == dp::encoded_size_of(value));
+
+    test_input_stream stream{static_cast<byte_span>(encodingBuffer)};
+    test_columns decoded;
+    DPLX_REQUIRE_RESULT(dp::decode(stream, decoded));
+
+    BOOST_TEST(decoded.column<0>() == value.column<0>(),
+               boost::test_tools::per_element{});
+    BOOST_TEST(decoded.column<1>() == value.column<1>(),
+               boost::test_tools::per_element{});
+    BOOST_TEST((decoded.column<2>() == value.column<2>()));
+}
+
+BOOST_AUTO_TEST_CASE(encode_rejects_uneven_columns)
+{
+    std::vector<int> first{1, 2};
+    std::vector<int> second{1};
+
+    test_output_stream<> encodingBuffer{};
+    auto rx = dp::encode(encodingBuffer, dp::as_columns(first, second));
+    BOOST_TEST(rx.error() == dp::errc::tuple_size_mismatch);
+    BOOST_TEST(encodingBuffer.size() == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -0,0 +1,214 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/compressed_sequence.hpp>
+
+#include <cstdint>
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/compressed_sequence.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/compressed_sequence.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/streams/memory_output_stream.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(compressed_sequence)
+
+static_assert(dp::detail::zigzag_encode(0u) == 0u);
+static_assert(dp::detail::zigzag_encode(static_cast<std::uint64_t>(-1)) == 1u);
+static_assert(dp::detail::zigzag_encode(1u) == 2u);
+static_assert(dp::detail::zigzag_decode(3u) == static_cast<std::uint64_t>(-2));
+static_assert(dp::detail::varint_size(127u) == 1u);
+static_assert(dp::detail::varint_size(128u) == 2u);
+static_assert(dp::detail::varint_size(~std::uint64_t{}) == 10u);
+
+static_assert(dp::encodable<dp::delta_encoded<std::span<int const>>,
+                            test_output_stream<>>);
+static_assert(!dp::decodable<dp::delta_encoded<std::span<int>>,
+                             test_input_stream>);
+static_assert(
+        dp::decodable<dp::xor_encoded<std::vector<double>>, test_input_stream>);
+
+template <typename T>
+auto round_trip(T const &value) -> T
+{
+    auto const encodedSize = dp::encoded_size_of(value);
+    std::vector<std::byte> storage(static_cast<std::size_t>(encodedSize));
+    dp::memory_buffer buffer{std::span<std::byte>(storage)};
+    auto encodeRx = dp::encode(buffer, value);
+    BOOST_TEST_REQUIRE(encodeRx.has_value());
+    BOOST_TEST(buffer.consumed_size() == encodedSize);
+
+    dp::memory_view istream{std::span<std::byte const>(storage)};
+    T decoded{};
+    auto decodeRx = dp::decode(istream, decoded);
+    BOOST_TEST_REQUIRE(decodeRx.has_value());
+    BOOST_TEST(istream.remaining_size() == 0);
+    return decoded;
+}
+
+BOOST_AUTO_TEST_CASE(delta_encodes_small_differences)
+{
+    std::vector<std::uint32_t> const ids{1000u, 1001u, 1003u, 1002u};
+    dp::delta_encoded const value{std::span(ids)};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+
+    // 0x6470'0001(h'04 d00f 02 04 01')
+    auto const expected = make_byte_array<12>(
+            {0xda, 0x64, 0x70, 0x00, 0x01, 0x46, 0x04, 0xd0, 0x0f, 0x02, 0x04,
+             0x01});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(value) == expected.size());
+}
+
+BOOST_AUTO_TEST_CASE(delta_round_trip)
+{
+    dp::delta_encoded<std::vector<std::int64_t>> value{
+            {0, -1, std::numeric_limits<std::int64_t>::max(),
+             std::numeric_limits<std::int64_t>::min(), 42}};
+    for (std::int64_t i = 0; i < 200; ++i)
+    {
+        value.values.push_back(i * i - 1000);
+    }
+
+    auto const decoded = round_trip(value);
+    BOOST_TEST(decoded.values == value.values,
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(delta_of_delta_compresses_regular_timestamps)
+{
+    dp::delta_of_delta_encoded<std::vector<std::uint64_t>> value;
+    for (std::uint64_t i = 0u; i < 1000u; ++i)
+    {
+        value.values.push_back(1'600'000'000'000u + i * 250u);
+    }
+    value.values[500] += 3u;
+
+    // only the first two entries need more than one byte
+    BOOST_TEST(dp::detail::compressed_payload_size(value) == 2u * 6u + 998u);
+
+    auto const decoded = round_trip(value);
+    BOOST_TEST(decoded.values == value.values,
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(xor_round_trip)
+{
+    dp::xor_encoded<std::vector<double>> value{
+            {12.0, 12.0, 12.5, 12.25, 24.0, -0.0, 1e300,
+             std::numeric_limits<double>::infinity(), 1e-300, 1e-300}};
+    for (int i = 0; i < 500; ++i)
+    {
+        value.values.push_back(20.0 + (i % 7) * 0.125);
+    }
+
+    auto const decoded = round_trip(value);
+    BOOST_TEST_REQUIRE(decoded.values.size() == value.values.size());
+    for (std::size_t i = 0u; i < value.values.size(); ++i)
+    {
+        BOOST_TEST(std::bit_cast<std::uint64_t>(decoded.values[i])
+                   == std::bit_cast<std::uint64_t>(value.values[i]));
+    }
+    // most of the slowly changing values need less than two bytes
+    BOOST_TEST(dp::encoded_size_of(value) < 2u * value.values.size());
+}
+
+BOOST_AUTO_TEST_CASE(xor_encodes_repeated_floats_as_single_bits)
+{
+    dp::xor_encoded<std::vector<float>> value{{1.0f, 1.0f, 1.0f}};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+
+    // 0x6470'0003(h'03 3f800000 00')
+    auto const expected = make_byte_array<12>(
+            {0xda, 0x64, 0x70, 0x00, 0x03, 0x46, 0x03, 0x3f, 0x80, 0x00, 0x00,
+             0x00});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+
+    auto const decoded = round_trip(value);
+    BOOST_TEST(decoded.values == value.values,
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(empty_sequences)
+{
+    BOOST_TEST(round_trip(dp::delta_encoded<std::vector<int>>{})
+                       .values.empty());
+    BOOST_TEST(round_trip(dp::xor_encoded<std::vector<double>>{})
+                       .values.empty());
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_out_of_range_values)
+{
+    // 0x6470'0001(h'01 feff03') i.e. [32767]
+    auto bytes = make_byte_array<10>(
+            {0xda, 0x64, 0x70, 0x00, 0x01, 0x44, 0x01, 0xfe, 0xff, 0x03});
+    test_input_stream istream{std::span(bytes)};
+
+    dp::delta_encoded<std::vector<std::int8_t>> value;
+    BOOST_TEST(dp::decode(istream, value).error()
+               == dp::errc::item_value_out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_malformed_payloads)
+{
+    dp::delta_encoded<std::vector<int>> value;
+    {
+        // the count exceeds the payload
+        auto bytes = make_byte_array<8>(
+                {0xda, 0x64, 0x70, 0x00, 0x01, 0x42, 0x05, 0x02});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode(istream, value).error()
+                   == dp::errc::item_value_out_of_range);
+    }
+    {
+        // a trailing byte
+        auto bytes = make_byte_array<9>(
+                {0xda, 0x64, 0x70, 0x00, 0x01, 0x43, 0x01, 0x02, 0x00});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode(istream, value).error()
+                   == dp::errc::item_value_out_of_range);
+    }
+    {
+        // a truncated varint
+        auto bytes = make_byte_array<8>(
+                {0xda, 0x64, 0x70, 0x00, 0x01, 0x42, 0x01, 0x82});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode(istream, value).error()
+                   == dp::errc::item_value_out_of_range);
+    }
+    {
+        // the xor encoding
+        auto bytes = make_byte_array<8>(
+                {0xda, 0x64, 0x70, 0x00, 0x03, 0x42, 0x01, 0x02});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode(istream, value).error()
+                   == dp::errc::item_type_mismatch);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -0,0 +1,240 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/decoder/fixed_shape.hpp>
+
+#include <array>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/object_utils.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+struct wide_sample_record
+{
+    std::uint64_t a;
+    std::uint64_t b;
+    std::uint64_t c;
+    std::uint64_t d;
+    std::uint64_t e;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&wide_sample_record::a>{},
+            dp::tuple_member_def<&wide_sample_record::b>{},
+            dp::tuple_member_def<&wide_sample_record::c>{},
+            dp::tuple_member_def<&wide_sample_record::d>{},
+            dp::tuple_member_def<&wide_sample_record::e>{}>
+            layout_descriptor{};
+};
+
+} // namespace dp_tests
+
+template <>
+inline constexpr std::size_t
+        dplx::dp::single_pass_decoding_limit<dp_tests::wide_sample_record>
+        = 64u;
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(decoder)
+
+BOOST_AUTO_TEST_SUITE(fixed_shape)
+
+using dp::detail::fixed_shape_input_bound_v;
+
+static_assert(fixed_shape_input_bound_v<bool> == 1u);
+static_assert(fixed_shape_input_bound_v<std::uint8_t> == 9u);
+static_assert(fixed_shape_input_bound_v<float> == 9u);
+static_assert(fixed_shape_input_bound_v<dp::fixed_u8string<8>> == 17u);
+static_assert(fixed_shape_input_bound_v<std::array<std::byte, 4>> == 13u);
+static_assert(fixed_shape_input_bound_v<std::array<bool, 4>> == 13u);
+
+static_assert(!dp::detail::fixed_shape_decodable<std::vector<int>>);
+
+struct telemetry_record
+{
+    std::uint64_t timestamp;
+    std::uint32_t sensor;
+    float value;
+    bool valid;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&telemetry_record::timestamp>{},
+            dp::tuple_member_def<&telemetry_record::sensor>{},
+            dp::tuple_member_def<&telemetry_record::value>{},
+            dp::tuple_member_def<&telemetry_record::valid>{}>
+            layout_descriptor{};
+};
+static_assert(fixed_shape_input_bound_v<telemetry_record> == 9u * 4u + 1u);
+static_assert(dp::single_pass_decodable<telemetry_record>);
+
+struct status_record
+{
+    std::uint32_t id;
+    bool ok;
+
+    static constexpr dp::object_def<
+            dp::named_property_def<u8"id", &status_record::id>{},
+            dp::named_property_def<u8"ok", &status_record::ok>{}>
+            layout_descriptor{};
+};
+static_assert(fixed_shape_input_bound_v<status_record>
+              == 9u + 3u + 9u + 3u + 1u);
+static_assert(dp::single_pass_decodable<status_record>);
+
+struct unbounded_record
+{
+    std::uint32_t id;
+    std::vector<std::uint32_t> values;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&unbounded_record::id>{},
+            dp::tuple_member_def<&unbounded_record::values>{}>
+            layout_descriptor{};
+};
+static_assert(!dp::single_pass_decodable<unbounded_record>);
+
+BOOST_AUTO_TEST_CASE(tuple_is_decoded_in_a_single_pass)
+{
+    auto bytes = make_byte_array<40>({0x84, 0x19, 0x01, 0x00, 0x07, 0xfa, 0x3f,
+                                      0xc0, 0x00, 0x00, 0xf5});
+    test_input_stream istream{bytes};
+
+    telemetry_record record{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, record));
+
+    BOOST_TEST(istream.read_counter() == 1);
+    BOOST_TEST(record.timestamp == 0x100u);
+    BOOST_TEST(record.sensor == 7u);
+    BOOST_TEST(record.value == 1.5f);
+    BOOST_TEST(record.valid);
+    BOOST_TEST(dp::available_input_size(istream).value() == 40u - 11u);
+}
+
+BOOST_AUTO_TEST_CASE(tuple_with_non_canonical_items_is_decoded_in_a_single_pass)
+{
+    auto bytes = make_byte_array<40>({0x84, 0x1b, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                      0x00, 0x01, 0x00, 0x38, 0x00, 0xf9, 0x3e,
+                                      0x00, 0xf4});
+    test_input_stream istream{bytes};
+
+    telemetry_record record{};
+    auto rx = dp::decode(istream, record);
+    // the negint sensor value doesn't fit the unsigned member
+    BOOST_TEST(rx.error() == dp::errc::item_type_mismatch);
+
+    auto validBytes = make_byte_array<40>(
+            {0x84, 0x1b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x18,
+             0x07, 0xf9, 0x3e, 0x00, 0xf4});
+    test_input_stream validStream{validBytes};
+
+    DPLX_REQUIRE_RESULT(dp::decode(validStream, record));
+
+    BOOST_TEST(validStream.read_counter() == 1);
+    BOOST_TEST(record.timestamp == 0x100u);
+    BOOST_TEST(record.sensor == 7u);
+    BOOST_TEST(record.value == 1.5f);
+    BOOST_TEST(!record.valid);
+    BOOST_TEST(dp::available_input_size(validStream).value() == 40u - 16u);
+}
+
+BOOST_AUTO_TEST_CASE(tuple_falls_back_near_the_end_of_the_input)
+{
+    auto bytes = make_byte_array<11>({0x84, 0x19, 0x01, 0x00, 0x07, 0xfa, 0x3f,
+                                      0xc0, 0x00, 0x00, 0xf5});
+    test_input_stream istream{bytes};
+
+    telemetry_record record{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, record));
+
+    BOOST_TEST(istream.read_counter() > 1);
+    BOOST_TEST(record.timestamp == 0x100u);
+    BOOST_TEST(record.sensor == 7u);
+    BOOST_TEST(record.value == 1.5f);
+    BOOST_TEST(record.valid);
+    BOOST_TEST(dp::available_input_size(istream).value() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(object_is_decoded_in_a_single_pass)
+{
+    auto bytes = make_byte_array<32, int>(
+            {0xa2, 0x62, 'i', 'd', 0x18, 0x2a, 0x62, 'o', 'k', 0xf5});
+    test_input_stream istream{bytes};
+
+    status_record record{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, record));
+
+    BOOST_TEST(istream.read_counter() == 1);
+    BOOST_TEST(record.id == 42u);
+    BOOST_TEST(record.ok);
+    BOOST_TEST(dp::available_input_size(istream).value() == 32u - 10u);
+}
+
+BOOST_AUTO_TEST_CASE(object_with_reordered_properties_falls_back)
+{
+    auto bytes = make_byte_array<32, int>(
+            {0xa2, 0x62, 'o', 'k', 0xf5, 0x62, 'i', 'd', 0x18, 0x2a});
+    test_input_stream istream{bytes};
+
+    status_record record{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, record));
+
+    BOOST_TEST(istream.read_counter() > 1);
+    BOOST_TEST(record.id == 42u);
+    BOOST_TEST(record.ok);
+    BOOST_TEST(dp::available_input_size(istream).value() == 32u - 10u);
+}
+
+// the default limit only admits records of about four scalar members
+static_assert(fixed_shape_input_bound_v<wide_sample_record> == 9u + 5u * 9u);
+static_assert(fixed_shape_input_bound_v<wide_sample_record>
+              > dp::minimum_guaranteed_read_size);
+static_assert(dp::single_pass_decodable<wide_sample_record>);
+
+BOOST_AUTO_TEST_CASE(raised_limit_admits_wider_records)
+{
+    auto bytes
+            = make_byte_array<64>({0x85, 0x00, 0x01, 0x02, 0x18, 0xff, 0x03});
+    test_input_stream istream{bytes};
+
+    wide_sample_record record{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, record));
+
+    BOOST_TEST(istream.read_counter() == 1);
+    BOOST_TEST(record.d == 0xffu);
+    BOOST_TEST(record.e == 3u);
+    BOOST_TEST(dp::available_input_size(istream).value() == 64u - 7u);
+}
+
+BOOST_AUTO_TEST_CASE(raised_limit_falls_back_on_short_input)
+{
+    auto bytes = make_byte_array<7>({0x85, 0x00, 0x01, 0x02, 0x18, 0xff, 0x03});
+    test_input_stream istream{bytes};
+
+    wide_sample_record record{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, record));
+
+    BOOST_TEST(istream.read_counter() > 1);
+    BOOST_TEST(record.d == 0xffu);
+    BOOST_TEST(record.e == 3u);
+    BOOST_TEST(dp::available_input_size(istream).value() == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
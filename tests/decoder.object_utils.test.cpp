@@ -7,11 +7,19 @@
 
 #include <dplx/dp/decoder/object_utils.hpp>
 
+#include <vector>
+
 #include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/reuse.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/object_utils.hpp>
 #include <dplx/dp/streams/memory_input_stream.hpp>
 
 #include "boost-test.hpp"
 #include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
 #include "test_utils.hpp"
 
 namespace dp_tests
@@ -398,6 +406,250 @@ BOOST_AUTO_TEST_CASE(custom_with_named_layout_descriptor_decoding)
     BOOST_TEST(t.d() == 0x14);
 }
 
+struct presence_bitmap_object
+{
+    std::uint32_t ma;
+    std::uint32_t mb;
+    std::uint32_t mc;
+
+    static constexpr object_def<
+            property_def<1, &presence_bitmap_object::ma>{},
+            property_def<2, &presence_bitmap_object::mb>{false},
+            property_def<3, &presence_bitmap_object::mc>{false}>
+            layout_descriptor{.version = 2,
+                              .allow_versioned_auto_decoder = true,
+                              .encoding = dp::object_encoding::presence_bitmap};
+};
+static_assert(dp::packable_object<presence_bitmap_object>);
+
+BOOST_AUTO_TEST_CASE(presence_bitmap_decoding)
+{
+    auto bytes
+            = make_byte_array<32>({0b100'00000 | 4, 0x02, 0b101, 0x07, 0x05});
+    test_input_stream istream{bytes};
+
+    presence_bitmap_object t{0, 0x2a, 0};
+    auto rx = dp::basic_decoder<presence_bitmap_object, test_input_stream>()(
+            istream, t);
+    DPLX_REQUIRE_RESULT(rx);
+    BOOST_TEST(t.ma == 0x07u);
+    // absent properties are reset
+    BOOST_TEST(t.mb == 0u);
+    BOOST_TEST(t.mc == 0x05u);
+}
+
+BOOST_AUTO_TEST_CASE(presence_bitmap_reject_missing_property)
+{
+    auto bytes = make_byte_array<32>({0b100'00000 | 3, 0x02, 0b100, 0x05});
+    test_input_stream istream{bytes};
+
+    presence_bitmap_object t{};
+    auto rx = dp::basic_decoder<presence_bitmap_object, test_input_stream>()(
+            istream, t);
+    BOOST_TEST(rx.error() == errc::required_object_property_missing);
+}
+
+BOOST_AUTO_TEST_CASE(presence_bitmap_reject_unknown_property)
+{
+    auto bytes = make_byte_array<32>({0b100'00000 | 4, 0x02, 0b1001, 0x07, 0});
+    test_input_stream istream{bytes};
+
+    presence_bitmap_object t{};
+    auto rx = dp::basic_decoder<presence_bitmap_object, test_input_stream>()(
+            istream, t);
+    BOOST_TEST(rx.error() == errc::unknown_property);
+}
+
+BOOST_AUTO_TEST_CASE(presence_bitmap_reject_size_mismatch)
+{
+    auto bytes = make_byte_array<32>({0b100'00000 | 4, 0x02, 0b001, 0x07, 0});
+    test_input_stream istream{bytes};
+
+    presence_bitmap_object t{};
+    auto rx = dp::basic_decoder<presence_bitmap_object, test_input_stream>()(
+            istream, t);
+    BOOST_TEST(rx.error() == errc::tuple_size_mismatch);
+}
+
+BOOST_AUTO_TEST_CASE(presence_bitmap_reject_version_mismatch)
+{
+    auto bytes = make_byte_array<32>({0b100'00000 | 3, 0x03, 0b001, 0x07});
+    test_input_stream istream{bytes};
+
+    presence_bitmap_object t{};
+    auto rx = dp::basic_decoder<presence_bitmap_object, test_input_stream>()(
+            istream, t);
+    BOOST_TEST(rx.error() == errc::item_version_mismatch);
+}
+
+struct sparse_map_object
+{
+    std::uint32_t ma;
+    std::uint32_t mb;
+    std::uint32_t mc;
+
+    static constexpr object_def<
+            property_def<1, &sparse_map_object::ma>{},
+            property_def<2, &sparse_map_object::mb>{false},
+            property_def<3, &sparse_map_object::mc>{false}>
+            layout_descriptor{.encoding = dp::object_encoding::sparse_map};
+};
+static_assert(!dp::single_pass_decodable<sparse_map_object>);
+
+BOOST_AUTO_TEST_CASE(sparse_map_decoding)
+{
+    auto bytes = make_byte_array<32>({0b101'00000 | 2, 3, 0x05, 1, 0x07});
+    test_input_stream istream{bytes};
+
+    sparse_map_object t{};
+    auto rx = dp::basic_decoder<sparse_map_object, test_input_stream>()(
+            istream, t);
+    DPLX_REQUIRE_RESULT(rx);
+    BOOST_TEST(t.ma == 0x07u);
+    BOOST_TEST(t.mb == 0u);
+    BOOST_TEST(t.mc == 0x05u);
+}
+
+template <typename T>
+auto roundtrip_into(T const &value, T &dest) -> dp::result<void>
+{
+    test_output_stream<> ostream{};
+    DPLX_TRY(dp::encode(ostream, value));
+
+    test_input_stream istream{std::span(ostream)};
+    return dp::decode(istream, dest);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_map_resets_absent_properties)
+{
+    sparse_map_object const value{0x07u, 0u, 0x05u};
+    sparse_map_object t{0x01u, 0x02u, 0x03u};
+
+    DPLX_REQUIRE_RESULT(roundtrip_into(value, t));
+    BOOST_TEST(t.ma == 0x07u);
+    BOOST_TEST(t.mb == 0u);
+    BOOST_TEST(t.mc == 0x05u);
+}
+
+BOOST_AUTO_TEST_CASE(presence_bitmap_resets_absent_properties)
+{
+    presence_bitmap_object const value{0x07u, 0u, 0x05u};
+    presence_bitmap_object t{0x01u, 0x02u, 0x03u};
+
+    DPLX_REQUIRE_RESULT(roundtrip_into(value, t));
+    BOOST_TEST(t.ma == 0x07u);
+    BOOST_TEST(t.mb == 0u);
+    BOOST_TEST(t.mc == 0x05u);
+}
+
+struct reused_object
+{
+    std::uint32_t ma;
+    std::uint32_t mb;
+    std::vector<std::uint32_t> mc;
+
+    static constexpr object_def<property_def<1, &reused_object::ma>{},
+                                property_def<2, &reused_object::mb>{false},
+                                property_def<3, &reused_object::mc>{false}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(reuse_resets_absent_properties)
+{
+    auto fullBytes = make_byte_array<9>(
+            {0b101'00000 | 3, 1, 0x07, 2, 0x05, 3, 0x82, 0x01, 0x02});
+    auto sparseBytes = make_byte_array<3>({0b101'00000 | 1, 1, 0x08});
+
+    reused_object t{};
+    test_input_stream fullStream{fullBytes};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(fullStream, t));
+    BOOST_TEST(t.ma == 0x07u);
+    BOOST_TEST(t.mb == 0x05u);
+    BOOST_TEST(t.mc.size() == 2u);
+
+    test_input_stream sparseStream{sparseBytes};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(sparseStream, t));
+    BOOST_TEST(t.ma == 0x08u);
+    BOOST_TEST(t.mb == 0u);
+    BOOST_TEST(t.mc.empty());
+}
+
+BOOST_AUTO_TEST_CASE(reuse_retains_the_memory_of_absent_properties)
+{
+    auto fullBytes = make_byte_array<9>(
+            {0b101'00000 | 3, 1, 0x07, 2, 0x05, 3, 0x82, 0x01, 0x02});
+    auto sparseBytes = make_byte_array<3>({0b101'00000 | 1, 1, 0x08});
+
+    reused_object t{};
+    test_input_stream fullStream{fullBytes};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(fullStream, t));
+    BOOST_TEST_REQUIRE(t.mc.size() == 2u);
+    auto const *const elements = t.mc.data();
+
+    test_input_stream sparseStream{sparseBytes};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(sparseStream, t));
+    BOOST_TEST(t.mc.empty());
+    BOOST_TEST(t.mc.capacity() >= 2u);
+    BOOST_TEST(t.mc.data() == elements);
+}
+
+struct aliased_object
+{
+    std::uint32_t ma;
+    std::uint32_t mb;
+    std::uint32_t mc;
+
+    static constexpr object_def<
+            dp::aliased_property_def<u8"a", 300, &aliased_object::ma>{},
+            dp::aliased_property_def<u8"b", 2, &aliased_object::mb>{},
+            named_property_def<u8"c", &aliased_object::mc>{}>
+            layout_descriptor{.use_property_aliases = true};
+};
+
+BOOST_AUTO_TEST_CASE(aliased_property_decoding)
+{
+    auto bytes = make_byte_array<32, int>(
+            {0b101'00000 | 3, 0x61, 'c', 0x05, 2, 0x07, 0x19, 0x01, 0x2c,
+             0x0b});
+    test_input_stream istream{bytes};
+
+    aliased_object t{};
+    auto rx = dp::basic_decoder<aliased_object, test_input_stream>()(istream,
+                                                                     t);
+    DPLX_REQUIRE_RESULT(rx);
+    BOOST_TEST(t.ma == 0x0bu);
+    BOOST_TEST(t.mb == 0x07u);
+    BOOST_TEST(t.mc == 0x05u);
+}
+
+BOOST_AUTO_TEST_CASE(aliased_property_name_decoding)
+{
+    auto bytes = make_byte_array<32, int>(
+            {0b101'00000 | 3, 0x61, 'b', 0x07, 0x61, 'a', 0x0b, 0x61, 'c',
+             0x05});
+    test_input_stream istream{bytes};
+
+    aliased_object t{};
+    auto rx = dp::basic_decoder<aliased_object, test_input_stream>()(istream,
+                                                                     t);
+    DPLX_REQUIRE_RESULT(rx);
+    BOOST_TEST(t.ma == 0x0bu);
+    BOOST_TEST(t.mb == 0x07u);
+    BOOST_TEST(t.mc == 0x05u);
+}
+
+BOOST_AUTO_TEST_CASE(aliased_property_reject_unknown_alias)
+{
+    auto bytes = make_byte_array<32, int>(
+            {0b101'00000 | 3, 3, 0x07, 0x61, 'a', 0x0b, 0x61, 'c', 0x05});
+    test_input_stream istream{bytes};
+
+    aliased_object t{};
+    auto rx = dp::basic_decoder<aliased_object, test_input_stream>()(istream,
+                                                                     t);
+    BOOST_TEST(rx.error() == errc::unknown_property);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
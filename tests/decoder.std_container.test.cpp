@@ -12,12 +12,15 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <memory_resource>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include <boost/container/deque.hpp>
 #include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
 #include <boost/container/list.hpp>
 #include <boost/container/map.hpp>
 #include <boost/container/small_vector.hpp>
@@ -25,6 +28,10 @@
 #include <boost/container/vector.hpp>
 #include <boost/mp11/list.hpp>
 
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/reuse.hpp>
+#include <dplx/dp/decoder/std_string.hpp>
+
 #include "boost-test.hpp"
 #include "test_input_stream.hpp"
 #include "test_utils.hpp"
@@ -56,6 +63,10 @@ static_assert(dp::associative_container<std::map<int, int>>);
 static_assert(dp::associative_container<std::unordered_map<int, int>>);
 static_assert(dp::associative_container<boost::container::map<int, int>>);
 static_assert(dp::associative_container<boost::container::flat_map<int, int>>);
+static_assert(
+        dp::sorted_vector_container<boost::container::flat_map<int, int>>);
+static_assert(dp::sorted_vector_container<boost::container::flat_set<int>>);
+static_assert(!dp::sorted_vector_container<std::map<int, int>>);
 
 static_assert(dp::decodable<std::deque<int>, test_input_stream>);
 static_assert(dp::decodable<std::list<int>, test_input_stream>);
@@ -364,6 +375,294 @@ BOOST_AUTO_TEST_CASE(span_int_one_element_indefinite)
 
 #endif
 
+// any allocation from the default resource fails while the guard is alive
+class null_default_resource_guard
+{
+    std::pmr::memory_resource *mPrevious;
+
+public:
+    null_default_resource_guard() noexcept
+        : mPrevious(std::pmr::set_default_resource(
+                std::pmr::null_memory_resource()))
+    {
+    }
+    ~null_default_resource_guard()
+    {
+        std::pmr::set_default_resource(mPrevious);
+    }
+    null_default_resource_guard(null_default_resource_guard const &) = delete;
+    auto operator=(null_default_resource_guard const &)
+            -> null_default_resource_guard & = delete;
+};
+
+BOOST_AUTO_TEST_CASE(pmr_map_allocates_from_its_resource)
+{
+    // {"a key which isn't a short string": ["a value which isn't short"]}
+    std::u8string_view const key = u8"a key which isn't a short string";
+    std::u8string_view const element = u8"a value which isn't short";
+
+    std::vector<std::byte> serializedInput;
+    serializedInput.push_back(std::byte{0xa1});
+    serializedInput.push_back(std::byte{0x78});
+    serializedInput.push_back(static_cast<std::byte>(key.size()));
+    for (auto c : key)
+    {
+        serializedInput.push_back(static_cast<std::byte>(c));
+    }
+    serializedInput.push_back(std::byte{0x81});
+    serializedInput.push_back(std::byte{0x78});
+    serializedInput.push_back(static_cast<std::byte>(element.size()));
+    for (auto c : element)
+    {
+        serializedInput.push_back(static_cast<std::byte>(c));
+    }
+    test_input_stream stream{byte_span(serializedInput)};
+
+    std::array<std::byte, 4096> arenaMemory;
+    std::pmr::monotonic_buffer_resource arena(arenaMemory.data(),
+                                              arenaMemory.size(),
+                                              std::pmr::null_memory_resource());
+
+    using value_type = std::pmr::map<std::pmr::u8string,
+                                     std::pmr::vector<std::pmr::u8string>>;
+    value_type out(&arena);
+    {
+        null_default_resource_guard guard;
+        DPLX_REQUIRE_RESULT(
+                (dp::basic_decoder<value_type, test_input_stream>()(stream,
+                                                                    out)));
+    }
+
+    BOOST_TEST_REQUIRE(out.size() == 1u);
+    auto const &[k, m] = *out.begin();
+    BOOST_TEST((k == key));
+    BOOST_TEST(k.get_allocator().resource() == &arena);
+    BOOST_TEST_REQUIRE(m.size() == 1u);
+    BOOST_TEST((m[0] == element));
+    BOOST_TEST(m[0].get_allocator().resource() == &arena);
+}
+
+BOOST_AUTO_TEST_CASE(pmr_set_allocates_from_its_resource)
+{
+    std::u8string_view const element = u8"a value which isn't short";
+
+    std::vector<std::byte> serializedInput;
+    serializedInput.push_back(std::byte{0x81});
+    serializedInput.push_back(std::byte{0x78});
+    serializedInput.push_back(static_cast<std::byte>(element.size()));
+    for (auto c : element)
+    {
+        serializedInput.push_back(static_cast<std::byte>(c));
+    }
+    test_input_stream stream{byte_span(serializedInput)};
+
+    std::array<std::byte, 4096> arenaMemory;
+    std::pmr::monotonic_buffer_resource arena(arenaMemory.data(),
+                                              arenaMemory.size(),
+                                              std::pmr::null_memory_resource());
+
+    using value_type = std::pmr::set<std::pmr::u8string>;
+    value_type out(&arena);
+    {
+        null_default_resource_guard guard;
+        DPLX_REQUIRE_RESULT(
+                (dp::basic_decoder<value_type, test_input_stream>()(stream,
+                                                                    out)));
+    }
+
+    BOOST_TEST_REQUIRE(out.size() == 1u);
+    BOOST_TEST((*out.begin() == element));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(reuse_overwrites_and_truncates,
+                              T,
+                              uint_sequence_containers)
+{
+    auto serializedInput = make_byte_array<12>({0b100'00001, 0x01});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    T out{5u, 6u, 7u};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(stream, out));
+
+    BOOST_TEST_REQUIRE(out.size() == 1u);
+    BOOST_TEST(out.front() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(reuse_appends_missing_elements,
+                              T,
+                              uint_sequence_containers)
+{
+    auto serializedInput = make_byte_array<12>(
+            {0b100'11111, 0x01, 0x02, 0x03, 0xFF});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    T out{7u};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(stream, out));
+
+    T const expected{1u, 2u, 3u};
+    BOOST_TEST(out == expected, boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(reuse_retains_nested_capacity)
+{
+    // ["a", "bc"]
+    auto serializedInput
+            = make_byte_array<12>({0x82, 0x61, 0x61, 0x62, 0x62, 0x63});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    std::vector<std::u8string> out{u8"a rather long string of text",
+                                   u8"another long string of text",
+                                   u8"and a third one"};
+    auto const *const elements = out.data();
+    auto const *const firstString = out[0].data();
+
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(stream, out));
+
+    BOOST_TEST_REQUIRE(out.size() == 2u);
+    BOOST_TEST((out[0] == u8"a"));
+    BOOST_TEST((out[1] == u8"bc"));
+    BOOST_TEST(out.data() == elements);
+    BOOST_TEST(static_cast<void const *>(out[0].data())
+               == static_cast<void const *>(firstString));
+}
+
+// counts the allocations which are forwarded to the new_delete_resource
+class counting_resource final : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0u;
+
+private:
+    auto do_allocate(std::size_t bytes, std::size_t alignment)
+            -> void * override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p,
+                       std::size_t bytes,
+                       std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    auto do_is_equal(std::pmr::memory_resource const &other) const noexcept
+            -> bool override
+    {
+        return this == &other;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(reuse_recycles_map_nodes)
+{
+    // {1: "a long enough text", 2: "and another text!!"}
+    auto first = make_byte_array<48, int>(
+            {0xa2, 0x01, 0x72, 'a',  ' ', 'l', 'o', 'n', 'g', ' ', 'e',
+             'n',  'o',  'u',  'g',  'h', ' ', 't', 'e', 'x', 't', 0x02,
+             0x72, 'a',  'n',  'd',  ' ', 'a', 'n', 'o', 't', 'h', 'e',
+             'r',  ' ',  't',  'e',  'x', 't', '!', '!'});
+    // {3: "short", 4: "texts"}
+    auto second = make_byte_array<16, int>({0xa2, 0x03, 0x65, 's', 'h',
+                                            'o', 'r', 't', 0x04, 0x65, 't',
+                                            'e', 'x', 't', 's'});
+
+    counting_resource memory;
+    std::pmr::map<unsigned, std::pmr::u8string> out(&memory);
+
+    test_input_stream firstStream{byte_span(first)};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(firstStream, out));
+    BOOST_TEST(out.size() == 2u);
+    auto const numAllocations = memory.allocations;
+
+    test_input_stream secondStream{byte_span(second)};
+    DPLX_REQUIRE_RESULT(dp::decode_reuse(secondStream, out));
+    BOOST_TEST(memory.allocations == numAllocations);
+
+    BOOST_TEST_REQUIRE(out.size() == 2u);
+    BOOST_TEST(out.count(1u) == 0u);
+    BOOST_TEST((out[3u] == u8"short"));
+    BOOST_TEST((out[4u] == u8"texts"));
+}
+
+BOOST_AUTO_TEST_CASE(reuse_rejects_duplicate_keys)
+{
+    // {1: 1, 1: 2}
+    auto serializedInput
+            = make_byte_array<12>({0xa2, 0x01, 0x01, 0x01, 0x02});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    std::map<unsigned, unsigned> out{{5u, 5u}, {6u, 6u}};
+    auto rx = dp::decode_reuse(stream, out);
+    BOOST_TEST(rx.error() == dp::errc::duplicate_key);
+}
+
+BOOST_AUTO_TEST_CASE(map_rejects_duplicate_keys)
+{
+    // {1: 1, 1: 2}
+    auto serializedInput
+            = make_byte_array<12>({0xa2, 0x01, 0x01, 0x01, 0x02});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    std::map<unsigned, unsigned> out;
+    auto rx = dp::decode(stream, out);
+    BOOST_TEST(rx.error() == dp::errc::duplicate_key);
+}
+
+using flat_map_type = boost::container::flat_map<unsigned, unsigned>;
+
+BOOST_AUTO_TEST_CASE(flat_map_sorted)
+{
+    // {1: 4, 2: 5, 3: 6}
+    auto serializedInput = make_byte_array<12>(
+            {0xa3, 0x01, 0x04, 0x02, 0x05, 0x03, 0x06});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    flat_map_type out{{7u, 7u}};
+    DPLX_REQUIRE_RESULT(dp::decode(stream, out));
+
+    flat_map_type const expected{{1u, 4u}, {2u, 5u}, {3u, 6u}};
+    BOOST_TEST((out == expected));
+}
+
+BOOST_AUTO_TEST_CASE(flat_map_unsorted)
+{
+    // {3: 6, 1: 4, 2: 5}
+    auto serializedInput = make_byte_array<12>(
+            {0xa3, 0x03, 0x06, 0x01, 0x04, 0x02, 0x05});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    flat_map_type out;
+    DPLX_REQUIRE_RESULT(dp::decode(stream, out));
+
+    flat_map_type const expected{{1u, 4u}, {2u, 5u}, {3u, 6u}};
+    BOOST_TEST((out == expected));
+}
+
+BOOST_AUTO_TEST_CASE(flat_map_rejects_duplicate_keys)
+{
+    // {2: 1, 1: 2, 2: 3}
+    auto serializedInput = make_byte_array<12>(
+            {0xa3, 0x02, 0x01, 0x01, 0x02, 0x02, 0x03});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    flat_map_type out;
+    auto rx = dp::decode(stream, out);
+    BOOST_TEST(rx.error() == dp::errc::duplicate_key);
+}
+
+BOOST_AUTO_TEST_CASE(flat_set_indefinite)
+{
+    // [_ 1, 2, 3]
+    auto serializedInput
+            = make_byte_array<12>({0x9f, 0x01, 0x02, 0x03, 0xff});
+    test_input_stream stream{byte_span(serializedInput)};
+
+    boost::container::flat_set<unsigned> out;
+    DPLX_REQUIRE_RESULT(dp::decode(stream, out));
+
+    boost::container::flat_set<unsigned> const expected{1u, 2u, 3u};
+    BOOST_TEST((out == expected));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
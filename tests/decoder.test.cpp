@@ -6,7 +6,18 @@
 //           https://www.boost.org/LICENSE_1_0.txt)
 
 #include <dplx/dp/decoder/api.hpp>
+
+#include <string>
+#include <variant>
+#include <vector>
+
 #include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/std_string.hpp>
+#include <dplx/dp/decoder/variant.hpp>
+#include <dplx/dp/streams/recording_input_stream.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+#include <dplx/dp/stringref.hpp>
 
 #include "boost-test.hpp"
 #include "test_input_stream.hpp"
@@ -42,6 +53,78 @@ BOOST_AUTO_TEST_CASE(int_decode_value)
     BOOST_TEST(rx.assume_value() == 0x16);
 }
 
+BOOST_AUTO_TEST_CASE(try_decode_rewinds_on_failure)
+{
+    auto bytes = make_byte_array<2>({0xf5, 0x16});
+    test_input_stream istream(bytes);
+
+    int out{};
+    auto failedRx = dp::try_decode(istream, out);
+    BOOST_TEST_REQUIRE(failedRx.has_error());
+    BOOST_TEST(failedRx.assume_error() == dp::errc::item_type_mismatch);
+
+    bool flag{};
+    DPLX_REQUIRE_RESULT(dp::try_decode(istream, flag));
+    BOOST_TEST(flag);
+    DPLX_REQUIRE_RESULT(dp::try_decode(istream, out));
+    BOOST_TEST(out == 0x16);
+}
+
+// arbitrary states can't be rolled back
+using int_state_stream = dp::stateful_stream<test_input_stream, int>;
+static_assert(!dp::rewindable_input_stream<int_state_stream>);
+
+using stringref_stream
+        = dp::stateful_stream<test_input_stream, dp::stringref_dictionary>;
+static_assert(dp::rewindable_input_stream<stringref_stream>);
+
+BOOST_AUTO_TEST_CASE(try_decode_rewinds_the_stream_state)
+{
+    // ["hello", 2], "world", 25(1)
+    auto bytes = make_byte_array<17, int>(
+            {0x82, 0x65, 'h', 'e', 'l', 'l',  'o',  0x02, 0x65,
+             'w',  'o',  'r', 'l', 'd', 0xd8, 0x19, 0x01});
+    test_input_stream istream(bytes);
+    dp::stringref_dictionary dictionary;
+    stringref_stream stringrefStream(istream, dictionary);
+
+    std::vector<std::u8string> strings;
+    auto failedRx = dp::try_decode(stringrefStream, strings);
+    BOOST_TEST_REQUIRE(failedRx.has_error());
+    BOOST_TEST(failedRx.assume_error() == dp::errc::item_type_mismatch);
+    BOOST_TEST(dictionary.size() == 0u);
+
+    std::vector<std::variant<std::u8string, int>> items;
+    DPLX_REQUIRE_RESULT(dp::try_decode(stringrefStream, items));
+    BOOST_TEST_REQUIRE(items.size() == 2u);
+    BOOST_TEST((std::get<std::u8string>(items[0]) == u8"hello"));
+    BOOST_TEST(std::get<int>(items[1]) == 2);
+
+    std::u8string world;
+    DPLX_REQUIRE_RESULT(dp::decode(stringrefStream, world));
+    std::u8string reference;
+    DPLX_REQUIRE_RESULT(dp::decode(stringrefStream, reference));
+    BOOST_TEST((reference == u8"world"));
+}
+
+BOOST_AUTO_TEST_CASE(try_decode_rewinds_the_recording)
+{
+    auto bytes = make_byte_array<2>({0xf5, 0x16});
+    test_input_stream istream(bytes);
+    std::vector<std::byte> recording;
+    dp::recording_input_stream recordingStream(istream, recording);
+
+    int out{};
+    auto failedRx = dp::try_decode(recordingStream, out);
+    BOOST_TEST_REQUIRE(failedRx.has_error());
+    BOOST_TEST(recording.empty());
+
+    bool flag{};
+    DPLX_REQUIRE_RESULT(dp::try_decode(recordingStream, flag));
+    BOOST_TEST(flag);
+    BOOST_TEST(recording.size() == 1u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
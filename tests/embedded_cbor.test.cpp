@@ -0,0 +1,286 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/embedded_cbor.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/embedded_cbor.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/std_string.hpp>
+#include <dplx/dp/decoder/stringref.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/decoder/value_sharing.hpp>
+#include <dplx/dp/decoder/variant.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/embedded_cbor.hpp>
+#include <dplx/dp/encoder/encoded_size_memo.hpp>
+#include <dplx/dp/encoder/stringref.hpp>
+#include <dplx/dp/encoder/to_memory.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+#include <dplx/dp/encoder/value_sharing.hpp>
+#include <dplx/dp/encoder/variant.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(embedded_cbor)
+
+struct envelope
+{
+    std::uint32_t kind;
+    dp::embedded_cbor<std::vector<std::uint32_t>> payload;
+
+    static constexpr dp::tuple_def<dp::tuple_member_def<&envelope::kind>{},
+                                   dp::tuple_member_def<&envelope::payload>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(encoded_size_of_includes_tag_and_byte_string_head)
+{
+    dp::embedded_cbor<std::vector<std::uint32_t>> const value{{1u, 0x100u}};
+
+    // 0xd8 0x18 0x45 [0x82 0x01 0x19 0x01 0x00]
+    BOOST_TEST(dp::encoded_size_of(value) == 2u + 1u + 5u);
+
+    dp::encoded_size_memo memo;
+    BOOST_TEST(dp::encoded_size_of(value, memo) == 2u + 1u + 5u);
+    BOOST_TEST(memo.size() == 1u);
+    BOOST_TEST(memo.next(&value.value) == 5u);
+}
+
+BOOST_AUTO_TEST_CASE(memo_slots_are_reserved_in_pre_order)
+{
+    using inner_type = dp::embedded_cbor<std::uint32_t>;
+    dp::embedded_cbor<std::vector<inner_type>> const value{
+            {inner_type{1u}, inner_type{0x100u}}};
+
+    dp::encoded_size_memo memo;
+    BOOST_TEST(dp::encoded_size_of(value) == dp::encoded_size_of(value, memo));
+    BOOST_TEST(memo.size() == 3u);
+    BOOST_TEST(memo.next(&value.value) == 1u + (3u + 1u) + (3u + 3u));
+    BOOST_TEST(memo.next(&value.value[0].value) == 1u);
+    BOOST_TEST(memo.next(&value.value[1].value) == 3u);
+    BOOST_TEST(memo.next(&value.value) == dp::encoded_size_memo::npos);
+
+    memo.rewind();
+    // slots reserved for other items aren't consumed
+    BOOST_TEST(memo.next(&value.value[1].value)
+               == dp::encoded_size_memo::npos);
+    BOOST_TEST(memo.next(&value.value) == 1u + (3u + 1u) + (3u + 3u));
+
+    memo.clear();
+    BOOST_TEST(memo.size() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(non_memoized_values_dont_use_slots)
+{
+    std::vector<std::uint32_t> const value{1u, 2u, 3u};
+
+    dp::encoded_size_memo memo;
+    BOOST_TEST(dp::encoded_size_of(value, memo) == dp::encoded_size_of(value));
+    BOOST_TEST(memo.size() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(encode_without_memo)
+{
+    auto bytes = make_byte_array<10>(
+            {0x82, 0x07, 0xd8, 0x18, 0x45, 0x82, 0x01, 0x19, 0x01, 0x00});
+    envelope const value{7u, {{1u, 0x100u}}};
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, value));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_with_memo_attached_to_the_stream)
+{
+    auto bytes = make_byte_array<10>(
+            {0x82, 0x07, 0xd8, 0x18, 0x45, 0x82, 0x01, 0x19, 0x01, 0x00});
+    envelope const value{7u, {{1u, 0x100u}}};
+
+    dp::encoded_size_memo memo;
+    BOOST_TEST(dp::encoded_size_of(value, memo) == bytes.size());
+
+    test_output_stream<> ostream{};
+    dp::stateful_stream<test_output_stream<>, dp::encoded_size_memo>
+            memoizedStream{ostream, memo};
+    static_assert(dp::has_stream_state<decltype(memoizedStream),
+                                       dp::encoded_size_memo>);
+    DPLX_REQUIRE_RESULT(dp::encode(memoizedStream, value));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_nested_to_vector)
+{
+    auto bytes = make_byte_array<10>(
+            {0xd8, 0x18, 0x47, 0x82, 0x07, 0xd8, 0x18, 0x42, 0x81, 0x01});
+    dp::embedded_cbor<envelope> const value{envelope{7u, {{1u}}}};
+
+    auto rx = dp::encode_to_vector(value);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == std::span(rx.assume_value()),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_within_optional_to_vector)
+{
+    // 24(h'07')
+    auto bytes = make_byte_array<4>({0xd8, 0x18, 0x41, 0x07});
+    std::optional<dp::embedded_cbor<int>> const value{
+            dp::embedded_cbor<int>{7}};
+
+    auto rx = dp::encode_to_vector(value);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == std::span(rx.assume_value()),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_within_variant_to_vector)
+{
+    // 24(h'83 00 d81841 07 d81842 1864') i.e. 24([0, 24(h'07'), 24(h'1864')])
+    auto bytes = make_byte_array<14>({0xd8, 0x18, 0x4b, 0x83, 0x00, 0xd8, 0x18,
+                                      0x41, 0x07, 0xd8, 0x18, 0x42, 0x18,
+                                      0x64});
+    using variant_type = std::variant<std::uint32_t, dp::embedded_cbor<int>>;
+    // only the outermost item is memoized, because the variant encoder
+    // doesn't forward the memo
+    dp::embedded_cbor<std::vector<variant_type>> const value{
+            {variant_type{0u}, variant_type{dp::embedded_cbor<int>{7}},
+             variant_type{dp::embedded_cbor<int>{100}}}};
+
+    auto rx = dp::encode_to_vector(value);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == std::span(rx.assume_value()),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_within_shared_ptrs_to_vector)
+{
+    // [24(h'07'), 24(h'1864')]
+    auto bytes = make_byte_array<10>(
+            {0x82, 0xd8, 0x18, 0x41, 0x07, 0xd8, 0x18, 0x42, 0x18, 0x64});
+    std::vector<std::shared_ptr<dp::embedded_cbor<int>>> const value{
+            std::make_shared<dp::embedded_cbor<int>>(7),
+            std::make_shared<dp::embedded_cbor<int>>(100)};
+
+    auto rx = dp::encode_to_vector(value);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == std::span(rx.assume_value()),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(embedded_items_dont_share_values_with_the_outer_item)
+{
+    // [24(h'07'), 24(h'07')]
+    auto bytes = make_byte_array<9>(
+            {0x82, 0xd8, 0x18, 0x41, 0x07, 0xd8, 0x18, 0x41, 0x07});
+    using embedded_type = dp::embedded_cbor<std::shared_ptr<int>>;
+    auto const shared = std::make_shared<int>(7);
+    std::vector<embedded_type> const value{embedded_type{shared},
+                                           embedded_type{shared}};
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode_sharing(ostream, value));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+
+    test_input_stream istream{std::span(bytes)};
+    std::vector<embedded_type> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_sharing(istream, decoded));
+    BOOST_TEST_REQUIRE(decoded.size() == 2u);
+    BOOST_TEST(*decoded[0].value == 7);
+    BOOST_TEST(*decoded[1].value == 7);
+}
+
+BOOST_AUTO_TEST_CASE(embedded_items_dont_refer_to_outer_strings)
+{
+    // 256([24(h'6568656c6c6f'), 24(h'6568656c6c6f')])
+    auto bytes = make_byte_array<22, int>(
+            {0xd9, 0x01, 0x00, 0x82, 0xd8, 0x18, 0x46, 0x65,
+             'h',  'e',  'l',  'l',  'o',  0xd8, 0x18, 0x46,
+             0x65, 'h',  'e',  'l',  'l',  'o'});
+    using embedded_type = dp::embedded_cbor<std::u8string>;
+    std::vector<embedded_type> const value{embedded_type{u8"hello"},
+                                           embedded_type{u8"hello"}};
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(ostream, value));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+
+    test_input_stream istream{std::span(bytes)};
+    std::vector<embedded_type> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(istream, decoded));
+    BOOST_TEST_REQUIRE(decoded.size() == 2u);
+    BOOST_TEST((decoded[0].value == u8"hello"));
+    BOOST_TEST((decoded[1].value == u8"hello"));
+}
+
+BOOST_AUTO_TEST_CASE(decode_roundtrip)
+{
+    auto bytes = make_byte_array<32>(
+            {0x82, 0x07, 0xd8, 0x18, 0x45, 0x82, 0x01, 0x19, 0x01, 0x00});
+    test_input_stream istream{bytes};
+
+    envelope value{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, value));
+
+    BOOST_TEST(value.kind == 7u);
+    BOOST_TEST(value.payload.value == (std::vector<std::uint32_t>{1u, 0x100u}),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::available_input_size(istream).value() == 32u - 10u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_byte_string_size_mismatch)
+{
+    auto bytes = make_byte_array<32>(
+            {0xd8, 0x18, 0x46, 0x82, 0x01, 0x19, 0x01, 0x00, 0x00});
+    test_input_stream istream{bytes};
+
+    dp::embedded_cbor<std::vector<std::uint32_t>> value{};
+    auto rx = dp::decode(istream, value);
+
+    BOOST_TEST(rx.error() == dp::errc::item_value_out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_missing_tag)
+{
+    auto bytes = make_byte_array<32>({0x45, 0x82, 0x01, 0x19, 0x01, 0x00});
+    test_input_stream istream{bytes};
+
+    dp::embedded_cbor<std::vector<std::uint32_t>> value{};
+    auto rx = dp::decode(istream, value);
+
+    BOOST_TEST(rx.error() == dp::errc::item_type_mismatch);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
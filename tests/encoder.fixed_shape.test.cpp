@@ -0,0 +1,194 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/encoder/fixed_shape.hpp>
+
+#include <array>
+#include <vector>
+
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/object_utils.hpp>
+#include <dplx/dp/encoder/to_memory.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+#include <dplx/dp/streams/memory_output_stream.hpp>
+
+#include "boost-test.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+struct wide_record
+{
+    std::uint64_t a;
+    std::uint64_t b;
+    std::uint64_t c;
+    std::uint64_t d;
+    std::uint64_t e;
+
+    static constexpr dp::tuple_def<dp::tuple_member_def<&wide_record::a>{},
+                                   dp::tuple_member_def<&wide_record::b>{},
+                                   dp::tuple_member_def<&wide_record::c>{},
+                                   dp::tuple_member_def<&wide_record::d>{},
+                                   dp::tuple_member_def<&wide_record::e>{}>
+            layout_descriptor{};
+};
+
+} // namespace dp_tests
+
+template <>
+inline constexpr std::size_t
+        dplx::dp::single_reservation_encoding_limit<dp_tests::wide_record>
+        = 64u;
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(encoder)
+
+BOOST_AUTO_TEST_SUITE(fixed_shape)
+
+using dp::max_encoded_size_of_v;
+
+enum class fixed_shape_enum : std::int16_t
+{
+};
+
+static_assert(max_encoded_size_of_v<bool> == 1u);
+static_assert(max_encoded_size_of_v<std::uint8_t> == 2u);
+static_assert(max_encoded_size_of_v<std::int32_t> == 5u);
+static_assert(max_encoded_size_of_v<std::uint64_t> == 9u);
+static_assert(max_encoded_size_of_v<float> == 5u);
+static_assert(max_encoded_size_of_v<double> == 9u);
+static_assert(max_encoded_size_of_v<fixed_shape_enum> == 3u);
+static_assert(max_encoded_size_of_v<dp::fixed_u8string<30>> == 32u);
+static_assert(max_encoded_size_of_v<std::array<std::uint16_t, 4>> == 13u);
+static_assert(max_encoded_size_of_v<std::array<std::byte, 24>> == 26u);
+
+static_assert(!dp::bounded_encoded_size<std::vector<int>>);
+static_assert(!dp::bounded_encoded_size<std::u8string>);
+
+struct telemetry_record
+{
+    std::uint64_t timestamp;
+    std::uint32_t sensor;
+    float value;
+    bool valid;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&telemetry_record::timestamp>{},
+            dp::tuple_member_def<&telemetry_record::sensor>{},
+            dp::tuple_member_def<&telemetry_record::value>{},
+            dp::tuple_member_def<&telemetry_record::valid>{}>
+            layout_descriptor{};
+};
+static_assert(max_encoded_size_of_v<telemetry_record> == 1u + 9u + 5u + 5u
+                                                                 + 1u);
+static_assert(dp::single_reservation_encodable<telemetry_record>);
+
+struct named_record
+{
+    std::uint8_t kind;
+    std::array<std::int16_t, 2> position;
+
+    static constexpr dp::object_def<
+            dp::named_property_def<u8"kind", &named_record::kind>{},
+            dp::named_property_def<u8"pos", &named_record::position>{}>
+            layout_descriptor{.version = 3};
+};
+static_assert(max_encoded_size_of_v<named_record>
+              == 3u + 5u + 2u + 4u + 7u);
+
+struct unbounded_record
+{
+    std::uint32_t id;
+    std::vector<std::uint32_t> values;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&unbounded_record::id>{},
+            dp::tuple_member_def<&unbounded_record::values>{}>
+            layout_descriptor{};
+};
+static_assert(!dp::bounded_encoded_size<unbounded_record>);
+
+BOOST_AUTO_TEST_CASE(tuple_uses_a_single_reservation)
+{
+    auto bytes = make_byte_array<12>({0x84, 0x19, 0x01, 0x00, 0x07, 0xfa, 0x3f,
+                                      0xc0, 0x00, 0x00, 0xf5});
+    telemetry_record const record{0x100u, 7u, 1.5f, true};
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, record));
+
+    BOOST_TEST(ostream.write_counter() == 1);
+    BOOST_TEST(byte_span(bytes).first(11) == byte_span(ostream),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(record) == 11u);
+}
+
+BOOST_AUTO_TEST_CASE(object_uses_a_single_reservation)
+{
+    auto bytes = make_byte_array<19, int>(
+            {0xa3, 0x00, 0x03, 0x64, 'k', 'i', 'n', 'd', 0x18, 0xff, 0x63, 'p',
+             'o', 's', 0x82, 0x01, 0x39, 0x01, 0x00});
+    named_record const record{0xffu, {1, -0x101}};
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, record));
+
+    BOOST_TEST(ostream.write_counter() == 1);
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(record) == bytes.size());
+}
+
+BOOST_AUTO_TEST_CASE(falls_back_near_the_end_of_a_buffer)
+{
+    auto bytes = make_byte_array<5>({0x84, 0x00, 0x00, 0xfa, 0x00});
+    telemetry_record const record{0u, 0u, 0.0f, false};
+
+    // the encoded record occupies 9 bytes which is less than its maximum
+    std::array<std::byte, 9> storage{};
+    dp::memory_buffer buffer{std::span<std::byte>(storage)};
+
+    DPLX_REQUIRE_RESULT(dp::encode(buffer, record));
+
+    BOOST_TEST(buffer.remaining_size() == 0u);
+    BOOST_TEST(byte_span(bytes) == byte_span(storage).first(5),
+               boost::test_tools::per_element{});
+    BOOST_TEST(storage[8] == std::byte{0xf4});
+}
+
+static_assert(max_encoded_size_of_v<wide_record> == 1u + 5u * 9u);
+static_assert(dp::single_reservation_encodable<wide_record>);
+static_assert(
+        dp::single_reservation_encodable_to<wide_record, test_output_stream<>>);
+// exceeds the padding of unchecked memory buffers
+static_assert(!dp::single_reservation_encodable_to<wide_record,
+                                                   dp::memoized_memory_buffer>);
+
+BOOST_AUTO_TEST_CASE(raised_limit_is_capped_by_unchecked_output_padding)
+{
+    auto bytes
+            = make_byte_array<7>({0x85, 0x00, 0x01, 0x02, 0x18, 0xff, 0x03});
+    wide_record const record{0u, 1u, 2u, 0xffu, 3u};
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, record));
+    BOOST_TEST(ostream.write_counter() == 1);
+
+    auto rx = dp::encode_to_vector(record);
+    DPLX_REQUIRE_RESULT(rx);
+    BOOST_TEST(byte_span(bytes) == std::span(rx.assume_value()),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -224,6 +224,236 @@ BOOST_AUTO_TEST_CASE(custom_with_named_layout_descriptor_encoding)
                boost::test_tools::per_element{});
 }
 
+class versioned_with_layout_descriptor
+{
+public:
+    std::uint32_t ma;
+    std::uint32_t mb;
+
+    static constexpr object_def<
+            property_def<1, &versioned_with_layout_descriptor::ma>{},
+            property_def<300, &versioned_with_layout_descriptor::mb>{}>
+            layout_descriptor{.version = 0x17};
+};
+static_assert(dp::packable_object<versioned_with_layout_descriptor>);
+
+BOOST_AUTO_TEST_CASE(versioned_with_layout_descriptor_encoding)
+{
+    auto bytes = make_byte_array<10>(
+            {0b101'00000 | 3, 0, 0x17, 1, 0x07, 0x19, 0x01, 0x2c, 0x18, 0x2a});
+
+    test_output_stream ostream{};
+
+    versioned_with_layout_descriptor const t{0x07, 0x2a};
+    auto rx = dp::encode(ostream, t);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(t) == bytes.size());
+}
+
+BOOST_AUTO_TEST_CASE(versioned_with_layout_descriptor_runtime_version_encoding)
+{
+    auto bytes = make_byte_array<11>({0b101'00000 | 3, 0, 0x18, 0x2b, 1, 0x07,
+                                      0x19, 0x01, 0x2c, 0x18, 0x2a});
+
+    test_output_stream ostream{};
+
+    versioned_with_layout_descriptor const t{0x07, 0x2a};
+    auto rx = dp::encode_object<
+            versioned_with_layout_descriptor::layout_descriptor>(ostream, t,
+                                                                 0x2bu);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+struct sparse_object
+{
+    std::uint32_t ma;
+    std::uint32_t mb;
+    std::uint32_t mc;
+};
+
+struct presence_bitmap_object : sparse_object
+{
+    static constexpr object_def<
+            property_def<1, &presence_bitmap_object::ma>{},
+            property_def<2, &presence_bitmap_object::mb>{false},
+            property_def<3, &presence_bitmap_object::mc>{false}>
+            layout_descriptor{.encoding = dp::object_encoding::presence_bitmap};
+};
+static_assert(!dp::bounded_encoded_size<presence_bitmap_object>);
+
+struct versioned_presence_bitmap_object : sparse_object
+{
+    static constexpr object_def<
+            property_def<1, &versioned_presence_bitmap_object::ma>{},
+            property_def<2, &versioned_presence_bitmap_object::mb>{false},
+            property_def<3, &versioned_presence_bitmap_object::mc>{false}>
+            layout_descriptor{.version = 2,
+                              .encoding = dp::object_encoding::presence_bitmap};
+};
+
+struct sparse_map_object : sparse_object
+{
+    static constexpr object_def<
+            property_def<1, &sparse_map_object::ma>{},
+            property_def<2, &sparse_map_object::mb>{false},
+            property_def<3, &sparse_map_object::mc>{false}>
+            layout_descriptor{.encoding = dp::object_encoding::sparse_map};
+};
+static_assert(!dp::bounded_encoded_size<sparse_map_object>);
+
+BOOST_AUTO_TEST_CASE(presence_bitmap_encoding)
+{
+    auto bytes = make_byte_array<4>({0b100'00000 | 3, 0b101, 0x07, 0x05});
+
+    test_output_stream ostream{};
+
+    presence_bitmap_object const t{{0x07, 0, 0x05}};
+    auto rx = dp::encode(ostream, t);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(t) == bytes.size());
+}
+
+BOOST_AUTO_TEST_CASE(versioned_presence_bitmap_encoding)
+{
+    auto bytes = make_byte_array<7>(
+            {0b100'00000 | 5, 0x02, 0b111, 0x07, 0x18, 0x2a, 0x05});
+
+    test_output_stream ostream{};
+
+    versioned_presence_bitmap_object const t{{0x07, 0x2a, 0x05}};
+    auto rx = dp::encode(ostream, t);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(t) == bytes.size());
+}
+
+BOOST_AUTO_TEST_CASE(sparse_map_encoding)
+{
+    auto bytes = make_byte_array<5>({0b101'00000 | 2, 1, 0x07, 3, 0x05});
+
+    test_output_stream ostream{};
+
+    sparse_map_object const t{{0x07, 0, 0x05}};
+    auto rx = dp::encode(ostream, t);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(t) == bytes.size());
+}
+
+BOOST_AUTO_TEST_CASE(sparse_map_runtime_version_encoding)
+{
+    auto bytes = make_byte_array<7>(
+            {0b101'00000 | 3, 0, 0x04, 1, 0x07, 2, 0x01});
+
+    test_output_stream ostream{};
+
+    sparse_map_object const t{{0x07, 0x01, 0}};
+    auto rx = dp::encode_object<sparse_map_object::layout_descriptor>(
+            ostream, t, 0x04u);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+struct aliased_object
+{
+    std::uint32_t ma;
+    std::uint32_t mb;
+
+    static constexpr object_def<
+            dp::aliased_property_def<u8"alpha", 1, &aliased_object::ma>{},
+            dp::aliased_property_def<u8"beta", 40, &aliased_object::mb>{}>
+            layout_descriptor{.use_property_aliases = true};
+};
+static_assert(dp::single_reservation_encodable<aliased_object>);
+static_assert(decltype(aliased_object::layout_descriptor)::integer_keys
+              == std::array<std::uint32_t, 2>{1u, 40u});
+static_assert(!decltype(aliased_object::layout_descriptor)::claims_version_key);
+static_assert(object_def<dp::aliased_property_def<u8"alpha",
+                                                  0,
+                                                  &aliased_object::ma>{}>::
+                      claims_version_key);
+static_assert(dp::detail::has_duplicates(std::array{1u, 40u, 1u}));
+static_assert(!dp::detail::has_duplicates(std::array{1u, 40u, 2u}));
+
+BOOST_AUTO_TEST_CASE(aliased_property_encoding)
+{
+    auto bytes = make_byte_array<6>({0b101'00000 | 2, 1, 0x07, 0x18, 40, 0x05});
+
+    test_output_stream ostream{};
+
+    aliased_object const t{0x07, 0x05};
+    auto rx = dp::encode(ostream, t);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(t) == bytes.size());
+}
+
+struct aliased_object_with_names : aliased_object
+{
+    static constexpr object_def<
+            dp::aliased_property_def<u8"alpha",
+                                     1,
+                                     &aliased_object_with_names::ma>{},
+            dp::aliased_property_def<u8"beta",
+                                     40,
+                                     &aliased_object_with_names::mb>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(aliased_property_name_encoding)
+{
+    auto bytes = make_byte_array<13, int>({0b101'00000 | 2, 0x65, 'a', 'l', 'p',
+                                           'h', 'a', 0x07, 0x64, 'b', 'e', 't',
+                                           'a'});
+
+    test_output_stream ostream{};
+
+    aliased_object_with_names const t{{0x07, 0x05}};
+    auto rx = dp::encode(ostream, t);
+    DPLX_REQUIRE_RESULT(rx);
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream).first(bytes.size()),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(t) == bytes.size() + 1u);
+}
+
+BOOST_AUTO_TEST_CASE(pre_encoded_property_ids)
+{
+    using named_def = dp::detail::remove_cref_t<decltype(
+            custom_with_named_layout_descriptor::layout_descriptor
+                    .property<3>())>;
+    constexpr auto const &encodedNamedId
+            = dp::detail::encoded_property_id<named_def>;
+    static_assert(encodedNamedId.size() == 6u);
+    static_assert(encodedNamedId[0] == std::byte{0x65});
+    static_assert(encodedNamedId[5] == std::byte{'e'});
+
+    using int_def = dp::detail::remove_cref_t<decltype(
+            versioned_with_layout_descriptor::layout_descriptor.property<1>())>;
+    constexpr auto const &encodedIntId
+            = dp::detail::encoded_property_id<int_def>;
+    static_assert(encodedIntId.size() == 3u);
+    static_assert(encodedIntId[0] == std::byte{0x19});
+    static_assert(encodedIntId[2] == std::byte{0x2c});
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/encoder/to_memory.hpp>
+
+#include <string>
+#include <vector>
+
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+
+#include "boost-test.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(encoder)
+
+BOOST_AUTO_TEST_SUITE(to_memory)
+
+static_assert(std::same_as<decltype(dp::encoded_size_of(0)), std::uint64_t>);
+static_assert(std::same_as<decltype(dp::encoded_size_of(std::vector<int>{})),
+                           std::uint64_t>);
+
+struct sample_record
+{
+    std::uint32_t id;
+    std::vector<std::u8string> tags;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&sample_record::id>{},
+            dp::tuple_member_def<&sample_record::tags>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(encode_to_vector_uses_the_exact_size)
+{
+    auto bytes = make_byte_array<12, int>(
+            {0x82, 0x19, 0x01, 0x00, 0x82, 0x61, 'a', 0x64, 'b', 'c', 'd',
+             'e'});
+    sample_record const record{0x100u, {u8"a", u8"bcde"}};
+
+    auto rx = dp::encode_to_vector(record);
+    DPLX_REQUIRE_RESULT(rx);
+    auto const &encoded = rx.assume_value();
+
+    BOOST_TEST(encoded.size() == dp::encoded_size_of(record));
+    BOOST_TEST(encoded.capacity()
+               >= encoded.size() + dp::unchecked_output_padding);
+    BOOST_TEST(byte_span(bytes) == std::span(encoded),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_to_allocation_uses_the_exact_size)
+{
+    std::vector<std::uint64_t> const values{0u, 0xffu, 0xffff'ffff'ffu};
+    auto bytes = make_byte_array<13>({0x83, 0x00, 0x18, 0xff, 0x1b, 0x00, 0x00,
+                                      0x00, 0xff, 0xff, 0xff, 0xff, 0xff});
+
+    auto rx = dp::encode_to_allocation(values);
+    DPLX_REQUIRE_RESULT(rx);
+    auto const &encoded = rx.assume_value();
+
+    BOOST_TEST(encoded.size() == bytes.size());
+    BOOST_TEST(byte_span(bytes) == encoded.as_span(),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -0,0 +1,151 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/interned_string.hpp>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/interned_string.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/streams/stateful_stream.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(interned_string)
+
+using pool_stream = dp::stateful_stream<test_input_stream, dp::u8string_pool>;
+
+static_assert(dp::decodable<dp::interned_u8string, pool_stream>);
+static_assert(!dp::decodable<dp::interned_u8string, test_input_stream>);
+static_assert(dp::encodable<dp::interned_u8string, test_output_stream<>>);
+
+BOOST_AUTO_TEST_CASE(equal_strings_share_storage)
+{
+    dp::u8string_pool pool;
+    std::u8string const text = u8"a string which isn't short";
+
+    auto const first = pool.intern(text).value();
+    auto const second = pool.intern(std::u8string(text)).value();
+    auto const other = pool.intern(u8"another string").value();
+
+    BOOST_TEST((first.data() == second.data()));
+    BOOST_TEST((first.view() == text));
+    BOOST_TEST((first != other));
+    BOOST_TEST(pool.size() == 2u);
+
+    BOOST_TEST(pool.intern(u8"").value().empty());
+    BOOST_TEST(pool.size() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(pool_grows)
+{
+    dp::u8string_pool pool;
+    std::vector<dp::interned_u8string> strings;
+    for (std::size_t i = 0u; i < 1000u; ++i)
+    {
+        auto const str = std::to_string(i);
+        strings.push_back(
+                pool.intern(std::u8string(str.begin(), str.end())).value());
+    }
+    BOOST_TEST(pool.size() == 1000u);
+
+    for (std::size_t i = 0u; i < 1000u; ++i)
+    {
+        auto const str = std::to_string(i);
+        auto const interned
+                = pool.intern(std::u8string(str.begin(), str.end())).value();
+        BOOST_TEST((interned.data() == strings[i].data()));
+    }
+    BOOST_TEST(pool.size() == 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(pool_rewinds)
+{
+    auto const toU8 = [](std::size_t const i) {
+        auto const str = std::to_string(i);
+        return std::u8string(str.begin(), str.end());
+    };
+
+    dp::u8string_pool pool;
+    std::vector<dp::interned_u8string> strings;
+    for (std::size_t i = 0u; i < 40u; ++i)
+    {
+        strings.push_back(pool.intern(toU8(i)).value());
+    }
+    auto const cp = pool.checkpoint();
+    // enforces a rehash
+    for (std::size_t i = 40u; i < 1000u; ++i)
+    {
+        (void)pool.intern(toU8(i)).value();
+    }
+    pool.rewind(cp);
+    BOOST_TEST(pool.size() == 40u);
+
+    for (std::size_t i = 0u; i < 40u; ++i)
+    {
+        BOOST_TEST((pool.intern(toU8(i)).value().data() == strings[i].data()));
+    }
+    BOOST_TEST(pool.size() == 40u);
+    BOOST_TEST((pool.intern(toU8(40u)).value().view() == u8"40"));
+    BOOST_TEST(pool.size() == 41u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_map_keys)
+{
+    // [{"key": 1}, {"key": 2, "id": 3}]
+    auto bytes = make_byte_array<24, int>({0x82, 0xa1, 0x63, 'k', 'e', 'y',
+                                           0x01, 0xa2, 0x63, 'k', 'e', 'y',
+                                           0x02, 0x62, 'i', 'd', 0x03});
+    test_input_stream istream{byte_span(bytes)};
+    dp::u8string_pool pool;
+    pool_stream stream(istream, pool);
+
+    using record = std::unordered_map<dp::interned_u8string, int>;
+    std::vector<record> records;
+    DPLX_REQUIRE_RESULT(dp::decode(stream, records));
+
+    BOOST_TEST_REQUIRE(records.size() == 2u);
+    BOOST_TEST(pool.size() == 2u);
+    BOOST_TEST_REQUIRE(records[0].size() == 1u);
+    BOOST_TEST_REQUIRE(records[1].size() == 2u);
+
+    auto const &firstKey = records[0].begin()->first;
+    auto const key = pool.intern(u8"key").value();
+    BOOST_TEST((firstKey == key));
+    BOOST_TEST((firstKey.data() == key.data()));
+    BOOST_TEST(records[1].at(key) == 2);
+}
+
+BOOST_AUTO_TEST_CASE(encode_as_text)
+{
+    dp::u8string_pool pool;
+    auto const str = pool.intern(u8"key").value();
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, str));
+    BOOST_TEST(encodingBuffer.size() == dp::encoded_size_of(str));
+
+    auto const expected = make_byte_array(0x63, 'k', 'e', 'y');
+    BOOST_TEST(std::ranges::equal(static_cast<byte_span>(encodingBuffer),
+                                  expected));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -0,0 +1,158 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/item_rewriter.hpp>
+
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(item_rewriter)
+
+// {"id": 1, "headers": {"ttl": 5, "to": "x"}, "trace": [1, 2]}
+auto make_message()
+{
+    return make_byte_array<33, int>(
+            {0xa3, 0x62, 'i', 'd', 0x01, 0x67, 'h', 'e', 'a', 'd', 'e',
+             'r', 's', 0xa2, 0x63, 't', 't', 'l', 0x05, 0x62, 't', 'o',
+             0x61, 'x', 0x65, 't', 'r', 'a', 'c', 'e', 0x82, 0x01, 0x02});
+}
+
+// {"id": 1, "headers": {"ttl": 60, "to": "x"}}
+constexpr int rewritten_entries_size = 24;
+auto make_rewritten_entries()
+{
+    return make_byte_array<rewritten_entries_size, int>(
+            {0x62, 'i', 'd', 0x01, 0x67, 'h', 'e', 'a', 'd', 'e', 'r', 's',
+             0xa2, 0x63, 't', 't', 'l', 0x18, 0x3c, 0x62, 't', 'o', 0x61,
+             'x'});
+}
+
+template <typename InStream>
+auto make_rewriter()
+{
+    using rewriter_type
+            = dp::item_rewriter<InStream, test_output_stream<64>>;
+    rewriter_type rewriter;
+    rewriter.drop({u8"trace"})
+            .replace({u8"headers", u8"ttl"},
+                     [](InStream &in, test_output_stream<64> &out)
+                             -> dp::result<void> {
+                         DPLX_TRY(auto ttl, dp::decode(dp::as_value<int>, in));
+                         return dp::encode(out, ttl * 12);
+                     });
+    return rewriter;
+}
+
+BOOST_AUTO_TEST_CASE(rewrites_memory_buffer_input)
+{
+    auto bytes = make_message();
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    auto const rewriter = make_rewriter<dp::memory_view>();
+    test_output_stream<64> ostream{};
+    DPLX_REQUIRE_RESULT(rewriter(istream, ostream));
+
+    // the dropped entry has been counted upfront
+    auto entries = make_rewritten_entries();
+    BOOST_TEST(ostream.size() == 1u + rewritten_entries_size);
+    BOOST_TEST(byte_span(ostream)[0] == std::byte{0xa2});
+    BOOST_TEST(byte_span(entries) == byte_span(ostream).subspan(1),
+               boost::test_tools::per_element{});
+    BOOST_TEST(istream.remaining_size() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(rewrites_generic_input_with_indefinite_maps)
+{
+    auto bytes = make_message();
+    test_input_stream istream{bytes};
+
+    auto const rewriter = make_rewriter<test_input_stream>();
+    test_output_stream<64> ostream{};
+    DPLX_REQUIRE_RESULT(rewriter(istream, ostream));
+
+    auto entries = make_rewritten_entries();
+    BOOST_TEST(ostream.size() == 1u + rewritten_entries_size + 1u);
+    BOOST_TEST(byte_span(ostream)[0] == std::byte{0xbf});
+    BOOST_TEST(byte_span(entries)
+                       == byte_span(ostream).subspan(1, rewritten_entries_size),
+               boost::test_tools::per_element{});
+    BOOST_TEST(byte_span(ostream).back() == std::byte{0xff});
+    BOOST_TEST(dp::available_input_size(istream).value() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(copies_items_without_matching_rules)
+{
+    auto bytes = make_byte_array<6>({0x83, 0x01, 0x9f, 0x02, 0xff, 0xf6});
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    auto const rewriter = make_rewriter<dp::memory_view>();
+    test_output_stream<64> ostream{};
+    DPLX_REQUIRE_RESULT(rewriter(istream, ostream));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(rewrites_indefinite_input_maps)
+{
+    auto bytes = make_byte_array<11, int>(
+            {0xbf, 0x65, 't', 'r', 'a', 'c', 'e', 0xf6, 0x01, 0x02, 0xff});
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    auto const rewriter = make_rewriter<dp::memory_view>();
+    test_output_stream<64> ostream{};
+    DPLX_REQUIRE_RESULT(rewriter(istream, ostream));
+
+    auto expected = make_byte_array<4>({0xbf, 0x01, 0x02, 0xff});
+    BOOST_TEST(byte_span(expected) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(generic_input_runs_are_flushed_in_bounded_chunks)
+{
+    using run_type = dp::detail::raw_item_run<test_input_stream>;
+    constexpr std::size_t itemSize = 2u + 100u;
+    constexpr std::size_t numItems = 3u * run_type::flush_threshold / itemSize;
+
+    // a sequence of byte strings of 100 bytes each
+    std::vector<std::byte> bytes;
+    for (std::size_t i = 0u; i < numItems; ++i)
+    {
+        bytes.push_back(std::byte{0x58});
+        bytes.push_back(std::byte{100});
+        bytes.insert(bytes.end(), 100u, static_cast<std::byte>(i));
+    }
+    test_input_stream istream{std::span<std::byte const>(bytes)};
+
+    run_type run;
+    test_output_stream<numItems * itemSize> ostream{};
+    for (std::size_t i = 0u; i < numItems; ++i)
+    {
+        DPLX_REQUIRE_RESULT(run.append_item(istream, ostream));
+        BOOST_TEST(run.size() < run_type::flush_threshold + itemSize);
+    }
+    BOOST_TEST(ostream.size() > 0u);
+    DPLX_REQUIRE_RESULT(run.flush(ostream));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
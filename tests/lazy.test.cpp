@@ -0,0 +1,133 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/lazy.hpp>
+
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/lazy.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/lazy.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(lazy)
+
+struct message
+{
+    std::uint32_t kind;
+    dp::lazy<std::vector<std::uint32_t>> payload;
+
+    static constexpr dp::tuple_def<dp::tuple_member_def<&message::kind>{},
+                                   dp::tuple_member_def<&message::payload>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(decode_captures_the_encoded_item)
+{
+    auto bytes = make_byte_array<32>(
+            {0x82, 0x07, 0x83, 0x18, 0x01, 0x02, 0x03});
+    test_input_stream istream{bytes};
+
+    message value{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, value));
+
+    BOOST_TEST(value.kind == 7u);
+    BOOST_TEST(!value.payload.has_value());
+    BOOST_TEST(value.payload.encoded() == byte_span(bytes).subspan(2, 5),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::available_input_size(istream).value() == 32u - 7u);
+
+    auto getRx = value.payload.get();
+    DPLX_REQUIRE_RESULT(getRx);
+    BOOST_TEST(*getRx.assume_value()
+                       == (std::vector<std::uint32_t>{1u, 2u, 3u}),
+               boost::test_tools::per_element{});
+    BOOST_TEST(value.payload.has_value());
+}
+
+BOOST_AUTO_TEST_CASE(decode_from_memory_view)
+{
+    auto bytes = make_byte_array<16>(
+            {0x82, 0x07, 0x82, 0x42, 0x01, 0x02, 0x04});
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    message value{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, value));
+
+    BOOST_TEST(value.payload.encoded() == byte_span(bytes).subspan(2, 5),
+               boost::test_tools::per_element{});
+    BOOST_TEST(istream.remaining_size() == 16u - 7u);
+
+    // the captured item is a byte string which doesn't fit the value type
+    auto getRx = value.payload.get();
+    BOOST_TEST(getRx.error() == dp::errc::item_type_mismatch);
+    BOOST_TEST(!value.payload.has_value());
+}
+
+BOOST_AUTO_TEST_CASE(untouched_item_is_spliced_verbatim)
+{
+    auto bytes = make_byte_array<7>({0x82, 0x07, 0x83, 0x18, 0x01, 0x02, 0x03});
+    test_input_stream istream{bytes};
+
+    message value{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, value));
+    BOOST_TEST(dp::encoded_size_of(value) == bytes.size());
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, value));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(accessed_item_is_reencoded)
+{
+    auto bytes = make_byte_array<7>({0x82, 0x07, 0x83, 0x18, 0x01, 0x02, 0x03});
+    test_input_stream istream{bytes};
+
+    message value{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, value));
+    auto getRx = value.payload.get();
+    DPLX_REQUIRE_RESULT(getRx);
+    getRx.assume_value()->push_back(4u);
+
+    auto expected
+            = make_byte_array<7>({0x82, 0x07, 0x84, 0x01, 0x02, 0x03, 0x04});
+    BOOST_TEST(dp::encoded_size_of(value) == expected.size());
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, value));
+
+    BOOST_TEST(byte_span(expected) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(empty_lazy_behaves_like_a_value_initialized_value)
+{
+    dp::lazy<std::vector<std::uint32_t>> value{};
+    BOOST_TEST(dp::encoded_size_of(value) == 1u);
+
+    auto getRx = value.get();
+    DPLX_REQUIRE_RESULT(getRx);
+    BOOST_TEST(getRx.assume_value()->empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
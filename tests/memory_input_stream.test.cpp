@@ -25,6 +25,7 @@ static_assert(dp::stream_traits<dp::memory_buffer>::nothrow_input);
 static_assert(dp::input_stream<dp::memory_view>);
 static_assert(!dp::lazy_input_stream<dp::memory_view>);
 static_assert(dp::stream_traits<dp::memory_view>::nothrow_input);
+static_assert(dp::rewindable_input_stream<dp::memory_view>);
 
 BOOST_AUTO_TEST_SUITE(streams)
 
@@ -205,6 +206,23 @@ BOOST_AUTO_TEST_CASE(properly_skips_bytes_at_beginning_1)
     BOOST_TEST(std::ranges::size(proxy) == 50u);
 }
 
+BOOST_AUTO_TEST_CASE(rewinds_to_a_checkpoint)
+{
+    DPLX_REQUIRE_RESULT(dp::skip_bytes(subject, 17));
+
+    auto checkpointRx = dp::checkpoint(subject);
+    DPLX_REQUIRE_RESULT(checkpointRx);
+
+    DPLX_REQUIRE_RESULT(dp::skip_bytes(subject, 40));
+    DPLX_REQUIRE_RESULT(dp::rewind(subject, checkpointRx.assume_value()));
+
+    auto sreadRx = dp::read(subject, 50);
+    DPLX_REQUIRE_RESULT(sreadRx);
+    auto proxy = sreadRx.assume_value();
+    BOOST_TEST(std::ranges::data(proxy) == memory.data() + 17);
+    BOOST_TEST(std::ranges::size(proxy) == 50u);
+}
+
 BOOST_AUTO_TEST_CASE(skips_correctly_from_sbo_1)
 {
     auto sreadRx = dp::read(subject, 17);
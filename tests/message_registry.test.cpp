@@ -0,0 +1,187 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/message_registry.hpp>
+
+#include <cstdint>
+
+#include <boost/mp11/algorithm.hpp>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/message_registry.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/message_registry.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+#include <dplx/dp/tuple_def.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(message_registry)
+
+struct heartbeat
+{
+    static constexpr std::uint64_t message_id = 7u;
+
+    std::uint32_t sequence;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&heartbeat::sequence>{}>
+            layout_descriptor{};
+};
+
+struct quote
+{
+    static constexpr std::uint64_t message_id = 1000u;
+
+    std::uint64_t price;
+    std::uint32_t volume;
+
+    static constexpr dp::tuple_def<dp::tuple_member_def<&quote::price>{},
+                                   dp::tuple_member_def<&quote::volume>{}>
+            layout_descriptor{};
+};
+
+using market_registry = dp::message_registry<quote, heartbeat>;
+
+static_assert(market_registry::ids == std::array<std::uint64_t, 2>{7u, 1000u});
+static_assert(market_registry::type_indices
+              == std::array<std::size_t, 2>{1u, 0u});
+
+struct market_handler
+{
+    heartbeat *lastHeartbeat;
+    quote *lastQuote;
+
+    void operator()(heartbeat &message) const
+    {
+        *lastHeartbeat = message;
+    }
+    auto operator()(quote &message) const -> dp::result<void>
+    {
+        *lastQuote = message;
+        return dp::success();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(encode_prefixes_the_envelope)
+{
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_message(encodingBuffer, heartbeat{42u}));
+
+    auto const expected = make_byte_array<5>({0x82, 0x07, 0x81, 0x18, 0x2a});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_message_size_of(heartbeat{42u}) == 5u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_dispatches_on_the_type_id)
+{
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_message(encodingBuffer, quote{99u, 3u}));
+    DPLX_REQUIRE_RESULT(dp::encode_message(encodingBuffer, heartbeat{5u}));
+
+    heartbeat lastHeartbeat{};
+    quote lastQuote{};
+    market_handler const handler{&lastHeartbeat, &lastQuote};
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    DPLX_REQUIRE_RESULT(
+            dp::decode_message(istream, market_registry{}, handler));
+    BOOST_TEST(lastQuote.price == 99u);
+    BOOST_TEST(lastQuote.volume == 3u);
+    BOOST_TEST(lastHeartbeat.sequence == 0u);
+
+    DPLX_REQUIRE_RESULT(
+            dp::decode_message(istream, market_registry{}, handler));
+    BOOST_TEST(lastHeartbeat.sequence == 5u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_unknown_type_ids)
+{
+    heartbeat lastHeartbeat{};
+    quote lastQuote{};
+    market_handler const handler{&lastHeartbeat, &lastQuote};
+
+    auto const unknownId = make_byte_array<4>({0x82, 0x08, 0x81, 0x00});
+    test_input_stream unknownStream{std::span(unknownId)};
+    auto const unknownRx
+            = dp::decode_message(unknownStream, market_registry{}, handler);
+    BOOST_TEST_REQUIRE(unknownRx.has_error());
+    BOOST_TEST(unknownRx.error() == dp::errc::unknown_message_type);
+
+    auto const noEnvelope = make_byte_array<3>({0x81, 0x07, 0x00});
+    test_input_stream noEnvelopeStream{std::span(noEnvelope)};
+    auto const noEnvelopeRx
+            = dp::decode_message(noEnvelopeStream, market_registry{}, handler);
+    BOOST_TEST_REQUIRE(noEnvelopeRx.has_error());
+    BOOST_TEST(noEnvelopeRx.error() == dp::errc::tuple_size_mismatch);
+}
+
+template <typename I>
+struct numbered_message
+{
+    static constexpr std::uint64_t message_id = 100u + I::value * 37u;
+
+    std::uint32_t value;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&numbered_message::value>{}>
+            layout_descriptor{};
+};
+
+using large_registry = boost::mp11::mp_apply<
+        dp::message_registry,
+        boost::mp11::mp_transform<numbered_message,
+                                  boost::mp11::mp_iota_c<400>>>;
+
+BOOST_AUTO_TEST_CASE(decode_with_a_large_registry)
+{
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_message(
+            encodingBuffer,
+            numbered_message<boost::mp11::mp_size_t<0>>{1u}));
+    DPLX_REQUIRE_RESULT(dp::encode_message(
+            encodingBuffer,
+            numbered_message<boost::mp11::mp_size_t<257>>{2u}));
+    DPLX_REQUIRE_RESULT(dp::encode_message(
+            encodingBuffer,
+            numbered_message<boost::mp11::mp_size_t<399>>{3u}));
+
+    std::uint64_t decodedIds[3] = {};
+    std::uint32_t decodedValues[3] = {};
+    std::size_t numDecoded = 0u;
+    auto handler = [&](auto &message) {
+        decodedIds[numDecoded] = message.message_id;
+        decodedValues[numDecoded] = message.value;
+        numDecoded += 1u;
+    };
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    for (int i = 0; i < 3; ++i)
+    {
+        DPLX_REQUIRE_RESULT(
+                dp::decode_message(istream, large_registry{}, handler));
+    }
+    BOOST_TEST(decodedIds[0] == 100u);
+    BOOST_TEST(decodedIds[1] == 100u + 257u * 37u);
+    BOOST_TEST(decodedIds[2] == 100u + 399u * 37u);
+    BOOST_TEST(decodedValues[0] == 1u);
+    BOOST_TEST(decodedValues[1] == 2u);
+    BOOST_TEST(decodedValues[2] == 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
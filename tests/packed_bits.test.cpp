@@ -0,0 +1,168 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/packed_bits.hpp>
+
+#include <bitset>
+#include <cstdint>
+
+#include <span>
+#include <vector>
+
+#if __has_include(<boost/dynamic_bitset/dynamic_bitset.hpp>)
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#endif
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/packed_bits.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/packed_bits.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+#include <dplx/dp/streams/memory_output_stream.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(packed_bits)
+
+static_assert(dp::encodable<std::vector<bool>, test_output_stream<>>);
+static_assert(dp::decodable<std::vector<bool>, test_input_stream>);
+static_assert(dp::encodable<std::bitset<3>, test_output_stream<>>);
+static_assert(dp::decodable<std::bitset<3>, test_input_stream>);
+#if __has_include(<boost/dynamic_bitset/dynamic_bitset.hpp>)
+static_assert(dp::encodable<boost::dynamic_bitset<std::uint8_t>,
+                            test_output_stream<>>);
+static_assert(dp::decodable<boost::dynamic_bitset<std::uint8_t>,
+                            test_input_stream>);
+#endif
+
+template <typename T, typename U>
+auto round_trip(T const &value, U &decoded) -> void
+{
+    auto const encodedSize = dp::encoded_size_of(value);
+    std::vector<std::byte> storage(static_cast<std::size_t>(encodedSize));
+    dp::memory_buffer buffer{std::span<std::byte>(storage)};
+    DPLX_REQUIRE_RESULT(dp::encode(buffer, value));
+    BOOST_TEST(buffer.remaining_size() == 0);
+
+    dp::memory_view istream{std::span<std::byte const>(storage)};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST(istream.remaining_size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(vector_bool_is_packed)
+{
+    std::vector<bool> const value{true, false, true, true, false, false,
+                                  false, false, false, true};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+
+    // 0x6470'0004(h'06 0d02')
+    auto const expected = make_byte_array<9>(
+            {0xda, 0x64, 0x70, 0x00, 0x04, 0x43, 0x06, 0x0d, 0x02});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(value) == expected.size());
+
+    test_input_stream istream{std::span(expected)};
+    std::vector<bool> decoded{false, true};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST(decoded == value, boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(vector_bool_round_trip)
+{
+    for (std::size_t const size : {0u, 1u, 63u, 64u, 65u, 3000u})
+    {
+        std::vector<bool> value(size);
+        for (std::size_t i = 0u; i < size; ++i)
+        {
+            value[i] = i % 3u == 0u || i % 7u == 0u;
+        }
+
+        std::vector<bool> decoded;
+        round_trip(value, decoded);
+        BOOST_TEST(decoded == value, boost::test_tools::per_element{});
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bitset_round_trip)
+{
+    std::bitset<100> value;
+    value.set(0).set(64).set(99);
+
+    std::bitset<100> decoded;
+    decoded.set(1);
+    round_trip(value, decoded);
+    BOOST_TEST((decoded == value));
+}
+
+BOOST_AUTO_TEST_CASE(bitset_rejects_size_mismatch)
+{
+    std::bitset<12> const value;
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    std::bitset<13> decoded;
+    BOOST_TEST(dp::decode(istream, decoded).error()
+               == dp::errc::tuple_size_mismatch);
+}
+
+#if __has_include(<boost/dynamic_bitset/dynamic_bitset.hpp>)
+
+BOOST_AUTO_TEST_CASE(dynamic_bitset_round_trip)
+{
+    boost::dynamic_bitset<> value(130u);
+    value.set(1).set(77).set(129);
+
+    boost::dynamic_bitset<> decoded(3u);
+    round_trip(value, decoded);
+    BOOST_TEST((decoded == value));
+
+    // the wire format doesn't depend on the block size
+    boost::dynamic_bitset<std::uint8_t> narrow;
+    round_trip(value, narrow);
+    BOOST_TEST_REQUIRE(narrow.size() == value.size());
+    for (std::size_t i = 0u; i < value.size(); ++i)
+    {
+        BOOST_TEST(narrow[i] == value[i]);
+    }
+}
+
+#endif
+
+BOOST_AUTO_TEST_CASE(decode_rejects_malformed_padding)
+{
+    std::vector<bool> decoded;
+    {
+        // the padding exceeds seven bits
+        auto bytes = make_byte_array<8>(
+                {0xda, 0x64, 0x70, 0x00, 0x04, 0x42, 0x08, 0x00});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode(istream, decoded).error()
+                   == dp::errc::item_value_out_of_range);
+    }
+    {
+        // a padding bit is set
+        auto bytes = make_byte_array<8>(
+                {0xda, 0x64, 0x70, 0x00, 0x04, 0x42, 0x07, 0x03});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode(istream, decoded).error()
+                   == dp::errc::item_value_out_of_range);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
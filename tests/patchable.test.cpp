@@ -0,0 +1,197 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/patchable.hpp>
+
+#include <cstdint>
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/object_utils.hpp>
+#include <dplx/dp/decoder/patchable.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/object_utils.hpp>
+#include <dplx/dp/encoder/patchable.hpp>
+#include <dplx/dp/encoder/to_memory.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/object_def.hpp>
+#include <dplx/dp/patch_property.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(patchable)
+
+struct counters
+{
+    std::uint32_t id;
+    dp::patchable<std::uint32_t> hits;
+    dp::patchable<std::int16_t> delta;
+    dp::patchable<double> ratio;
+
+    static constexpr dp::object_def<
+            dp::named_property_def<u8"id", &counters::id>{},
+            dp::named_property_def<u8"hits", &counters::hits>{},
+            dp::named_property_def<u8"delta", &counters::delta>{},
+            dp::named_property_def<u8"ratio", &counters::ratio>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(integers_are_encoded_with_full_width)
+{
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(
+            dp::encode(encodingBuffer, dp::patchable<std::uint32_t>{1u}));
+
+    auto const expected = make_byte_array<5>({0x1a, 0x00, 0x00, 0x00, 0x01});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(dp::patchable<std::uint32_t>{1u}) == 5u);
+}
+
+BOOST_AUTO_TEST_CASE(negative_integers_are_encoded_with_full_width)
+{
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(
+            dp::encode(encodingBuffer, dp::patchable<std::int16_t>{-2}));
+
+    auto const expected = make_byte_array<3>({0x39, 0x00, 0x01});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(decodes_any_encoding)
+{
+    auto bytes = make_byte_array<8>({0x18, 0x2a});
+    test_input_stream istream{bytes};
+
+    dp::patchable<std::uint64_t> value{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, value));
+    BOOST_TEST(value.value == 42u);
+}
+
+BOOST_AUTO_TEST_CASE(patch_integer_property)
+{
+    counters const value{7u, {1u}, {3}, {0.5}};
+    auto encodeRx = dp::encode_to_vector(value);
+    DPLX_REQUIRE_RESULT(encodeRx);
+    auto &encoded = encodeRx.assume_value();
+    auto const encodedSize = encoded.size();
+
+    DPLX_REQUIRE_RESULT(dp::patch_property(encoded, u8"hits",
+                                           std::uint32_t{0xdead'beefu}));
+    DPLX_REQUIRE_RESULT(dp::patch_property(encoded, u8"delta", -300));
+    BOOST_TEST(encoded.size() == encodedSize);
+
+    dp::memory_view istream{std::span<std::byte const>(encoded)};
+    counters decoded{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST(decoded.id == 7u);
+    BOOST_TEST(decoded.hits.value == 0xdead'beefu);
+    BOOST_TEST(decoded.delta.value == -300);
+    BOOST_TEST(decoded.ratio.value == 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(patch_float_property)
+{
+    counters const value{7u, {1u}, {3}, {0.5}};
+    auto encodeRx = dp::encode_to_vector(value);
+    DPLX_REQUIRE_RESULT(encodeRx);
+    auto &encoded = encodeRx.assume_value();
+
+    DPLX_REQUIRE_RESULT(dp::patch_property(encoded, u8"ratio", 0.25f));
+
+    dp::memory_view istream{std::span<std::byte const>(encoded)};
+    counters decoded{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST(decoded.ratio.value == 0.25);
+}
+
+BOOST_AUTO_TEST_CASE(patch_memory_buffer)
+{
+    // {1: 0x1a 00 00 00 05}
+    auto bytes = make_byte_array<16>(
+            {0xa1, 0x01, 0x1a, 0x00, 0x00, 0x00, 0x05});
+    dp::memory_buffer buffer{std::span<std::byte>(bytes)};
+
+    DPLX_REQUIRE_RESULT(dp::patch_property(buffer, 1u, 6));
+
+    auto const expected
+            = make_byte_array<7>({0xa1, 0x01, 0x1a, 0x00, 0x00, 0x00, 0x06});
+    BOOST_TEST(std::span(bytes).first(7) == expected,
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(patch_indefinite_map)
+{
+    // {_ "a": 0x19 00 01, "b": 0x19 00 02}
+    auto bytes = make_byte_array<16>({0xbf, 0x61, 0x61, 0x19, 0x00, 0x01, 0x61,
+                                      0x62, 0x19, 0x00, 0x02, 0xff});
+
+    DPLX_REQUIRE_RESULT(dp::patch_property(byte_span(bytes), u8"b", 0x1234));
+
+    BOOST_TEST(bytes[9] == std::byte{0x12});
+    BOOST_TEST(bytes[10] == std::byte{0x34});
+    BOOST_TEST(bytes[4] == std::byte{0x00});
+    BOOST_TEST(bytes[5] == std::byte{0x01});
+}
+
+BOOST_AUTO_TEST_CASE(patch_rejects_missing_property)
+{
+    auto bytes = make_byte_array<8>({0xa1, 0x01, 0x19, 0x00, 0x05});
+
+    auto patchRx = dp::patch_property(byte_span(bytes), 2u, 6);
+    BOOST_TEST(patchRx.error() == dp::errc::required_object_property_missing);
+}
+
+BOOST_AUTO_TEST_CASE(patch_rejects_compact_items)
+{
+    // {1: 5}
+    auto bytes = make_byte_array<8>({0xa1, 0x01, 0x05});
+
+    auto patchRx = dp::patch_property(byte_span(bytes), 1u, 6);
+    BOOST_TEST(patchRx.error() == dp::errc::item_type_mismatch);
+    BOOST_TEST(bytes[2] == std::byte{0x05});
+}
+
+BOOST_AUTO_TEST_CASE(patch_rejects_values_which_dont_fit)
+{
+    // {1: 0x19 00 05}
+    auto bytes = make_byte_array<8>({0xa1, 0x01, 0x19, 0x00, 0x05});
+
+    auto patchRx = dp::patch_property(byte_span(bytes), 1u, 0x1'0000);
+    BOOST_TEST(patchRx.error() == dp::errc::item_value_out_of_range);
+
+    auto floatRx = dp::patch_property(byte_span(bytes), 1u, 0.5);
+    BOOST_TEST(floatRx.error() == dp::errc::item_type_mismatch);
+}
+
+BOOST_AUTO_TEST_CASE(patch_rejects_lossy_float_narrowing)
+{
+    // {1: 0xfa 3f 00 00 00}
+    auto bytes = make_byte_array<8>({0xa1, 0x01, 0xfa, 0x3f, 0x00, 0x00, 0x00});
+
+    auto patchRx = dp::patch_property(byte_span(bytes), 1u, 0.1);
+    BOOST_TEST(patchRx.error() == dp::errc::item_value_out_of_range);
+
+    DPLX_REQUIRE_RESULT(dp::patch_property(byte_span(bytes), 1u, 0.25));
+    BOOST_TEST(bytes[3] == std::byte{0x3e});
+    BOOST_TEST(bytes[4] == std::byte{0x80});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -0,0 +1,184 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/raw_item.hpp>
+
+#include <array>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/raw_item.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/raw_item.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+#include <dplx/dp/streams/chunked_input_stream.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(raw_item)
+
+static_assert(dp::decodable<dp::raw_item, test_input_stream>);
+static_assert(dp::decodable<dp::raw_item_view, dp::memory_view>);
+static_assert(!dp::decodable<dp::raw_item_view, test_input_stream>);
+
+// splits the input into two chunks
+class split_input_stream final
+    : public dp::chunked_input_stream_base<split_input_stream>
+{
+public:
+    friend class dp::chunked_input_stream_base<split_input_stream>;
+    using base_type = dp::chunked_input_stream_base<split_input_stream>;
+
+    std::span<std::byte const> mSecondChunk;
+    bool mExhausted = false;
+
+    explicit split_input_stream(std::span<std::byte const> const content,
+                                std::size_t const splitPoint)
+        : base_type(content.first(splitPoint), content.size())
+        , mSecondChunk(content.subspan(splitPoint))
+    {
+    }
+
+private:
+    auto acquire_next_chunk_impl(std::uint64_t) -> dp::result<dp::memory_view>
+    {
+        if (mExhausted)
+        {
+            return dp::errc::end_of_stream;
+        }
+        mExhausted = true;
+        return dp::memory_view(mSecondChunk);
+    }
+};
+
+struct envelope
+{
+    std::uint32_t kind;
+    dp::raw_item payload;
+
+    static constexpr dp::tuple_def<dp::tuple_member_def<&envelope::kind>{},
+                                   dp::tuple_member_def<&envelope::payload>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(decode_captures_exactly_one_item)
+{
+    auto bytes = make_byte_array<16>({0x82, 0x43, 0x01, 0x02, 0x03, 0xa1,
+                                      0x01, 0x9f, 0x02, 0xff, 0x04});
+    test_input_stream istream{bytes};
+
+    dp::raw_item item;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, item));
+
+    BOOST_TEST(item.encoded() == byte_span(bytes).first(10),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::available_input_size(istream).value() == 16u - 10u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_view_borrows_from_the_buffer)
+{
+    auto bytes = make_byte_array<16>({0x5f, 0x41, 0x01, 0x42, 0x02, 0x03,
+                                      0xff, 0x17});
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    dp::raw_item_view item;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, item));
+
+    BOOST_TEST(item.encoded().data() == bytes.data());
+    BOOST_TEST(item.size() == 7u);
+    BOOST_TEST(istream.remaining_size() == 16u - 7u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_from_chunked_stream)
+{
+    std::vector<std::byte> content(100u, std::byte{0x00});
+    content[0] = std::byte{0x82};
+    content[1] = std::byte{0x58};
+    content[2] = std::byte{0x50};
+    content[83] = std::byte{0x17};
+    split_input_stream istream(content, 50u);
+
+    dp::raw_item item;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, item));
+
+    BOOST_TEST(item.encoded() == std::span(content).first(84u),
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::available_input_size(istream).value() == 100u - 84u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_truncated_items)
+{
+    auto bytes = make_byte_array<4>({0x83, 0x01, 0x02, 0x03});
+    test_input_stream istream{std::span(bytes).first(3)};
+
+    dp::raw_item item;
+    auto rx = dp::decode(istream, item);
+
+    BOOST_TEST(rx.has_failure());
+    BOOST_TEST(item.empty());
+}
+
+BOOST_AUTO_TEST_CASE(roundtrip_splices_the_item)
+{
+    auto bytes = make_byte_array<9>(
+            {0x82, 0x07, 0xa1, 0x61, 0x61, 0x9f, 0x18, 0x01, 0xff});
+    test_input_stream istream{bytes};
+
+    envelope value{};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, value));
+    BOOST_TEST(value.payload.size() == 7u);
+    BOOST_TEST(dp::encoded_size_of(value) == bytes.size());
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, value));
+
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_view)
+{
+    auto bytes = make_byte_array<3>({0x82, 0xf5, 0xf4});
+    dp::raw_item_view const item{std::span<std::byte const>(bytes)};
+
+    test_output_stream<> ostream{};
+    DPLX_REQUIRE_RESULT(dp::encode(ostream, item));
+
+    BOOST_TEST(dp::encoded_size_of(item) == 3u);
+    BOOST_TEST(byte_span(bytes) == byte_span(ostream),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(encode_rejects_empty_items)
+{
+    test_output_stream<> ostream{};
+
+    auto const itemRx = dp::encode(ostream, dp::raw_item{});
+    BOOST_TEST_REQUIRE(itemRx.has_error());
+    BOOST_TEST(itemRx.error() == dp::errc::invalid_argument);
+
+    auto const viewRx = dp::encode(ostream, dp::raw_item_view{});
+    BOOST_TEST_REQUIRE(viewRx.has_error());
+    BOOST_TEST(viewRx.error() == dp::errc::invalid_argument);
+
+    envelope value{};
+    auto const envelopeRx = dp::encode(ostream, value);
+    BOOST_TEST_REQUIRE(envelopeRx.has_error());
+    BOOST_TEST(envelopeRx.error() == dp::errc::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -0,0 +1,283 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/stringref.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/interned_string.hpp>
+#include <dplx/dp/decoder/lazy.hpp>
+#include <dplx/dp/decoder/object_utils.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/std_string.hpp>
+#include <dplx/dp/decoder/stringref.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/lazy.hpp>
+#include <dplx/dp/encoder/object_utils.hpp>
+#include <dplx/dp/encoder/stringref.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+#include <dplx/dp/interned_string.hpp>
+#include <dplx/dp/lazy.hpp>
+#include <dplx/dp/object_def.hpp>
+#include <dplx/dp/tuple_def.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(stringref)
+
+static_assert(dp::detail::stringref_min_size(0u) == 3u);
+static_assert(dp::detail::stringref_min_size(24u) == 4u);
+static_assert(dp::detail::stringref_min_size(255u) == 4u);
+static_assert(dp::detail::stringref_min_size(256u) == 5u);
+static_assert(dp::detail::stringref_min_size(65536u) == 7u);
+static_assert(dp::detail::stringref_min_size(0x1'0000'0000u) == 11u);
+
+BOOST_AUTO_TEST_CASE(repeated_strings_are_referenced)
+{
+    std::vector<std::u8string> const value{u8"hello", u8"hello", u8"hi",
+                                           u8"hi", u8"world", u8"hello"};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(encodingBuffer, value));
+
+    // 256([ "hello", 25(0), "hi", "hi", "world", 25(0) ])
+    auto const expected = make_byte_array<28, int>(
+            {0xd9, 0x01, 0x00, 0x86, 0x65, 'h', 'e',  'l',  'l',  'o',
+             0xd8, 0x19, 0x00, 0x62, 'h',  'i', 0x62, 'h',  'i',  0x65,
+             'w',  'o',  'r',  'l',  'd',  0xd8, 0x19, 0x00});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    std::vector<std::u8string> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(istream, decoded));
+    BOOST_TEST((decoded == value));
+}
+
+BOOST_AUTO_TEST_CASE(short_strings_dont_get_an_index)
+{
+    dp::stringref_table table;
+    std::vector<std::u8string> strings;
+    for (int i = 0; i < 25; ++i)
+    {
+        std::u8string str = u8"s..";
+        str[1] = static_cast<char8_t>(u8'a' + i / 10);
+        str[2] = static_cast<char8_t>(u8'0' + i % 10);
+        strings.push_back(str);
+    }
+    for (auto const &str : strings)
+    {
+        auto const *data = reinterpret_cast<std::byte const *>(str.data());
+        BOOST_TEST(table.find_or_insert(true, data, str.size()).value()
+                   == dp::stringref_table::npos);
+    }
+    // the 25th string would need a two byte index
+    BOOST_TEST(table.size() == 24u);
+
+    auto const *data = reinterpret_cast<std::byte const *>(strings[3].data());
+    BOOST_TEST(table.find_or_insert(true, data, 3u).value() == 3u);
+    // byte strings and text strings don't match
+    BOOST_TEST(table.find_or_insert(false, data, 3u).value()
+               == dp::stringref_table::npos);
+}
+
+BOOST_AUTO_TEST_CASE(interned_strings_are_resolved)
+{
+    // 256([ "key_a", 25(0), 25(0) ])
+    auto bytes = make_byte_array<16, int>({0xd9, 0x01, 0x00, 0x83, 0x65, 'k',
+                                           'e', 'y', '_', 'a', 0xd8, 0x19,
+                                           0x00, 0xd8, 0x19, 0x00});
+    test_input_stream istream{std::span(bytes)};
+    dp::u8string_pool pool;
+    dp::stateful_stream<test_input_stream, dp::u8string_pool> poolStream(
+            istream, pool);
+
+    std::vector<dp::interned_u8string> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(poolStream, decoded));
+    BOOST_TEST_REQUIRE(decoded.size() == 3u);
+    BOOST_TEST((decoded[2].view() == u8"key_a"));
+    BOOST_TEST((decoded[0].data() == decoded[2].data()));
+    BOOST_TEST(pool.size() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_invalid_references)
+{
+    std::vector<std::u8string> decoded;
+    {
+        // 256([ 25(0) ])
+        auto bytes = make_byte_array<7>(
+                {0xd9, 0x01, 0x00, 0x81, 0xd8, 0x19, 0x00});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode_stringref(istream, decoded).error()
+                   == dp::errc::item_value_out_of_range);
+    }
+    {
+        // 256([ h'010203', 25(0) ])
+        auto bytes = make_byte_array<11>({0xd9, 0x01, 0x00, 0x82, 0x43, 0x01,
+                                          0x02, 0x03, 0xd8, 0x19, 0x00});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode_stringref(istream, decoded).error()
+                   == dp::errc::item_type_mismatch);
+    }
+    {
+        // the namespace tag is missing
+        auto bytes = make_byte_array<4>({0x81, 0x63, 0x61, 0x62});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode_stringref(istream, decoded).error()
+                   == dp::errc::item_type_mismatch);
+    }
+}
+
+struct named_strings
+{
+    std::u8string alpha;
+    std::u8string gamma;
+
+    static constexpr dp::object_def<
+            dp::named_property_def<u8"alpha", &named_strings::alpha>{},
+            dp::named_property_def<u8"gamma", &named_strings::gamma>{}>
+            layout_descriptor{};
+
+    friend auto operator==(named_strings const &,
+                           named_strings const &) noexcept -> bool
+            = default;
+};
+
+BOOST_AUTO_TEST_CASE(object_keys_are_registered)
+{
+    named_strings const value{u8"bravo", u8"bravo"};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(encodingBuffer, value));
+
+    // 256({ "alpha": "bravo", "gamma": 25(1) })
+    auto const expected = make_byte_array<25, int>(
+            {0xd9, 0x01, 0x00, 0xa2, 0x65, 'a', 'l',  'p',  'h',
+             'a',  0x65, 'b',  'r',  'a',  'v', 'o',  0x65, 'g',
+             'a',  'm',  'm',  'a',  0xd8, 0x19, 0x01});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    named_strings decoded{};
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(istream, decoded));
+    BOOST_TEST((decoded.alpha == u8"bravo"));
+    BOOST_TEST((decoded.gamma == u8"bravo"));
+}
+
+BOOST_AUTO_TEST_CASE(repeated_object_keys_are_referenced)
+{
+    std::vector<named_strings> const value{{u8"bravo", u8"delta"},
+                                           {u8"delta", u8"alpha"}};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(encodingBuffer, value));
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    std::vector<named_strings> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(istream, decoded));
+    BOOST_TEST((decoded == value));
+}
+
+struct lazy_strings
+{
+    std::u8string first;
+    dp::lazy<std::u8string> middle;
+    std::u8string last;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&lazy_strings::first>{},
+            dp::tuple_member_def<&lazy_strings::middle>{},
+            dp::tuple_member_def<&lazy_strings::last>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(lazy_items_take_part_in_the_namespace)
+{
+    lazy_strings const value{u8"alpha", dp::lazy<std::u8string>(u8"bravo"),
+                             u8"bravo"};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(encodingBuffer, value));
+
+    // the captured "bravo" must be registered for the reference to resolve
+    test_input_stream istream{std::span(encodingBuffer)};
+    lazy_strings decoded{};
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(istream, decoded));
+    BOOST_TEST((decoded.first == u8"alpha"));
+    BOOST_TEST((decoded.last == u8"bravo"));
+    BOOST_TEST(!decoded.middle.encoded().empty());
+
+    // the spliced "bravo" must be registered, too
+    test_output_stream<> reencodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(reencodingBuffer, decoded));
+    BOOST_TEST(std::span(reencodingBuffer) == std::span(encodingBuffer),
+               boost::test_tools::per_element{});
+
+    auto middle = decoded.middle.get();
+    DPLX_REQUIRE_RESULT(middle);
+    BOOST_TEST((*middle.assume_value() == u8"bravo"));
+}
+
+BOOST_AUTO_TEST_CASE(captured_references_are_resolved)
+{
+    lazy_strings const value{u8"alpha", dp::lazy<std::u8string>(u8"alpha"),
+                             u8"bravo"};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(encodingBuffer, value));
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    lazy_strings decoded{};
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(istream, decoded));
+
+    // 25(0) has been replaced by "alpha"
+    auto const expected
+            = make_byte_array<6, int>({0x65, 'a', 'l', 'p', 'h', 'a'});
+    BOOST_TEST(decoded.middle.encoded() == std::span(expected),
+               boost::test_tools::per_element{});
+    auto middle = decoded.middle.get();
+    DPLX_REQUIRE_RESULT(middle);
+    BOOST_TEST((*middle.assume_value() == u8"alpha"));
+    BOOST_TEST((decoded.last == u8"bravo"));
+
+    // the spliced duplicate is assigned an index like the decoder does
+    test_output_stream<> reencodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(reencodingBuffer, decoded));
+    test_input_stream reencoded{std::span(reencodingBuffer)};
+    lazy_strings redecoded{};
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(reencoded, redecoded));
+    BOOST_TEST((redecoded.first == u8"alpha"));
+    BOOST_TEST((redecoded.last == u8"bravo"));
+}
+
+BOOST_AUTO_TEST_CASE(spliced_references_are_rejected)
+{
+    lazy_strings value{u8"alpha", {}, u8"bravo"};
+    // 25(0)
+    auto const reference = make_byte_array<3>({0xd8, 0x19, 0x00});
+    DPLX_REQUIRE_RESULT(value.middle.assign_encoded(std::span(reference)));
+
+    test_output_stream<> encodingBuffer{};
+    BOOST_TEST(dp::encode_stringref(encodingBuffer, value).error()
+               == dp::errc::unsupported_raw_item);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
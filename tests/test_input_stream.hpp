@@ -41,6 +41,11 @@ public:
     {
     }
 
+    auto read_counter() const noexcept -> int
+    {
+        return mReadCounter;
+    }
+
     friend inline auto tag_invoke(dp::tag_t<dp::available_input_size>,
                                   test_input_stream &self) noexcept
             -> dp::result<std::size_t>
@@ -124,8 +129,26 @@ public:
         self.mStreamPosition += numBytes;
         return dp::oc::success();
     }
+    friend inline auto tag_invoke(dp::tag_t<dp::checkpoint>,
+                                  test_input_stream &self) noexcept
+            -> dp::result<std::size_t>
+    {
+        BOOST_TEST(self.mReadCounter == self.mCommitCounter);
+        return self.mStreamPosition;
+    }
+    friend inline auto tag_invoke(dp::tag_t<dp::rewind>,
+                                  test_input_stream &self,
+                                  std::size_t const streamPosition) noexcept
+            -> dp::result<void>
+    {
+        BOOST_TEST(self.mReadCounter == self.mCommitCounter);
+        BOOST_TEST(streamPosition <= self.mStreamPosition);
+        self.mStreamPosition = streamPosition;
+        return dp::success();
+    }
 };
 static_assert(dp::lazy_input_stream<test_input_stream>);
+static_assert(dp::rewindable_input_stream<test_input_stream>);
 
 template <typename... Ts>
 auto make_test_input_stream(Ts... ts) noexcept -> test_input_stream
@@ -0,0 +1,209 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/value.hpp>
+
+#include <cstdint>
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/value.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/value.hpp>
+#include <dplx/dp/memory_buffer.hpp>
+#include <dplx/dp/streams/memory_input_stream.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(value)
+
+static_assert(sizeof(dp::value) == 16u);
+
+BOOST_AUTO_TEST_CASE(scalars_are_stored_inline)
+{
+    dp::value const integer(-500);
+    BOOST_TEST((integer.kind() == dp::value_kind::integer));
+    BOOST_TEST(integer.as_integer<int>().value() == -500);
+    BOOST_TEST(integer.as_integer<unsigned>().error()
+               == dp::errc::item_value_out_of_range);
+    BOOST_TEST(integer.as_integer<std::int8_t>().error()
+               == dp::errc::item_value_out_of_range);
+
+    dp::value const boolean(true);
+    BOOST_TEST(boolean.as_boolean().value());
+    BOOST_TEST(boolean.as_double().error() == dp::errc::item_type_mismatch);
+
+    BOOST_TEST(dp::value(0.5).as_double().value() == 0.5);
+    BOOST_TEST((dp::value().kind() == dp::value_kind::null));
+    BOOST_TEST((dp::value::undefined().kind() == dp::value_kind::undefined));
+}
+
+BOOST_AUTO_TEST_CASE(short_strings_dont_use_the_arena)
+{
+    dp::value_arena arena;
+    auto textRx = arena.make_text(u8"fourteen bytes");
+    DPLX_REQUIRE_RESULT(textRx);
+
+    auto const text = textRx.assume_value();
+    BOOST_TEST((text.as_text().value() == u8"fourteen bytes"));
+    // the view points into the node itself
+    BOOST_TEST(static_cast<void const *>(text.as_text().value().data())
+               == static_cast<void const *>(&text));
+
+    auto longRx = arena.make_text(u8"fifteen bytes!!");
+    DPLX_REQUIRE_RESULT(longRx);
+    auto const longText = longRx.assume_value();
+    BOOST_TEST((longText.as_text().value() == u8"fifteen bytes!!"));
+}
+
+BOOST_AUTO_TEST_CASE(decode_definite_containers)
+{
+    // {"a": [1, -2, h'0102'], "bb": 24(true)}
+    auto bytes = make_byte_array<32>({0xa2, 0x61, 0x61, 0x83, 0x01, 0x21, 0x42,
+                                      0x01, 0x02, 0x62, 0x62, 0x62, 0xd8, 0x18,
+                                      0xf5});
+    test_input_stream istream{bytes};
+
+    dp::document doc;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, doc));
+    BOOST_TEST(dp::available_input_size(istream).value() == 32u - 15u);
+
+    auto const &root = doc.root();
+    BOOST_TEST_REQUIRE(root.as_map().value().size() == 2u);
+
+    auto const *a = root.find(u8"a");
+    BOOST_TEST_REQUIRE(a != nullptr);
+    auto const elements = a->as_array().value();
+    BOOST_TEST_REQUIRE(elements.size() == 3u);
+    BOOST_TEST(elements[0].as_integer<int>().value() == 1);
+    BOOST_TEST(elements[1].as_integer<int>().value() == -2);
+    BOOST_TEST(elements[2].as_binary().value().size() == 2u);
+
+    auto const *bb = root.find(u8"bb");
+    BOOST_TEST_REQUIRE(bb != nullptr);
+    BOOST_TEST(bb->tag_number().value() == 24u);
+    BOOST_TEST(bb->tagged_item().value()->as_boolean().value());
+
+    BOOST_TEST((root.find(u8"c") == nullptr));
+}
+
+BOOST_AUTO_TEST_CASE(decode_indefinite_items)
+{
+    // [_ (_ "ab", "cdefghijklmnop"), {_ 1: null}, 0xf9 3c00]
+    auto bytes = make_byte_array<40>(
+            {0x9f, 0x7f, 0x62, 0x61, 0x62, 0x6e, 0x63, 0x64, 0x65, 0x66,
+             0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70,
+             0xff, 0xbf, 0x01, 0xf6, 0xff, 0xf9, 0x3c, 0x00, 0xff});
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    dp::document doc;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, doc));
+
+    auto const elements = doc.root().as_array().value();
+    BOOST_TEST_REQUIRE(elements.size() == 3u);
+    BOOST_TEST((elements[0].as_text().value() == u8"abcdefghijklmnop"));
+    auto const entries = elements[1].as_map().value();
+    BOOST_TEST_REQUIRE(entries.size() == 1u);
+    BOOST_TEST(entries[0].key.as_integer<int>().value() == 1);
+    BOOST_TEST((entries[0].mapped.kind() == dp::value_kind::null));
+    BOOST_TEST(elements[2].as_double().value() == 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    dp::document doc;
+    auto &arena = doc.arena();
+
+    std::vector<dp::value> elements{
+            dp::value(std::numeric_limits<std::uint64_t>::max()),
+            dp::value(std::numeric_limits<std::int64_t>::min()),
+            dp::value(1.5f),
+            arena.make_binary(std::as_bytes(std::span("a long binary string")))
+                    .value()};
+    auto const array = arena.make_array(elements).value();
+    std::vector<dp::value_map_entry> entries{
+            {arena.make_text(u8"values").value(), array},
+            {dp::value(7), arena.make_tag(1u, dp::value(1000)).value()}};
+    doc.assign_root(arena.make_map(entries).value());
+
+    test_output_stream<128> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, doc));
+    BOOST_TEST(encodingBuffer.size() == dp::encoded_size_of(doc));
+
+    dp::memory_view istream{std::span<std::byte const>(
+            static_cast<byte_span>(encodingBuffer))};
+    dp::document decoded;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST((decoded.root() == doc.root()));
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_truncated_input)
+{
+    // [1, 2, 3] with only two elements present
+    auto bytes = make_byte_array<3>({0x83, 0x01, 0x02});
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    dp::document doc;
+    auto decodeRx = dp::decode(istream, doc);
+    BOOST_TEST(decodeRx.has_failure());
+    BOOST_TEST((doc.root().kind() == dp::value_kind::null));
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_oversized_lengths)
+{
+    // an array head claiming 2^32 elements
+    auto bytes = make_byte_array<16>(
+            {0x9b, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00});
+    dp::memory_view istream{std::span<std::byte const>(bytes)};
+
+    dp::document doc;
+    auto decodeRx = dp::decode(istream, doc);
+    BOOST_TEST(decodeRx.error() == dp::errc::missing_data);
+}
+
+BOOST_AUTO_TEST_CASE(decode_limits_the_nesting_depth)
+{
+    // [[[0]]] and [_ 1([_ 0])], i.e. three nesting levels each
+    auto bytes = make_byte_array<4>({0x81, 0x81, 0x81, 0x00});
+    auto indefinite = make_byte_array<6>({0x9f, 0xc1, 0x9f, 0x00, 0xff, 0xff});
+
+    dp::document doc;
+    doc.arena().max_nesting_depth(3u);
+    {
+        dp::memory_view istream{std::span<std::byte const>(bytes)};
+        DPLX_REQUIRE_RESULT(dp::decode(istream, doc));
+    }
+    {
+        dp::memory_view istream{std::span<std::byte const>(indefinite)};
+        DPLX_REQUIRE_RESULT(dp::decode(istream, doc));
+    }
+
+    doc.arena().max_nesting_depth(2u);
+    {
+        dp::memory_view istream{std::span<std::byte const>(bytes)};
+        BOOST_TEST(dp::decode(istream, doc).error()
+                   == dp::errc::nesting_depth_exceeded);
+        BOOST_TEST((doc.root().kind() == dp::value_kind::null));
+    }
+    {
+        dp::memory_view istream{std::span<std::byte const>(indefinite)};
+        BOOST_TEST(dp::decode(istream, doc).error()
+                   == dp::errc::nesting_depth_exceeded);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
@@ -0,0 +1,183 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/value_sharing.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/raw_item.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/tuple_utils.hpp>
+#include <dplx/dp/decoder/value_sharing.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/raw_item.hpp>
+#include <dplx/dp/encoder/tuple_utils.hpp>
+#include <dplx/dp/encoder/value_sharing.hpp>
+#include <dplx/dp/raw_item.hpp>
+#include <dplx/dp/tuple_def.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(value_sharing)
+
+static_assert(dp::encodable<std::shared_ptr<int const>, test_output_stream<>>);
+static_assert(dp::decodable<std::shared_ptr<int const>, test_input_stream>);
+
+BOOST_AUTO_TEST_CASE(shared_objects_are_referenced)
+{
+    auto const a = std::make_shared<int>(7);
+    auto const b = std::make_shared<int>(9);
+    std::vector<std::shared_ptr<int>> const value{a, a, b, nullptr, b};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_sharing(encodingBuffer, value));
+
+    // [28(7), 29(0), 28(9), null, 29(1)]
+    auto const expected
+            = make_byte_array<14>({0x85, 0xd8, 0x1c, 0x07, 0xd8, 0x1d, 0x00,
+                                   0xd8, 0x1c, 0x09, 0xf6, 0xd8, 0x1d, 0x01});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+
+    test_input_stream istream{std::span(expected)};
+    std::vector<std::shared_ptr<int>> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_sharing(istream, decoded));
+    BOOST_TEST_REQUIRE(decoded.size() == 5u);
+    BOOST_TEST(*decoded[0] == 7);
+    BOOST_TEST(*decoded[2] == 9);
+    BOOST_TEST((decoded[0] == decoded[1]));
+    BOOST_TEST((decoded[2] == decoded[4]));
+    BOOST_TEST((decoded[0] != decoded[2]));
+    BOOST_TEST(!decoded[3]);
+}
+
+BOOST_AUTO_TEST_CASE(objects_are_inlined_without_sharing)
+{
+    auto const a = std::make_shared<int>(7);
+    std::vector<std::shared_ptr<int>> const value{a, a, nullptr};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+
+    auto const expected = make_byte_array<4>({0x83, 0x07, 0x07, 0xf6});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(value) == expected.size());
+
+    test_input_stream istream{std::span(expected)};
+    std::vector<std::shared_ptr<int>> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST_REQUIRE(decoded.size() == 3u);
+    BOOST_TEST((decoded[0] != decoded[1]));
+    BOOST_TEST(*decoded[1] == 7);
+}
+
+BOOST_AUTO_TEST_CASE(shareable_tags_are_ignored_without_sharing)
+{
+    // [28(7), 29(0)]
+    auto bytes = make_byte_array<7>({0x82, 0xd8, 0x1c, 0x07, 0xd8, 0x1d, 0x00});
+
+    std::vector<std::shared_ptr<int>> decoded;
+    test_input_stream istream{std::span(bytes)};
+    BOOST_TEST(dp::decode(istream, decoded).error()
+               == dp::errc::item_type_mismatch);
+    BOOST_TEST_REQUIRE(!decoded.empty());
+    BOOST_TEST(*decoded[0] == 7);
+}
+
+BOOST_AUTO_TEST_CASE(decode_rejects_invalid_references)
+{
+    std::vector<std::shared_ptr<int>> decoded;
+    {
+        // [28(7), 29(1)]
+        auto bytes = make_byte_array<7>(
+                {0x82, 0xd8, 0x1c, 0x07, 0xd8, 0x1d, 0x01});
+        test_input_stream istream{std::span(bytes)};
+        BOOST_TEST(dp::decode_sharing(istream, decoded).error()
+                   == dp::errc::item_value_out_of_range);
+    }
+    {
+        // 28([]) followed by 29(0) which is decoded as a different type
+        auto bytes = make_byte_array<6>({0xd8, 0x1c, 0x80, 0xd8, 0x1d, 0x00});
+        test_input_stream istream{std::span(bytes)};
+        dp::sharing_table table;
+        dp::stateful_stream<test_input_stream, dp::sharing_table>
+                sharingStream(istream, table);
+
+        std::shared_ptr<std::vector<int>> first;
+        DPLX_REQUIRE_RESULT(dp::decode(sharingStream, first));
+        std::shared_ptr<int> second;
+        BOOST_TEST(dp::decode(sharingStream, second).error()
+                   == dp::errc::item_type_mismatch);
+    }
+}
+
+struct shared_with_raw_item
+{
+    std::shared_ptr<int> first;
+    dp::raw_item raw;
+    std::shared_ptr<int> last;
+
+    static constexpr dp::tuple_def<
+            dp::tuple_member_def<&shared_with_raw_item::first>{},
+            dp::tuple_member_def<&shared_with_raw_item::raw>{},
+            dp::tuple_member_def<&shared_with_raw_item::last>{}>
+            layout_descriptor{};
+};
+
+BOOST_AUTO_TEST_CASE(raw_items_dont_shift_the_shared_indices)
+{
+    {
+        // [28(7), 5, 29(0)]
+        auto bytes = make_byte_array<8>(
+                {0x83, 0xd8, 0x1c, 0x07, 0x05, 0xd8, 0x1d, 0x00});
+        test_input_stream istream{std::span(bytes)};
+        shared_with_raw_item decoded{};
+        DPLX_REQUIRE_RESULT(dp::decode_sharing(istream, decoded));
+        BOOST_TEST((decoded.first == decoded.last));
+        BOOST_TEST(decoded.raw.size() == 1u);
+    }
+    {
+        // [28(7), 28(9), 29(1)]; the captured 28(9) can't be registered
+        auto bytes = make_byte_array<10>(
+                {0x83, 0xd8, 0x1c, 0x07, 0xd8, 0x1c, 0x09, 0xd8, 0x1d, 0x01});
+        test_input_stream istream{std::span(bytes)};
+        shared_with_raw_item decoded{};
+        BOOST_TEST(dp::decode_sharing(istream, decoded).error()
+                   == dp::errc::unsupported_raw_item);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(raw_items_with_shared_objects_cant_be_spliced)
+{
+    auto const object = std::make_shared<int>(7);
+    shared_with_raw_item value{object, {}, object};
+    // 28(9)
+    auto const shareable = make_byte_array<3>({0xd8, 0x1c, 0x09});
+    value.raw.storage().assign(shareable.begin(), shareable.end());
+
+    test_output_stream<> encodingBuffer{};
+    BOOST_TEST(dp::encode_sharing(encodingBuffer, value).error()
+               == dp::errc::unsupported_raw_item);
+
+    // the same item can be spliced without a sharing namespace
+    test_output_stream<> plainBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(plainBuffer, value));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests
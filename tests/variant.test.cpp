@@ -0,0 +1,240 @@
+// Copyright Henrik Steffen Gaßmann 2021
+//
+// Distributed under the Boost Software License, Version 1.0.
+//         (See accompanying file LICENSE or copy at
+//           https://www.boost.org/LICENSE_1_0.txt)
+
+#include <dplx/dp/variant.hpp>
+
+#include <cstdint>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <dplx/dp/decoder/api.hpp>
+#include <dplx/dp/decoder/core.hpp>
+#include <dplx/dp/decoder/std_container.hpp>
+#include <dplx/dp/decoder/std_string.hpp>
+#include <dplx/dp/decoder/stringref.hpp>
+#include <dplx/dp/decoder/value_sharing.hpp>
+#include <dplx/dp/decoder/variant.hpp>
+#include <dplx/dp/encoder/api.hpp>
+#include <dplx/dp/encoder/core.hpp>
+#include <dplx/dp/encoder/stringref.hpp>
+#include <dplx/dp/encoder/value_sharing.hpp>
+#include <dplx/dp/encoder/variant.hpp>
+
+#include "boost-test.hpp"
+#include "test_input_stream.hpp"
+#include "test_output_stream.hpp"
+#include "test_utils.hpp"
+
+namespace dp_tests
+{
+
+using indexed_variant = std::variant<std::uint32_t, std::uint64_t>;
+
+} // namespace dp_tests
+
+template <>
+inline constexpr dplx::dp::variant_encoding
+        dplx::dp::variant_encoding_for<dp_tests::indexed_variant>
+        = dplx::dp::variant_encoding::indexed;
+
+namespace dp_tests
+{
+
+BOOST_AUTO_TEST_SUITE(variant)
+
+using dispatched_variant = std::variant<std::uint32_t, std::u8string, bool>;
+using tagged_variant = std::variant<dp::tagged<40u, std::uint32_t>,
+                                    dp::tagged<41u, std::uint32_t>,
+                                    dp::tagged<1000u, std::uint32_t>>;
+
+static_assert(dp::encodable<std::optional<int>, test_output_stream<>>);
+static_assert(dp::decodable<std::optional<int>, test_input_stream>);
+static_assert(dp::encodable<dispatched_variant, test_output_stream<>>);
+static_assert(dp::decodable<dispatched_variant, test_input_stream>);
+
+static_assert(dp::detail::variant_dispatch_is_unambiguous<std::uint32_t,
+                                                          std::u8string,
+                                                          bool>());
+static_assert(!dp::detail::variant_dispatch_is_unambiguous<std::uint32_t,
+                                                           std::int64_t>());
+static_assert(!dp::detail::variant_dispatch_is_unambiguous<
+              dp::tagged<40u, int>,
+              dp::tagged<40u, bool>>());
+
+BOOST_AUTO_TEST_CASE(optional_roundtrip)
+{
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, std::optional<int>{}));
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, std::optional<int>{5}));
+
+    auto const expected = make_byte_array<2>({0xf6, 0x05});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(std::optional<int>{}) == 1u);
+
+    test_input_stream istream{std::span(expected)};
+    std::optional<int> decoded{3};
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST(!decoded.has_value());
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST_REQUIRE(decoded.has_value());
+    BOOST_TEST(*decoded == 5);
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_on_initial_byte)
+{
+    dispatched_variant const values[] = {std::uint32_t{24}, u8"ab", true};
+
+    test_output_stream<> encodingBuffer{};
+    for (auto const &value : values)
+    {
+        DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+    }
+
+    auto const expected
+            = make_byte_array<6, int>({0x18, 24, 0x62, 'a', 'b', 0xf5});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(values[1]) == 3u);
+
+    test_input_stream istream{std::span(expected)};
+    for (auto const &value : values)
+    {
+        dispatched_variant decoded;
+        DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+        BOOST_TEST((decoded == value));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_on_tag_number)
+{
+    tagged_variant const values[] = {
+            dp::tagged<41u, std::uint32_t>{3u},
+            dp::tagged<1000u, std::uint32_t>{4u},
+            dp::tagged<40u, std::uint32_t>{5u},
+    };
+
+    test_output_stream<> encodingBuffer{};
+    for (auto const &value : values)
+    {
+        DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+    }
+
+    auto const expected = make_byte_array<10>(
+            {0xd8, 0x29, 0x03, 0xd9, 0x03, 0xe8, 0x04, 0xd8, 0x28, 0x05});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(values[1]) == 4u);
+
+    test_input_stream istream{std::span(expected)};
+    for (auto const &value : values)
+    {
+        tagged_variant decoded;
+        DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+        BOOST_TEST((decoded == value));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_on_referenced_strings)
+{
+    std::vector<dispatched_variant> const value{
+            u8"hello", std::uint32_t{5}, u8"hello"};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_stringref(encodingBuffer, value));
+
+    // 256([ "hello", 5, 25(0) ])
+    auto const expected = make_byte_array<14, int>(
+            {0xd9, 0x01, 0x00, 0x83, 0x65, 'h', 'e', 'l', 'l', 'o', 0x05,
+             0xd8, 0x19, 0x00});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    std::vector<dispatched_variant> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_stringref(istream, decoded));
+    BOOST_TEST((decoded == value));
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_on_shared_objects)
+{
+    using shared_variant
+            = std::variant<std::shared_ptr<std::u8string>, std::uint32_t>;
+
+    auto const object = std::make_shared<std::u8string>(u8"hi");
+    std::vector<shared_variant> const value{object, std::uint32_t{7},
+                                            object};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode_sharing(encodingBuffer, value));
+
+    // [ 28("hi"), 7, 29(0) ]
+    auto const expected = make_byte_array<10, int>(
+            {0x83, 0xd8, 0x1c, 0x62, 'h', 'i', 0x07, 0xd8, 0x1d, 0x00});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+
+    test_input_stream istream{std::span(encodingBuffer)};
+    std::vector<shared_variant> decoded;
+    DPLX_REQUIRE_RESULT(dp::decode_sharing(istream, decoded));
+    BOOST_TEST_REQUIRE(decoded.size() == 3u);
+    BOOST_TEST_REQUIRE(decoded[0].index() == 0u);
+    BOOST_TEST_REQUIRE(decoded[2].index() == 0u);
+    BOOST_TEST((*std::get<0>(decoded[0]) == u8"hi"));
+    BOOST_TEST(std::get<0>(decoded[0]) == std::get<0>(decoded[2]));
+    BOOST_TEST(std::get<1>(decoded[1]) == 7u);
+}
+
+BOOST_AUTO_TEST_CASE(indexed_roundtrip)
+{
+    indexed_variant const value{std::in_place_index<1>, 7u};
+
+    test_output_stream<> encodingBuffer{};
+    DPLX_REQUIRE_RESULT(dp::encode(encodingBuffer, value));
+
+    auto const expected = make_byte_array<3>({0x82, 0x01, 0x07});
+    BOOST_TEST(std::span(encodingBuffer) == expected,
+               boost::test_tools::per_element{});
+    BOOST_TEST(dp::encoded_size_of(value) == 3u);
+
+    test_input_stream istream{std::span(expected)};
+    indexed_variant decoded;
+    DPLX_REQUIRE_RESULT(dp::decode(istream, decoded));
+    BOOST_TEST(decoded.index() == 1u);
+    BOOST_TEST(std::get<1>(decoded) == 7u);
+}
+
+BOOST_AUTO_TEST_CASE(reject_unknown_items)
+{
+    auto const textEncoded = make_byte_array<2, int>({0x61, 'a'});
+    test_input_stream textStream{std::span(textEncoded)};
+    std::variant<std::uint32_t, bool> textDecoded;
+    auto const textRx = dp::decode(textStream, textDecoded);
+    BOOST_TEST_REQUIRE(textRx.has_error());
+    BOOST_TEST(textRx.error() == dp::errc::item_type_mismatch);
+
+    auto const tagEncoded = make_byte_array<3>({0xd8, 0x2a, 0x00});
+    test_input_stream tagStream{std::span(tagEncoded)};
+    tagged_variant tagDecoded;
+    auto const tagRx = dp::decode(tagStream, tagDecoded);
+    BOOST_TEST_REQUIRE(tagRx.has_error());
+    BOOST_TEST(tagRx.error() == dp::errc::item_type_mismatch);
+
+    auto const indexEncoded = make_byte_array<3>({0x82, 0x02, 0x00});
+    test_input_stream indexStream{std::span(indexEncoded)};
+    indexed_variant indexDecoded;
+    auto const indexRx = dp::decode(indexStream, indexDecoded);
+    BOOST_TEST_REQUIRE(indexRx.has_error());
+    BOOST_TEST(indexRx.error() == dp::errc::item_value_out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace dp_tests